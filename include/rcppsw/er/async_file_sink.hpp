@@ -0,0 +1,188 @@
+/**
+ * @file async_file_sink.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_ASYNC_FILE_SINK_HPP_
+#define INCLUDE_RCPPSW_ER_ASYNC_FILE_SINK_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <sys/types.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include "rcppsw/er/buffered_sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class async_file_sink
+ * @ingroup er
+ *
+ * @brief A \ref buffered_sink that writes to a file asynchronously via
+ * io_uring, so that the reporting/server thread does not stall on the disk
+ * when a buffer fills up.
+ *
+ * Each batch handed down by \ref buffered_sink is copied into one of \ref
+ * kQUEUE_DEPTH I/O buffers and submitted; the caller only waits if all of them
+ * are still in flight. \ref flush() waits for all submitted writes to
+ * complete.
+ *
+ * io_uring is only used if rcppsw was built with \c RCPPSW_WITH_IO_URING
+ * (liburing) and the kernel lets us set up a ring. Otherwise every batch is
+ * written with a blocking write(), exactly as \ref file_sink does.
+ *
+ * Queue depth and completion latency are tracked in either case, and can be
+ * read from any thread. Latency is measured from submission to when the
+ * completion is noticed, so is an upper bound.
+ */
+class async_file_sink : public buffered_sink {
+ public:
+  /**
+   * @brief Max # of writes in flight at once.
+   */
+  static constexpr std::size_t kQUEUE_DEPTH = 8;
+
+  /**
+   * @param fname The file to write to. If it already exists, it is truncated.
+   * @param sync_on_err If \c TRUE, fsync() the file after every \ref
+   *                    er_lvl::ERR record.
+   * @param capacity Size of the buffer in bytes.
+   * @param interval_ms Max time a record sits in the buffer, in milliseconds.
+   */
+  explicit async_file_sink(const std::string& fname,
+                           bool sync_on_err = false,
+                           std::size_t capacity = kDEFAULT_CAPACITY,
+                           uint32_t interval_ms = kDEFAULT_INTERVAL_MS);
+  ~async_file_sink(void) override;
+
+  /**
+   * @brief Write out anything that is buffered, and wait for all writes to
+   * complete.
+   */
+  void flush(void) override;
+
+  bool is_open(void) const { return -1 != m_fd; }
+  const std::string& fname(void) const { return m_fname; }
+
+  /**
+   * @brief Get if writes are actually being done asynchronously.
+   */
+  bool is_async(void) const { return nullptr != m_io; }
+
+  /**
+   * @brief Get the # of writes currently in flight.
+   */
+  std::size_t queue_depth(void) const {
+    return m_depth.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the largest # of writes that have been in flight at once.
+   */
+  std::size_t max_queue_depth(void) const {
+    return m_max_depth.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the # of completed writes.
+   */
+  uint64_t n_writes(void) const {
+    return m_n_writes.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the # of writes that failed (the data is lost).
+   */
+  uint64_t n_errors(void) const {
+    return m_n_errors.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the mean write completion latency in microseconds.
+   */
+  double mean_latency_us(void) const;
+
+  /**
+   * @brief Get the max write completion latency in microseconds.
+   */
+  double max_latency_us(void) const {
+    return m_lat_max_ns.load(std::memory_order_relaxed) / 1000.0;
+  }
+
+ protected:
+  void sink_write(const char* data, std::size_t len) override;
+  void sink_sync(void) override;
+
+ private:
+  /* io_uring + I/O buffers; only exists if writes are asynchronous */
+  struct io_state;
+
+  void blocking_write(const char* data, std::size_t len);
+  void latency_record(uint64_t ns);
+
+  /**
+   * @brief Wait for all writes in flight to complete.
+   */
+  void drain(void);
+
+  /**
+   * @brief Get the index of a free I/O buffer, waiting for a write to complete
+   * if there are none.
+   */
+  std::size_t slot_acquire(void);
+
+  /**
+   * @brief Submit the (rest of the) write for an I/O buffer.
+   */
+  void slot_submit(std::size_t idx);
+
+  /**
+   * @brief Process a single write completion.
+   *
+   * @param wait If \c TRUE, wait for a completion if none are available.
+   *
+   * @return \c TRUE if a completion was processed.
+   */
+  bool reap(bool wait);
+
+  /* data members */
+  std::string m_fname;
+  int m_fd;
+  off_t m_offset{0};
+  std::unique_ptr<io_state> m_io;
+  boost::mutex m_io_mtx{};
+  std::atomic<std::size_t> m_depth{0};
+  std::atomic<std::size_t> m_max_depth{0};
+  std::atomic<uint64_t> m_n_writes{0};
+  std::atomic<uint64_t> m_n_errors{0};
+  std::atomic<uint64_t> m_lat_total_ns{0};
+  std::atomic<uint64_t> m_lat_max_ns{0};
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_ASYNC_FILE_SINK_HPP_ */
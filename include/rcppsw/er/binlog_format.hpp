@@ -0,0 +1,189 @@
+/**
+ * @file binlog_format.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_BINLOG_FORMAT_HPP_
+#define INCLUDE_RCPPSW_ER_BINLOG_FORMAT_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class binlog_format
+ * @ingroup er
+ *
+ * @brief Layout of binary ER log files, shared by \ref binlog_writer and \ref
+ * binlog_reader. All values are stored in host byte order.
+ *
+ * A file is a file header (magic, version) followed by a sequence of
+ * self-contained blocks. Each block is:
+ *
+ * - A fixed size \ref block_header, which doubles as the index for the block:
+ *   it records the range of timestamps, the set of levels, and a mask of the
+ *   modules (bit handle % 64) of the records in it, so readers can skip blocks
+ *   that cannot contain anything they are interested in without looking at
+ *   the records.
+ *
+ * - A dictionary of the modules with records in the block:
+ *   [u32 handle][u16 len][name].
+ *
+ * - A dictionary of the format descriptors of the deferred records in the
+ *   block: [u16 id][u32 line][u16 file len][u16 func len][u16 fmt len][file]
+ *   [func][fmt].
+ *
+ * - The records: [u64 timestamp][u32 handle][u8 level][u8 kind][u16 format id]
+ *   [u32 len][payload]. For \ref TEXT records the payload is the message
+ *   text; for \ref DEFERRED records it is the arguments as encoded by \ref
+ *   deferred_encoder.
+ *
+ * Since the dictionaries are repeated in every block, any block can be decoded
+ * on its own, and a file truncated by a crash loses at most its last block.
+ */
+class binlog_format {
+ public:
+  enum record_kind : uint8_t { TEXT, DEFERRED };
+
+  static constexpr uint32_t kFILE_MAGIC = 0x4C425245;  /* "ERBL" */
+  static constexpr uint32_t kBLOCK_MAGIC = 0x4B425245; /* "ERBK" */
+  static constexpr uint32_t kVERSION = 1;
+  static constexpr std::size_t kFILE_HEADER_SIZE = 8;
+  static constexpr std::size_t kBLOCK_HEADER_SIZE = 48;
+  static constexpr std::size_t kRECORD_HEADER_SIZE = 20;
+
+  /**
+   * @brief The header/index at the start of each block.
+   */
+  struct block_header {
+    uint32_t magic{kBLOCK_MAGIC};
+    uint32_t body_size{0}; /* bytes following the header */
+    uint32_t dict_size{0}; /* bytes of body taken up by the dictionaries */
+    uint32_t n_records{0};
+    uint64_t ts_min{UINT64_MAX};
+    uint64_t ts_max{0};
+    uint64_t module_mask{0};
+    uint16_t n_modules{0};
+    uint16_t n_formats{0};
+    uint8_t lvl_mask{0};
+  };
+
+  static void header_encode(const block_header& hdr, std::string* const buf) {
+    put(buf, hdr.magic);
+    put(buf, hdr.body_size);
+    put(buf, hdr.dict_size);
+    put(buf, hdr.n_records);
+    put(buf, hdr.ts_min);
+    put(buf, hdr.ts_max);
+    put(buf, hdr.module_mask);
+    put(buf, hdr.n_modules);
+    put(buf, hdr.n_formats);
+    put(buf, hdr.lvl_mask);
+    buf->append(3, '\0');
+  }
+
+  /**
+   * @brief Encode a block header into \ref kBLOCK_HEADER_SIZE bytes at \a
+   * buf, without allocating (for use in signal handlers).
+   */
+  static void header_encode(const block_header& hdr, char* buf) {
+    buf = put(buf, hdr.magic);
+    buf = put(buf, hdr.body_size);
+    buf = put(buf, hdr.dict_size);
+    buf = put(buf, hdr.n_records);
+    buf = put(buf, hdr.ts_min);
+    buf = put(buf, hdr.ts_max);
+    buf = put(buf, hdr.module_mask);
+    buf = put(buf, hdr.n_modules);
+    buf = put(buf, hdr.n_formats);
+    buf = put(buf, hdr.lvl_mask);
+    std::memset(buf, 0, 3);
+  }
+
+  /**
+   * @brief Decode a block header from \ref kBLOCK_HEADER_SIZE bytes.
+   *
+   * @return \c FALSE if the bytes are not a block header.
+   */
+  static bool header_decode(const char* p, block_header* const hdr) {
+    const char* end = p + kBLOCK_HEADER_SIZE;
+    return get(&p, end, &hdr->magic) && kBLOCK_MAGIC == hdr->magic &&
+           get(&p, end, &hdr->body_size) && get(&p, end, &hdr->dict_size) &&
+           get(&p, end, &hdr->n_records) && get(&p, end, &hdr->ts_min) &&
+           get(&p, end, &hdr->ts_max) && get(&p, end, &hdr->module_mask) &&
+           get(&p, end, &hdr->n_modules) && get(&p, end, &hdr->n_formats) &&
+           get(&p, end, &hdr->lvl_mask) && hdr->dict_size <= hdr->body_size;
+  }
+
+  static uint64_t module_bit(uint32_t handle) {
+    return UINT64_C(1) << (handle % 64);
+  }
+  static uint8_t lvl_bit(int lvl) { return static_cast<uint8_t>(1 << lvl); }
+
+  template <typename T>
+  static void put(std::string* const buf, T val) {
+    buf->append(reinterpret_cast<const char*>(&val), sizeof(T));
+  }
+
+  /**
+   * @brief Store a value at \a p, returning the position just past it.
+   */
+  template <typename T>
+  static char* put(char* const p, T val) {
+    std::memcpy(p, &val, sizeof(T));
+    return p + sizeof(T);
+  }
+
+  template <typename T>
+  static bool get(const char** const p, const char* end, T* const val) {
+    if (*p + sizeof(T) > end) {
+      return false;
+    }
+    std::memcpy(val, *p, sizeof(T));
+    *p += sizeof(T);
+    return true;
+  }
+
+  static bool get(const char** const p,
+                  const char* end,
+                  std::size_t len,
+                  std::string* const val) {
+    if (*p + len > end) {
+      return false;
+    }
+    val->assign(*p, len);
+    *p += len;
+    return true;
+  }
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_BINLOG_FORMAT_HPP_ */
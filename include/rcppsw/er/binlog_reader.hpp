@@ -0,0 +1,122 @@
+/**
+ * @file binlog_reader.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_BINLOG_READER_HPP_
+#define INCLUDE_RCPPSW_ER_BINLOG_READER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "rcppsw/er/binlog_format.hpp"
+#include "rcppsw/er/er_lvl.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class binlog_reader
+ * @ingroup er
+ *
+ * @brief Reads the records from a file written by \ref binlog_writer, turning
+ * them back into the same text that would have been logged.
+ *
+ * Only records matching the filter given at construction are returned, and
+ * blocks whose index shows that they cannot contain any matching records are
+ * skipped over without being read.
+ */
+class binlog_reader {
+ public:
+  /**
+   * @brief Which records to return. The defaults match everything.
+   */
+  struct filter {
+    uint64_t ts_min{0};
+    uint64_t ts_max{UINT64_MAX};
+    er_lvl::value lvl{er_lvl::VER}; /* least severe level returned */
+    std::string module{};           /* empty for all modules */
+  };
+
+  /**
+   * @brief A decoded record.
+   */
+  struct record {
+    uint64_t ts{0};
+    er_lvl::value lvl{er_lvl::OFF};
+    std::string module{};
+    std::string text{};
+  };
+
+  explicit binlog_reader(const std::string& fname);
+  binlog_reader(const std::string& fname, const filter& f);
+
+  /**
+   * @brief Get if the file could be opened and has a valid header.
+   */
+  bool is_valid(void) const { return m_valid; }
+
+  /**
+   * @brief Get the next record matching the filter.
+   *
+   * @return \c FALSE if there are no more (or the rest of the file is
+   * truncated/corrupt).
+   */
+  bool next(record* rec);
+
+  uint64_t n_blocks_read(void) const { return m_n_read; }
+  uint64_t n_blocks_skipped(void) const { return m_n_skipped; }
+
+ private:
+  struct fmt_entry {
+    int line;
+    std::string file;
+    std::string func;
+    std::string fmt;
+  };
+
+  bool block_load(void);
+  bool block_match(const binlog_format::block_header& hdr) const;
+  bool dict_decode(const std::string& dict,
+                   const binlog_format::block_header& hdr);
+  void block_skip(std::size_t n);
+
+  /* data members */
+  std::ifstream m_in;
+  filter m_filter;
+  bool m_valid{false};
+  uint64_t m_n_read{0};
+  uint64_t m_n_skipped{0};
+  std::string m_body{};
+  std::size_t m_pos{0};
+  std::unordered_map<uint32_t, std::string> m_mods{};
+  std::vector<fmt_entry> m_fmts{};
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_BINLOG_READER_HPP_ */
@@ -0,0 +1,130 @@
+/**
+ * @file binlog_writer.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_BINLOG_WRITER_HPP_
+#define INCLUDE_RCPPSW_ER_BINLOG_WRITER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "rcppsw/er/binlog_format.hpp"
+#include "rcppsw/er/server.hpp"
+#include "rcppsw/er/sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class binlog_writer
+ * @ingroup er
+ *
+ * @brief Writes logged messages to a \ref sink in the binary format described
+ * in \ref binlog_format, so that the server does not have to format them, and
+ * they can be decoded/filtered offline with the \c er-decode tool.
+ *
+ * Records are collected into a block, which is written out when it reaches
+ * the block size, when the oldest record in it is older than the flush
+ * interval, on \ref flush(), and whenever an \ref er_lvl::ERR record is added.
+ */
+class binlog_writer {
+ public:
+  /**
+   * @brief Default size of the records section of a block, in bytes.
+   */
+  static constexpr std::size_t kDEFAULT_BLOCK_SIZE = 64 * 1024;
+
+  /**
+   * @brief Default max time a record sits in a block, in milliseconds.
+   */
+  static constexpr uint32_t kDEFAULT_INTERVAL_MS = 100;
+
+  /**
+   * @param out Where to write the file. Should be freshly opened.
+   * @param block_size Size of the records section of a block, in bytes.
+   * @param interval_ms Max time a record sits in a block before being written
+   *                    out. 0 disables time-based flushing.
+   */
+  explicit binlog_writer(std::unique_ptr<sink> out,
+                         std::size_t block_size = kDEFAULT_BLOCK_SIZE,
+                         uint32_t interval_ms = kDEFAULT_INTERVAL_MS);
+  ~binlog_writer(void);
+
+  binlog_writer(const binlog_writer&) = delete;
+  binlog_writer& operator=(const binlog_writer&) = delete;
+
+  /**
+   * @brief Add a message to the log.
+   *
+   * @param ts The timestamp of the message, in nanoseconds.
+   * @param handle The handle of the module the message is from.
+   * @param mod_name The name of the module the message is from.
+   * @param msg The message.
+   */
+  void record(uint64_t ts,
+              mod_handle handle,
+              const std::string& mod_name,
+              const server::msg_int& msg);
+
+  /**
+   * @brief Write out the current block, and flush the sink.
+   */
+  void flush(void);
+
+  /**
+   * @brief Write out the current block if it has been around for longer than
+   * the flush interval.
+   */
+  void poll(void);
+
+ private:
+  typedef std::chrono::steady_clock clock_type;
+
+  void block_flush(void);
+  uint16_t fmt_id(const fmt_descriptor* desc);
+  void dict_encode(std::string* buf) const;
+
+  /* data members */
+  std::unique_ptr<sink> m_out;
+  const std::size_t mc_block_size;
+  const std::chrono::milliseconds mc_interval;
+  binlog_format::block_header m_hdr{};
+  std::string m_records{};
+  std::unordered_map<mod_handle, std::string> m_mods{};
+  std::unordered_map<const fmt_descriptor*, uint16_t> m_fmt_ids{};
+  std::vector<const fmt_descriptor*> m_fmts{};
+  clock_type::time_point m_oldest{};
+  boost::mutex m_mtx{};
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_BINLOG_WRITER_HPP_ */
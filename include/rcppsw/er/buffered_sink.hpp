@@ -0,0 +1,124 @@
+/**
+ * @file buffered_sink.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_BUFFERED_SINK_HPP_
+#define INCLUDE_RCPPSW_ER_BUFFERED_SINK_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "rcppsw/er/sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class buffered_sink
+ * @ingroup er
+ *
+ * @brief A \ref sink that collects records in a large buffer and hands them to
+ * the underlying device in batches, rather than once per record.
+ *
+ * The buffer is written out when:
+ *
+ * - The next record would not fit in it.
+ * - The oldest record in it is older than the flush interval.
+ * - \ref flush() is called.
+ * - An \ref er_lvl::ERR record is written, so that errors are not lost if the
+ *   program is about to die. If requested, the device is also synced to stable
+ *   storage in this case (and only this case).
+ *
+ * Derived classes provide the device via \ref sink_write() and \ref
+ * sink_sync(), and must call \ref flush() in their destructors.
+ */
+class buffered_sink : public sink {
+ public:
+  /**
+   * @brief Default buffer size in bytes.
+   */
+  static constexpr std::size_t kDEFAULT_CAPACITY = 64 * 1024;
+
+  /**
+   * @brief Default max time records sit in the buffer, in milliseconds.
+   */
+  static constexpr uint32_t kDEFAULT_INTERVAL_MS = 100;
+
+  /**
+   * @param capacity Size of the buffer in bytes.
+   * @param interval_ms Max time a record sits in the buffer before being
+   *                    written out. 0 disables time-based flushing.
+   * @param sync_on_err If \c TRUE, sync the device after writing out an
+   *                    \ref er_lvl::ERR record.
+   */
+  buffered_sink(std::size_t capacity,
+                uint32_t interval_ms,
+                bool sync_on_err);
+
+  void write(const char* data, std::size_t len, er_lvl::value lvl) override;
+  void flush(void) override;
+  void poll(void) override;
+
+  /**
+   * @brief Get the # of bytes currently buffered.
+   */
+  std::size_t buffered(void) const { return m_buf.size(); }
+
+  std::size_t capacity(void) const { return m_capacity; }
+
+ protected:
+  /**
+   * @brief Write a batch of records to the underlying device.
+   */
+  virtual void sink_write(const char* data, std::size_t len) = 0;
+
+  /**
+   * @brief Sync the underlying device to stable storage, if that means
+   * anything for it.
+   */
+  virtual void sink_sync(void) {}
+
+ private:
+  typedef std::chrono::steady_clock clock_type;
+
+  void flush_locked(void);
+  bool expired(void) const;
+
+  /* data members */
+  const std::size_t m_capacity;
+  const std::chrono::milliseconds m_interval;
+  const bool m_sync_on_err;
+  std::vector<char> m_buf{};
+  clock_type::time_point m_oldest{};
+  boost::mutex m_mtx{};
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_BUFFERED_SINK_HPP_ */
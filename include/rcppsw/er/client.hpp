@@ -26,14 +26,33 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <atomic>
 #include <cassert>
 #include <string>
 #include <boost/uuid/uuid.hpp>
+#include "rcppsw/er/deferred_encoder.hpp"
+#include "rcppsw/er/flight_recorder.hpp"
+#include "rcppsw/er/fmt_descriptor.hpp"
+#include "rcppsw/er/server.hpp"
 #include "rcppsw/er/server_mod.hpp"
 
 /*******************************************************************************
  * Macros
  ******************************************************************************/
+/**
+ * @def RCPPSW_ER_MIN_LVL
+ *
+ * The least severe level of reporting statement that is compiled in, as the
+ * numeric value of the corresponding \ref er_lvl::value (OFF=0, ERR=1, WARN=2,
+ * NOM=3, DIAG=4, VER=5). Statements less severe than this are removed by the
+ * preprocessor, and cost nothing at all. Can be defined per translation unit
+ * (before including this file), or per submodule from cmake via
+ * RCPPSW_ER_MIN_LVL_<submodule>. Defaults to compiling everything in.
+ */
+#ifndef RCPPSW_ER_MIN_LVL
+#define RCPPSW_ER_MIN_LVL 5
+#endif
+
 #ifndef RCPPSW_ER_NO_REPORT
 /* ---------- Explicit debug level statements (use these) ---------- */
 
@@ -43,7 +62,11 @@
  * Define a statement reporting the occurence of an \ref er_lvl::ERR
  * event. Works just like printf() from a syntax point of view.
  */
-#define ER_ERR(...) ER_REPORT(rcppsw::er::er_lvl::ERROR, __VA_ARGS__)
+#if RCPPSW_ER_MIN_LVL >= 1
+#define ER_ERR(...) ER_REPORT(rcppsw::er::er_lvl::ERR, __VA_ARGS__)
+#else
+#define ER_ERR(...)
+#endif
 
 /**
  * @def ER_WARN(...)
@@ -51,7 +74,11 @@
  * Define a statement reporting the occurence of an \ref er_lvl::WARN
  * event. Works just like printf() from a syntax point of view.
  */
+#if RCPPSW_ER_MIN_LVL >= 2
 #define ER_WARN(...) ER_REPORT(rcppsw::er::er_lvl::WARN, __VA_ARGS__)
+#else
+#define ER_WARN(...)
+#endif
 
 /**
  * @def ER_NOM(...)
@@ -59,7 +86,11 @@
  * Define a statement reporting the occurence of an \ref er_lvl::NOM
  * event. Works just like printf() from a syntax point of view.
  */
+#if RCPPSW_ER_MIN_LVL >= 3
 #define ER_NOM(...) ER_REPORT(rcppsw::er::er_lvl::NOM, __VA_ARGS__)
+#else
+#define ER_NOM(...)
+#endif
 
 /**
  * @def ER_DIAG(...)
@@ -67,7 +98,11 @@
  * Define a statement reporting the occurence of an \ref er_lvl::DIAG
  * event. Works just like printf() from a syntax point of view.
  */
+#if RCPPSW_ER_MIN_LVL >= 4
 #define ER_DIAG(...) ER_REPORT(rcppsw::er::er_lvl::DIAG, __VA_ARGS__)
+#else
+#define ER_DIAG(...)
+#endif
 
 /**
  * @def ER_VER(...)
@@ -75,37 +110,109 @@
  * Define a statement reporting the occurence of an \ref er_lvl::VER
  * event. Works just like printf() from a syntax point of view.
  */
+#if RCPPSW_ER_MIN_LVL >= 5
 #define ER_VER(...) ER_REPORT(rcppsw::er::er_lvl::VER, __VA_ARGS__)
+#else
+#define ER_VER(...)
+#endif
 
 /*
  * -------- Debug statements with level parameter (Don't use these) --------
  */
 
+/**
+ * @def ER_GATE(lvl)
+ *
+ * Evaluates to \c TRUE if a statement at level \a lvl should do any work at
+ * all. The compile time check folds away for constant levels, and the run time
+ * check is a couple of relaxed atomic loads via \ref client::er_enabled(), plus
+ * bumping a thread local counter in the server's \ref er_metrics if the
+ * message is rejected.
+ */
+#define ER_GATE(lvl)              \
+  ((lvl) <= RCPPSW_ER_MIN_LVL &&  \
+   rcppsw::er::client::er_enabled(lvl))
+
+/**
+ * @def ER_RECORD(lvl, msg, ...)
+ *
+ * Keep a message that did not pass \ref ER_GATE() in the server's \ref
+ * flight_recorder, if it has one. The message is recorded in deferred form (a
+ * static \ref fmt_descriptor + the encoded arguments), so it is never
+ * formatted unless the recorder is dumped.
+ */
+#define ER_RECORD(lvl, msg, ...)                                         \
+  if (rcppsw::er::client::er_recording()) {                              \
+    static const rcppsw::er::fmt_descriptor _rdesc = {                   \
+        __FILE__,                                                        \
+        __LINE__,                                                        \
+        reinterpret_cast<const char*>(__FUNCTION__),                     \
+        msg};                                                            \
+    std::size_t _len;                                                    \
+    const char* _args =                                                  \
+        rcppsw::er::deferred_encoder::encode_tls(&_len, ##__VA_ARGS__);  \
+    rcppsw::er::client::er_record(lvl, &_rdesc, _args, _len);            \
+  }
+
+#ifndef RCPPSW_ER_DEFERRED_FMT
 /**
  * @def ER_REPORT(lvl, msg, ...)
  *
  * Define a statement reporting the occurrence of an event with the specified
  * level. \a msg is the format string, and \a ... is the variadic argument list
- * (just like printf()).
+ * (just like printf()). Messages that do not pass the level gate still go to
+ * the server's \ref flight_recorder, if it has one (see \ref ER_RECORD()).
+ */
+#define ER_REPORT(lvl, msg, ...)                                  \
+  {                                                               \
+    if (ER_GATE(lvl)) {                                           \
+      char _str[1000];                                            \
+      snprintf(static_cast<char*>(_str),                          \
+               sizeof(_str),                                      \
+               "%s:%d:%s: " msg "\n",                             \
+               __FILE__,                                          \
+               __LINE__,                                          \
+               reinterpret_cast<const char*>(__FUNCTION__),       \
+               ##__VA_ARGS__);                                    \
+      rcppsw::er::client::er_report(                              \
+          lvl, std::string(reinterpret_cast<char*>(_str)));       \
+    } else {                                                      \
+      ER_RECORD(lvl, msg, ##__VA_ARGS__);                         \
+    }                                                             \
+  }
+
+#else
+/**
+ * @def ER_REPORT(lvl, msg, ...)
+ *
+ * Deferred formatting version of the reporting statement (enabled by defining
+ * \c RCPPSW_ER_DEFERRED_FMT). The call site only records a pointer to a static
+ * \ref fmt_descriptor and the raw bytes of the arguments, encoded into a
+ * per-thread buffer; they are copied once, when the message is handed to the
+ * server. Formatting is done by the server, and only if the message will
+ * actually be printed/logged.
  */
-#define ER_REPORT(lvl, msg, ...)                       \
-  {                                                    \
-    char _str[1000];                                   \
-    snprintf(static_cast<char*>(_str),                 \
-             sizeof(_str),                             \
-             "%s:%d:%s: " msg "\n",                    \
-             __FILE__,                                 \
-             __LINE__,                                 \
-             reinterpret_cast<const char*>(__FUNCTION__),       \
-             ##__VA_ARGS__);                           \
-    __er_report__(rcppsw::er::client::server_handle(), \
-                  rcppsw::er::client::er_id(),         \
-                  lvl,                                 \
-                  std::string(reinterpret_cast<char*>(_str)));  \
+#define ER_REPORT(lvl, msg, ...)                                      \
+  {                                                                   \
+    if (ER_GATE(lvl)) {                                               \
+      static const rcppsw::er::fmt_descriptor _desc = {               \
+          __FILE__,                                                   \
+          __LINE__,                                                   \
+          reinterpret_cast<const char*>(__FUNCTION__),                \
+          msg};                                                       \
+      std::size_t _len;                                               \
+      const char* _args =                                             \
+          rcppsw::er::deferred_encoder::encode_tls(&_len, ##__VA_ARGS__); \
+      rcppsw::er::client::er_report(lvl, &_desc, _args, _len);        \
+    } else {                                                          \
+      ER_RECORD(lvl, msg, ##__VA_ARGS__);                             \
+    }                                                                 \
   }
+#endif /* RCPPSW_ER_DEFERRED_FMT */
 
 #else
 #define ER_REPORT(lvl, msg, ...)
+#define ER_RECORD(lvl, msg, ...)
 #define ER_ERR(...)
 #define ER_WARN(...)
 #define ER_NOM(...)
@@ -152,7 +259,8 @@
  *
  * Check a boolean condition \a cond in a function, halting the program if the
  * condition is not true. Like assert(), but allows for an additional custom to
- * be reported to the \ref server.
+ * be reported to the \ref server. The installed \ref flight_recorder (if any)
+ * is dumped first.
  *
  * You cannot use this macro in non-class contexts, and all classes using it
  * must derive from \ref client.
@@ -160,6 +268,7 @@
 #define ER_ASSERT(cond, msg, ...)                           \
   if (!(cond)) {                                            \
     ER_REPORT(rcppsw::er::er_lvl::ERR, msg, ##__VA_ARGS__); \
+    rcppsw::er::flight_recorder::crash_dump();              \
     assert(cond);                                           \
   }
 
@@ -168,7 +277,8 @@
  *
  * Mark a place in the code as being universally bad, like really really
  * bad. Fatally bad. If execution ever reaches this spot stop the program after
- * reporting the specified message.
+ * reporting the specified message and dumping the installed \ref
+ * flight_recorder (if any).
  *
  * You cannot use this macro in non-class contexts, and all classes using it
  * must derive from \ref client.
@@ -176,6 +286,7 @@
 #define ER_FATAL_SENTINEL(msg, ...)                             \
   {                                                             \
     ER_REPORT(rcppsw::er::er_lvl::ERR, msg, ##__VA_ARGS__);     \
+    rcppsw::er::flight_recorder::crash_dump();                  \
     assert(false);                                                  \
   }
 
@@ -200,6 +311,13 @@ class global_server;
  * In addition to deriving from this class, the automatically defined module for
  * the derived class must also be installed via \ref attmod() or \ref
  * server::insmod in order to enable reporting for messages from the class.
+ *
+ * Each client caches the handle and level gate of its module (see \ref
+ * server_mod::gate()) along with the server's flight recorder, and re-fetches
+ * them only when modules have been installed/removed in the server since it
+ * last looked. The cache is updated
+ * by whichever thread is reporting, so a single client object should not
+ * report from multiple threads at once while modules are being changed.
  */
 class client {
  public:
@@ -258,6 +376,43 @@ class client {
    */
   server* server_handle(void) const { return m_server_handle.get(); }
 
+  /**
+   * @brief Determine if a message at the specified level from this client
+   * would be printed or logged by the server, so that no work is done
+   * formatting/sending messages that will just be dropped.
+   *
+   * If the module's messages are rate limited/sampled (see \ref
+   * server::mod_limits()), that is checked here too, so suppressed messages
+   * are never formatted. Messages rejected here are counted as filtered in the
+   * server's \ref er_metrics.
+   *
+   * @param lvl The level of the message.
+   *
+   * @return \c TRUE iff the message would be printed or logged.
+   */
+  bool er_enabled(const er_lvl::value& lvl) const {
+    if (nullptr == m_server_handle) {
+      return false;
+    }
+    if (m_gate_gen != m_server_handle->generation()) {
+      gate_refresh();
+    }
+    if (nullptr != m_gate &&
+        static_cast<int>(lvl) <= m_gate->load(std::memory_order_relaxed) &&
+        (nullptr == m_limiter || limit_admit(lvl))) {
+      return true;
+    }
+    m_server_handle->metrics().filtered(m_handle, lvl);
+    return false;
+  }
+
+  /**
+   * @brief Determine if messages from this client that are rejected by \ref
+   * er_enabled() should still be kept in the server's \ref flight_recorder.
+   * Uses the state cached by the last call to \ref er_enabled().
+   */
+  bool er_recording(void) const { return nullptr != m_recorder; }
+
  protected:
   const std::shared_ptr<server>& server_ref(void) const {
     return m_server_handle;
@@ -271,9 +426,56 @@ class client {
    */
   boost::uuids::uuid er_id(void) const { return m_er_id; }
 
+  /**
+   * @brief Send an already formatted message to the server. Should not be
+   * called directly; use the reporting macros.
+   */
+  void er_report(const er_lvl::value& lvl, const std::string& str) const {
+    m_server_handle->report(m_er_id, lvl, str, m_handle);
+  }
+
+  /**
+   * @brief Send a message whose formatting has been deferred to the
+   * server. Should not be called directly; use the reporting macros.
+   */
+  void er_report(const er_lvl::value& lvl,
+                 const fmt_descriptor* desc,
+                 const char* args,
+                 std::size_t len) const {
+    m_server_handle->report_deferred(m_er_id, lvl, desc, args, len, m_handle);
+  }
+
+  /**
+   * @brief Keep a message that was not reported in the server's \ref
+   * flight_recorder. Should not be called directly; use the reporting macros.
+   */
+  void er_record(const er_lvl::value& lvl,
+                 const fmt_descriptor* desc,
+                 const char* args,
+                 std::size_t len) const {
+    m_recorder->record(m_handle, lvl, desc, args, len);
+  }
+
  private:
+  /**
+   * @brief Re-fetch the handle and level gate for this client's module from
+   * the server.
+   */
+  void gate_refresh(void) const;
+
+  /**
+   * @brief Check a message that passed the level gate against the module's
+   * limiter, reporting a summary of suppressed messages first if one is due.
+   */
+  bool limit_admit(const er_lvl::value& lvl) const;
+
   std::shared_ptr<server> m_server_handle;
   boost::uuids::uuid m_er_id;
+  mutable mod_handle m_handle{kINVALID_MOD_HANDLE};
+  mutable std::shared_ptr<const std::atomic<int>> m_gate{nullptr};
+  mutable std::shared_ptr<mod_limiter> m_limiter{nullptr};
+  mutable std::shared_ptr<flight_recorder> m_recorder{nullptr};
+  mutable uint64_t m_gate_gen{0};
 };
 
 /*******************************************************************************
@@ -0,0 +1,181 @@
+/**
+ * @file deferred_encoder.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_DEFERRED_ENCODER_HPP_
+#define INCLUDE_RCPPSW_ER_DEFERRED_ENCODER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class deferred_encoder
+ * @ingroup er
+ *
+ * @brief Packs the raw bytes of printf()-style arguments into a per-thread
+ * buffer so that formatting them can be deferred to the server thread (or an
+ * offline decoder).
+ *
+ * Each argument is stored as a 1 byte tag (type in the high nibble, size in
+ * bytes in the low nibble) followed by its value. Strings are copied in, since
+ * the pointer will likely be dangling by the time the message is
+ * formatted. Arguments that do not fit in the buffer are silently dropped; the
+ * formatter will print a placeholder for them.
+ */
+class deferred_encoder {
+ public:
+  enum arg_type : uint8_t { SINT, UINT, DOUBLE, STR, PTR };
+
+  /**
+   * @brief Max # of bytes of encoded arguments for a single message.
+   */
+  static constexpr std::size_t kMAX_SIZE = 512;
+
+  /**
+   * @brief Encode the arguments for a single message.
+   *
+   * @return The encoded arguments.
+   */
+  template <typename... Args>
+  static std::string encode(Args... args) {
+    char* buf = tls_buf();
+    std::size_t len = 0;
+    encode_args(buf, &len, args...);
+    return std::string(buf, len);
+  }
+
+  /**
+   * @brief Encode the arguments for a single message, leaving them in the
+   * per-thread buffer rather than copying them out (for callers that copy them
+   * somewhere else right away). Only valid until the next call on the same
+   * thread.
+   *
+   * @param len To be filled with the # of bytes of encoded arguments.
+   *
+   * @return The encoded arguments.
+   */
+  template <typename... Args>
+  static const char* encode_tls(std::size_t* const len, Args... args) {
+    char* buf = tls_buf();
+    *len = 0;
+    encode_args(buf, len, args...);
+    return buf;
+  }
+
+  static uint8_t make_tag(arg_type type, std::size_t size) {
+    return static_cast<uint8_t>((type << 4) | (size & 0xF));
+  }
+  static arg_type tag_type(uint8_t tag) {
+    return static_cast<arg_type>(tag >> 4);
+  }
+  static std::size_t tag_size(uint8_t tag) { return tag & 0xF; }
+
+ private:
+  static char* tls_buf(void) {
+    static thread_local char buf[kMAX_SIZE];
+    return static_cast<char*>(buf);
+  }
+
+  static void encode_args(char* const, std::size_t* const) {}
+
+  template <typename T, typename... Args>
+  static void encode_args(char* const buf,
+                          std::size_t* const len,
+                          T arg,
+                          Args... args) {
+    encode_one(buf, len, arg);
+    encode_args(buf, len, args...);
+  }
+
+  static void put(char* const buf,
+                  std::size_t* const len,
+                  uint8_t tag,
+                  const void* val) {
+    std::size_t size = tag_size(tag);
+    if (*len + 1 + size > kMAX_SIZE) {
+      return;
+    }
+    buf[(*len)++] = static_cast<char>(tag);
+    std::memcpy(buf + *len, val, size);
+    *len += size;
+  }
+
+  template <typename T>
+  static typename std::enable_if<std::is_integral<T>::value ||
+                                 std::is_enum<T>::value>::type
+  encode_one(char* const buf, std::size_t* const len, T arg) {
+    arg_type type = std::is_signed<T>::value ? SINT : UINT;
+    put(buf, len, make_tag(type, sizeof(T)), &arg);
+  }
+
+  template <typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value>::type
+  encode_one(char* const buf, std::size_t* const len, T arg) {
+    auto val = static_cast<double>(arg);
+    put(buf, len, make_tag(DOUBLE, sizeof(double)), &val);
+  }
+
+  template <typename T>
+  static void encode_one(char* const buf, std::size_t* const len, T* arg) {
+    const void* val = arg;
+    put(buf, len, make_tag(PTR, sizeof(void*)), &val);
+  }
+
+  /*
+   * Strings are stored as tag + 2 byte length + bytes (no NULL terminator),
+   * truncated to fit in whatever space is left.
+   */
+  static void encode_one(char* const buf,
+                         std::size_t* const len,
+                         const char* arg) {
+    if (nullptr == arg) {
+      arg = "(null)";
+    }
+    if (*len + 1 + sizeof(uint16_t) > kMAX_SIZE) {
+      return;
+    }
+    std::size_t room = kMAX_SIZE - *len - 1 - sizeof(uint16_t);
+    auto n = static_cast<uint16_t>(std::min(std::strlen(arg), room));
+    put(buf, len, make_tag(STR, sizeof(uint16_t)), &n);
+    std::memcpy(buf + *len, arg, n);
+    *len += n;
+  }
+  static void encode_one(char* const buf, std::size_t* const len, char* arg) {
+    encode_one(buf, len, static_cast<const char*>(arg));
+  }
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_DEFERRED_ENCODER_HPP_ */
@@ -0,0 +1,79 @@
+/**
+ * @file deferred_formatter.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_DEFERRED_FORMATTER_HPP_
+#define INCLUDE_RCPPSW_ER_DEFERRED_FORMATTER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string>
+#include "rcppsw/er/fmt_descriptor.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class deferred_formatter
+ * @ingroup er
+ *
+ * @brief Turns a format descriptor + arguments encoded by \ref
+ * deferred_encoder back into the text that \c snprintf() would have produced
+ * at the call site.
+ *
+ * The format string is walked one conversion at a time, and each conversion
+ * is handed to \c snprintf() along with the next stored argument, so the
+ * output matches the immediate-formatting path for all the conversions that
+ * are legal in a reporting statement. Length modifiers in the format string are
+ * ignored in favor of the type recorded with the argument.
+ */
+class deferred_formatter {
+ public:
+  /**
+   * @brief Format just the message part of a statement.
+   *
+   * @param fmt The printf()-style format string.
+   * @param args The encoded arguments.
+   *
+   * @return The formatted message.
+   */
+  static std::string format(const char* fmt, const std::string& args);
+
+  /**
+   * @brief Format a statement the same way the \c ER_REPORT() macro does in
+   * immediate mode: "file:line:func: msg\n".
+   *
+   * @param desc The descriptor for the reporting statement.
+   * @param args The encoded arguments.
+   *
+   * @return The formatted statement.
+   */
+  static std::string format(const fmt_descriptor& desc,
+                            const std::string& args);
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_DEFERRED_FORMATTER_HPP_ */
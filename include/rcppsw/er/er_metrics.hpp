@@ -0,0 +1,311 @@
+/**
+ * @file er_metrics.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_ER_METRICS_HPP_
+#define INCLUDE_RCPPSW_ER_ER_METRICS_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <boost/thread/mutex.hpp>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/er/er_lvl.hpp"
+#include "rcppsw/er/server_mod.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class er_metrics
+ * @ingroup er
+ *
+ * @brief Counters describing what the event reporting framework is doing: how
+ * many messages each module emits, has filtered out by level and loses to full
+ * queues (all broken down by level), how many bytes it writes, and how long it
+ * takes messages to get from the report call to a sink.
+ *
+ * All updates are relaxed atomic increments, so they are safe to make from any
+ * thread and never block. Counters are kept per module handle, in fixed size
+ * chunks that are allocated the first time a handle in them is used and never
+ * moved, so that reporting threads do not have to synchronize with modules
+ * being installed. Messages from modules without a valid handle are counted
+ * as unattributed.
+ *
+ * Filtered messages are counted on the reporting fast path (every message that
+ * fails \ref ER_GATE()), so they are kept per thread instead: each thread
+ * increments counters that only it writes, and they are summed with the
+ * shared counters when the metrics are queried. A thread's counters are folded
+ * into the shared ones after it exits.
+ *
+ * Latencies go into a histogram with power of 2 buckets: bucket \c i holds
+ * latencies in [2^(i-1), 2^i) nanoseconds.
+ */
+class er_metrics {
+ public:
+  /**
+   * @brief # of levels counters are kept for (indexed by \ref er_lvl::value).
+   */
+  static constexpr std::size_t kN_LEVELS = er_lvl::VER + 1;
+
+  /**
+   * @brief # of latency histogram buckets. The last bucket also holds
+   * everything longer than it would otherwise.
+   */
+  static constexpr std::size_t kN_BUCKETS = 40;
+
+  /**
+   * @brief Counters are kept for module handles in [0, kMAX_HANDLES); messages
+   * from handles beyond that are counted as unattributed.
+   */
+  static constexpr std::size_t kMAX_HANDLES = 65536;
+
+  /**
+   * @brief A snapshot of the counters for one module (or the sum over several).
+   */
+  struct counts {
+    uint64_t emitted[kN_LEVELS];
+    uint64_t filtered[kN_LEVELS];
+    uint64_t dropped[kN_LEVELS];
+    uint64_t bytes;
+
+    counts& operator+=(const counts& rhs);
+    uint64_t n_emitted(void) const;
+    uint64_t n_filtered(void) const;
+    uint64_t n_dropped(void) const;
+  };
+
+  er_metrics(void);
+  ~er_metrics(void);
+
+  er_metrics(const er_metrics& other) = delete;
+  er_metrics& operator=(const er_metrics& other) = delete;
+
+  /**
+   * @brief Enable/disable counting. Counting is enabled by default; when
+   * disabled, the update functions below return immediately and report call
+   * times are not taken.
+   */
+  void enable(bool en) { m_enabled.store(en, std::memory_order_relaxed); }
+  bool enabled(void) const { return m_enabled.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Count a message that was written to at least one sink.
+   *
+   * @param handle The handle of the module the message is from.
+   * @param lvl The level of the message.
+   * @param bytes The total # of bytes written for the message.
+   */
+  void emitted(mod_handle handle, er_lvl::value lvl, std::size_t bytes);
+
+  /**
+   * @brief Count a message that was not written anywhere because of the
+   * module's levels.
+   */
+  void filtered(mod_handle handle, er_lvl::value lvl);
+
+  /**
+   * @brief Count a message that was discarded because a queue was full.
+   */
+  void dropped(mod_handle handle, er_lvl::value lvl);
+
+  /**
+   * @brief Add a sample to the latency histogram.
+   *
+   * @param ns Time from the report call to the sink write, in nanoseconds.
+   */
+  void latency(uint64_t ns);
+
+  /**
+   * @brief Zero the counters for a handle (e.g. when it is reused by a newly
+   * installed module).
+   */
+  void mod_reset(mod_handle handle);
+
+  /**
+   * @brief Get the counters for a module.
+   */
+  counts mod_counts(mod_handle handle) const;
+
+  /**
+   * @brief Get the counters for messages that could not be attributed to an
+   * installed module.
+   */
+  counts unattributed(void) const;
+
+  /**
+   * @brief Get the sum of the counters over all modules (i.e. the per-level
+   * totals), including unattributed messages.
+   */
+  counts totals(void) const;
+
+  /**
+   * @brief Get the latency histogram.
+   */
+  std::vector<uint64_t> latency_hist(void) const;
+
+  /**
+   * @brief Get the upper bound of the histogram bucket that the \a p-th
+   * percentile (0-100) latency falls in, in nanoseconds, or 0 if there are no
+   * samples.
+   */
+  uint64_t latency_percentile(double p) const;
+
+  uint64_t latency_count(void) const;
+  uint64_t latency_max_ns(void) const;
+  double latency_mean_ns(void) const;
+
+  /**
+   * @brief Get the upper bound of latency histogram bucket \a i, in
+   * nanoseconds.
+   */
+  static uint64_t bucket_bound(std::size_t i);
+
+  /**
+   * @brief Zero everything.
+   */
+  void reset(void);
+
+  /**
+   * @brief Write one line summarizing a set of counters: the totals, followed
+   * by emitted/filtered/dropped for each level that has any.
+   *
+   * @param os The stream to write to.
+   * @param name What the counters are for (e.g. the module name).
+   * @param c The counters.
+   */
+  static void dump_counts(std::ostream& os,
+                          const std::string& name,
+                          const counts& c);
+
+  /**
+   * @brief Write the latency statistics and the non-empty histogram buckets.
+   */
+  void dump_latency(std::ostream& os) const;
+
+ private:
+  /**
+   * @brief # of module handles per chunk of counters.
+   */
+  static constexpr std::size_t kCHUNK_SIZE = 64;
+
+  /**
+   * @brief Max # of chunks.
+   */
+  static constexpr std::size_t kMAX_CHUNKS = kMAX_HANDLES / kCHUNK_SIZE;
+
+  struct mod_counters {
+    std::atomic<uint64_t> emitted[kN_LEVELS];
+    std::atomic<uint64_t> filtered[kN_LEVELS];
+    std::atomic<uint64_t> dropped[kN_LEVELS];
+    std::atomic<uint64_t> bytes;
+  };
+
+  /**
+   * @brief Get the counters for a handle, allocating its chunk if needed.
+   */
+  mod_counters* slot(mod_handle handle);
+
+  /**
+   * @brief Get the counters for a handle, or NULL if its chunk has not been
+   * allocated.
+   */
+  const mod_counters* slot_find(mod_handle handle) const;
+
+  /**
+   * @brief The filtered counters for one module handle kept by one thread.
+   */
+  struct tls_slot {
+    std::atomic<uint64_t> filtered[kN_LEVELS];
+  };
+
+  /**
+   * @brief The filtered counters kept by one thread, chunked like the shared
+   * counters. Only the owning thread writes them, so increments are a plain
+   * load and store.
+   */
+  struct tls_counters {
+    tls_counters(void);
+    ~tls_counters(void);
+
+    tls_slot* slot(mod_handle handle);
+    const tls_slot* slot_find(mod_handle handle) const;
+
+    std::atomic<tls_slot*> chunks[kMAX_CHUNKS];
+    tls_slot unattributed{};
+
+    /** Set when the owning thread exits */
+    std::atomic<bool> orphaned{false};
+
+    /** Set when the metrics they belong to are destroyed */
+    std::atomic<bool> dead{false};
+  };
+
+  /**
+   * @brief Get the calling thread's filtered counters, creating and
+   * registering them if needed.
+   */
+  tls_counters* tls_get(void);
+
+  /**
+   * @brief Add a thread's filtered counters to the shared ones, or subtract
+   * them (which is how counters are reset without racing with the thread).
+   *
+   * @param tls The thread's counters.
+   * @param sign +1 to add, -1 to subtract.
+   */
+  void tls_fold(const tls_counters& tls, int sign);
+
+  /**
+   * @brief Add a thread's filtered counters for one handle to \a c.
+   */
+  static void tls_slot_add(const tls_slot& slot, counts* c);
+
+  static std::size_t lvl_idx(er_lvl::value lvl);
+  static void counters_zero(mod_counters* c);
+  static counts counters_read(const mod_counters& c);
+
+  /* data members */
+  /** Unique across all instances ever created; keys the thread local caches */
+  const uint64_t mc_id;
+  std::atomic<bool> m_enabled{true};
+  std::atomic<mod_counters*> m_chunks[kMAX_CHUNKS];
+  mod_counters m_unattributed{};
+  std::atomic<uint64_t> m_hist[kN_BUCKETS];
+  std::atomic<uint64_t> m_lat_sum{0};
+  std::atomic<uint64_t> m_lat_max{0};
+
+  mutable boost::mutex m_tls_mtx{};
+  std::vector<std::shared_ptr<tls_counters>> m_tls{};
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_ER_METRICS_HPP_ */
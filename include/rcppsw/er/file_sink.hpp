@@ -0,0 +1,74 @@
+/**
+ * @file file_sink.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_FILE_SINK_HPP_
+#define INCLUDE_RCPPSW_ER_FILE_SINK_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string>
+#include "rcppsw/er/buffered_sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class file_sink
+ * @ingroup er
+ *
+ * @brief A \ref buffered_sink that writes to a file with plain POSIX I/O. If
+ * the file cannot be opened, everything written to the sink is discarded.
+ */
+class file_sink : public buffered_sink {
+ public:
+  /**
+   * @param fname The file to write to. If it already exists, it is truncated.
+   * @param sync_on_err If \c TRUE, fsync() the file after every \ref
+   *                    er_lvl::ERR record.
+   * @param capacity Size of the buffer in bytes.
+   * @param interval_ms Max time a record sits in the buffer, in milliseconds.
+   */
+  explicit file_sink(const std::string& fname,
+                     bool sync_on_err = false,
+                     std::size_t capacity = kDEFAULT_CAPACITY,
+                     uint32_t interval_ms = kDEFAULT_INTERVAL_MS);
+  ~file_sink(void) override;
+
+  bool is_open(void) const { return -1 != m_fd; }
+  const std::string& fname(void) const { return m_fname; }
+
+ protected:
+  void sink_write(const char* data, std::size_t len) override;
+  void sink_sync(void) override;
+
+ private:
+  std::string m_fname;
+  int m_fd;
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_FILE_SINK_HPP_ */
@@ -0,0 +1,201 @@
+/**
+ * @file flight_recorder.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_FLIGHT_RECORDER_HPP_
+#define INCLUDE_RCPPSW_ER_FLIGHT_RECORDER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/er/er_lvl.hpp"
+#include "rcppsw/er/fmt_descriptor.hpp"
+#include "rcppsw/er/server_mod.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class flight_recorder
+ * @ingroup er
+ *
+ * @brief A fixed size, in-memory ring of the most recent messages at every
+ * level, which can be dumped to disk when the program crashes.
+ *
+ * While a recorder is installed in a \ref server, clients record messages
+ * that do not pass the level gate as a format descriptor + encoded arguments,
+ * so they are never formatted; messages that do pass the gate are recorded as
+ * they are reported. Recording a message is a single atomic increment to claim
+ * a slot plus a copy into it; the oldest messages are overwritten. Each slot
+ * carries a sequence number, so a dump skips slots that were being written at
+ * the time instead of emitting garbage.
+ *
+ * \ref dump() only uses memory allocated up front and async signal safe
+ * system calls, so it can be called from a signal handler. \ref install()
+ * makes a recorder the one that is dumped on SIGSEGV/SIGABRT and by \ref
+ * crash_dump() (called by \c ER_ASSERT() and \c ER_FATAL_SENTINEL()). Dumps
+ * are in the \ref binlog_format, so \c er-decode can read them.
+ */
+class flight_recorder {
+ public:
+  /**
+   * @brief Default # of messages the ring holds.
+   */
+  static constexpr std::size_t kDEFAULT_CAPACITY = 4096;
+
+  /**
+   * @brief Max # of bytes of text/encoded arguments kept per message. Longer
+   * messages are truncated.
+   */
+  static constexpr std::size_t kPAYLOAD_SIZE = 224;
+
+  /**
+   * @brief Module names are kept for handles below this.
+   */
+  static constexpr std::size_t kMAX_MODULES = 1024;
+  static constexpr std::size_t kMOD_NAME_LEN = 64;
+
+  /**
+   * @param capacity Min # of messages the ring holds (rounded up to the next
+   *                 power of 2).
+   */
+  explicit flight_recorder(std::size_t capacity = kDEFAULT_CAPACITY);
+  ~flight_recorder(void);
+
+  flight_recorder(const flight_recorder& other) = delete;
+  flight_recorder& operator=(const flight_recorder& other) = delete;
+
+  /**
+   * @brief Record a message.
+   *
+   * @param handle The handle of the module the message is from.
+   * @param lvl The level of the message.
+   * @param fmt The descriptor of the reporting statement if \a data is encoded
+   *            arguments, or NULL if it is the message text.
+   * @param data The text/encoded arguments.
+   * @param len The # of bytes of \a data.
+   */
+  void record(mod_handle handle,
+              er_lvl::value lvl,
+              const fmt_descriptor* fmt,
+              const char* data,
+              std::size_t len);
+
+  /**
+   * @brief Remember the name of a module, so that it can be put in dumps.
+   */
+  void mod_name(mod_handle handle, const std::string& name);
+
+  /**
+   * @brief Write the contents of the ring to a file, oldest message first.
+   * Async signal safe, but must not be called from more than one thread at a
+   * time. Messages recorded while the dump is in progress may or may not be
+   * included.
+   *
+   * @param path The file to write to (truncated if it exists).
+   *
+   * @return \ref status_t.
+   */
+  status_t dump(const char* path);
+
+  /**
+   * @brief Make this recorder the one dumped on a crash, and install handlers
+   * for SIGSEGV and SIGABRT that dump it to \a path before letting the signal
+   * take its default action. The handlers run on an alternate stack for the
+   * calling thread, so a stack overflow there can still be dumped.
+   *
+   * @param path The file crash dumps are written to.
+   */
+  void install(const std::string& path);
+
+  /**
+   * @brief Stop this recorder from being dumped on a crash, and restore the
+   * default signal dispositions.
+   */
+  void uninstall(void);
+
+  /**
+   * @brief Dump the installed recorder (if any) to its crash dump file. Only
+   * the first dump after \ref install() does anything, so that an \c ER_ASSERT
+   * failure followed by the resulting SIGABRT yields a single dump.
+   */
+  static void crash_dump(void);
+
+  std::size_t capacity(void) const { return mc_mask + 1; }
+
+ private:
+  struct slot;
+
+  /**
+   * @brief # of records in each block of a dump.
+   */
+  static constexpr std::size_t kBLOCK_RECORDS = 256;
+
+  static void signal_handler(int sig);
+
+  /**
+   * @brief Get the length of the recorded name of a module (0 if unknown).
+   */
+  std::size_t name_len(mod_handle handle) const;
+
+  /**
+   * @brief Copy the next block's worth of consistent records, starting at ring
+   * position \a *pos and stopping at \a end, into the snapshot area.
+   *
+   * @return The # of records copied.
+   */
+  std::size_t snapshot(uint64_t* pos, uint64_t end);
+
+  /**
+   * @brief Write the first \a n records in the snapshot area out as a block.
+   *
+   * @param fd The file to write to.
+   * @param n The # of records.
+   * @param wall_offset Added to record timestamps to get wall clock time.
+   *
+   * @return \c FALSE if the block could not be written.
+   */
+  bool block_write(int fd, std::size_t n, int64_t wall_offset) const;
+
+  /* data members */
+  const uint64_t          mc_mask;
+  std::unique_ptr<slot[]> m_slots;
+  std::unique_ptr<slot[]> m_snap;
+  std::unique_ptr<char[]> m_names;
+  std::unique_ptr<char[]> m_scratch;
+  std::atomic<uint64_t>   m_next{0};
+  char                    m_crash_path[256]{};
+
+  static std::atomic<flight_recorder*> ms_installed;
+  static std::atomic<bool>             ms_dumped;
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_FLIGHT_RECORDER_HPP_ */
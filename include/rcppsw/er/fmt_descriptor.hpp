@@ -0,0 +1,55 @@
+/**
+ * @file fmt_descriptor.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_FMT_DESCRIPTOR_HPP_
+#define INCLUDE_RCPPSW_ER_FMT_DESCRIPTOR_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @struct fmt_descriptor
+ * @ingroup er
+ *
+ * @brief Everything about a reporting statement that is known at compile
+ * time. One of these is created statically at each call site when deferred
+ * formatting is enabled, so that only a pointer to it needs to travel with the
+ * message.
+ */
+struct fmt_descriptor {
+  const char* file;
+  int line;
+  const char* func;
+  const char* fmt;
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_FMT_DESCRIPTOR_HPP_ */
@@ -0,0 +1,135 @@
+/**
+ * @file mod_idgen.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_MOD_IDGEN_HPP_
+#define INCLUDE_RCPPSW_ER_MOD_IDGEN_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <boost/thread/mutex.hpp>
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+/**
+ * @brief The compact form of a module UUID that the \ref server indexes
+ * modules by (see \ref mod_idgen::key()).
+ */
+typedef uint64_t mod_key;
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class mod_idgen
+ * @ingroup er
+ *
+ * @brief Generates the UUIDs that identify modules in a \ref server.
+ *
+ * Generating RFC 4122 random UUIDs reads from the OS entropy source, which
+ * dominates setup time when tens of thousands of objects each install a
+ * module. Since module IDs only need to be unique within the server that
+ * issued them, the default is to hand them out sequentially instead. The
+ * available modes are:
+ *
+ * - \ref SEQUENTIAL - A counter. The cheapest, and deterministic from run to
+ *   run.
+ *
+ * - \ref HASHED - The counter mixed with a seed taken from the PID, clock,
+ *   and the generator's address. Nearly as cheap, and makes IDs from
+ *   different servers/processes distinct with high probability.
+ *
+ * - \ref RANDOM - Random UUIDs, for IDs that must be unique across processes
+ *   and machines. The random generator is only created if this mode is used.
+ *
+ * Whatever the mode, servers work with the 64 bit \ref key() of each UUID
+ * rather than the full 16 bytes. The key of a sequential ID is just the
+ * counter value, and \ref from_key() maps it back to the same UUID.
+ *
+ * Generating IDs is thread safe.
+ */
+class mod_idgen {
+ public:
+  enum mode { SEQUENTIAL, HASHED, RANDOM };
+
+  explicit mod_idgen(mode m = SEQUENTIAL);
+  ~mod_idgen(void);
+
+  mod_idgen(const mod_idgen& other) = delete;
+  mod_idgen& operator=(const mod_idgen& other) = delete;
+
+  /**
+   * @brief Generate a new UUID according to the current mode.
+   */
+  boost::uuids::uuid operator()(void);
+
+  mode get_mode(void) const { return m_mode.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Change how UUIDs are generated. UUIDs already handed out remain
+   * valid.
+   */
+  void set_mode(mode m) { m_mode.store(m, std::memory_order_relaxed); }
+
+  /**
+   * @brief Fold a UUID into its 64 bit key.
+   */
+  static mod_key key(const boost::uuids::uuid& id) {
+    uint64_t halves[2];
+    std::memcpy(halves, id.data, sizeof(halves));
+    return halves[0] ^ halves[1];
+  }
+
+  /**
+   * @brief Get the canonical UUID for a key: the one whose \ref key() is \a
+   * key, and that \ref SEQUENTIAL mode would have generated for it.
+   */
+  static boost::uuids::uuid from_key(mod_key key) {
+    boost::uuids::uuid id;
+    uint64_t halves[2] = {key, 0};
+    std::memcpy(id.data, halves, sizeof(halves));
+    return id;
+  }
+
+ private:
+  /* data members */
+  const uint64_t                                  mc_seed;
+  std::atomic<mode>                               m_mode;
+  std::atomic<uint64_t>                           m_next{1};
+  boost::mutex                                    m_random_mtx{};
+  std::unique_ptr<boost::uuids::random_generator> m_random{nullptr};
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_MOD_IDGEN_HPP_ */
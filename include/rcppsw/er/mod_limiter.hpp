@@ -0,0 +1,153 @@
+/**
+ * @file mod_limiter.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_MOD_LIMITER_HPP_
+#define INCLUDE_RCPPSW_ER_MOD_LIMITER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/er/er_lvl.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class mod_limiter
+ * @ingroup er
+ *
+ * @brief Limits how many messages a module can report, so that statements in
+ * tight loops do not swamp the log.
+ *
+ * Two limits can be applied, alone or together, to messages at or below a
+ * configurable severity:
+ *
+ * - Sampling: only 1 in every N messages is let through.
+ * - Rate limiting: a token bucket holding \c burst messages that refills at
+ *   \c rate messages per second. It is implemented as the equivalent
+ *   "theoretical arrival time" algorithm, so the whole bucket is a single
+ *   atomic and \ref admit() never locks.
+ *
+ * The limiter is shared between the module and the clients reporting through
+ * it, which consult it right after the level gate and before any formatting
+ * is done. Suppressed messages are counted, and rolled up into a periodic
+ * summary message (see \ref summary_due()).
+ */
+class mod_limiter {
+ public:
+  struct config {
+    /** Max sustained rate in messages/second; 0 disables rate limiting. */
+    double rate{0.0};
+
+    /** Max # of messages let through at once after a quiet period. */
+    uint32_t burst{1};
+
+    /** Only let 1 in this many messages through; 0 or 1 disables sampling. */
+    uint32_t sample{1};
+
+    /** Messages at this level and less severe are subject to the limits. */
+    er_lvl::value lvl{er_lvl::NOM};
+
+    /** Min time between summaries of suppressed messages. */
+    uint64_t summary_ms{1000};
+
+    /**
+     * @brief Does the configuration limit anything?
+     */
+    bool active(void) const { return rate > 0.0 || sample > 1; }
+  };
+
+  explicit mod_limiter(const config& cfg);
+
+  mod_limiter(const mod_limiter& other) = delete;
+  mod_limiter& operator=(const mod_limiter& other) = delete;
+
+  const config& cfg(void) const { return mc_cfg; }
+
+  /**
+   * @brief Decide if a message at the specified level should be let through,
+   * counting it as suppressed if not.
+   *
+   * @param lvl The level of the message.
+   *
+   * @return \c TRUE iff the message should be reported.
+   */
+  bool admit(const er_lvl::value& lvl);
+
+  /**
+   * @brief Determine if it is time to report a summary of suppressed
+   * messages. If it is, the caller that gets \c TRUE is responsible for doing
+   * it (via \ref suppressed_take() and \ref summary()).
+   *
+   * @param now The current raw \ref timestamp.
+   */
+  bool summary_due(uint64_t now);
+
+  /**
+   * @brief Get and reset the # of messages suppressed since the last time this
+   * was called.
+   */
+  uint64_t suppressed_take(void) {
+    return m_suppressed.exchange(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Add to the # of suppressed messages (e.g. those counted by a
+   * limiter that this one is replacing).
+   */
+  void suppressed_add(uint64_t n) {
+    m_suppressed.fetch_add(n, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Get the text of a summary for \a n suppressed messages.
+   */
+  static std::string summary(uint64_t n);
+
+ private:
+  void suppress(void) { m_suppressed.fetch_add(1, std::memory_order_relaxed); }
+
+  /* data members */
+  const config          mc_cfg;
+
+  /** Time between messages at the sustained rate, in ns. */
+  const uint64_t        mc_interval;
+
+  /** How far ahead of now the arrival time can get (the burst), in ns. */
+  const uint64_t        mc_tolerance;
+
+  std::atomic<uint64_t> m_tat{0};
+  std::atomic<uint64_t> m_count{0};
+  std::atomic<uint64_t> m_suppressed{0};
+  std::atomic<uint64_t> m_last_summary;
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_MOD_LIMITER_HPP_ */
@@ -24,11 +24,11 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-#include <fstream>
+#include <boost/thread/mutex.hpp>
 #include <string>
 #include <vector>
 #include "rcppsw/er/server.hpp"
-#include "rcppsw/multithread/mt_queue.hpp"
+#include "rcppsw/multithread/mpsc_ring.hpp"
 #include "rcppsw/multithread/threadable.hpp"
 
 /*******************************************************************************
@@ -44,6 +44,16 @@ NS_START(rcppsw, er);
  * @ingroup er
  *
  * @brief A multithreaded version of the \ref server for reporting events.
+ *
+ * Reporting threads only push the message onto a bounded lock-free queue; all
+ * formatting and I/O happens in the server thread, which sleeps on the queue
+ * when there is nothing to do. Messages are taken off the queue and reported
+ * under a lock, so \ref flush() from another thread reports in queue order
+ * and never writes the sinks at the same time as the server thread.
+ *
+ * What happens when the queue fills up is controlled by the \ref
+ * multithread::overflow_policy passed at construction; the # of messages lost
+ * to it is available via \ref n_dropped().
  */
 class mt_server : public server, public multithread::threadable {
  public:
@@ -54,10 +64,16 @@ class mt_server : public server, public multithread::threadable {
    *                      already exists, it is deleted.
    * @param dbglvl The initial debug printing level.
    * @param loglvl The initial logging level.
+   * @param queue_size The # of messages that can be waiting for the server
+   *                   thread before the overflow policy kicks in.
+   * @param policy What to do with new messages when the queue is full.
    */
   mt_server(const std::string& logfile_fname,
-                     const er_lvl::value& dbglvl,
-                     const er_lvl::value& loglvl);
+            const er_lvl::value& dbglvl,
+            const er_lvl::value& loglvl,
+            std::size_t queue_size = kDEFAULT_QUEUE_SIZE,
+            multithread::overflow_policy::value policy =
+                multithread::overflow_policy::BLOCK);
 
   /**
    * @brief Initialize a multithreaded ER server with default values.
@@ -67,7 +83,29 @@ class mt_server : public server, public multithread::threadable {
   ~mt_server(void) override { join(); }
 
   /**
-   * @brief Flush all remaining entries in the queue to stdout/the log file.
+   * @brief The default # of messages the queue between reporting threads and
+   * the server thread can hold.
+   */
+  static constexpr std::size_t kDEFAULT_QUEUE_SIZE = 8192;
+
+  /**
+   * @brief Signal the server thread to terminate, waking it up if it is
+   * waiting for messages. Any messages still queued are reported before it
+   * exits.
+   */
+  void term(void) override {
+    threadable::term();
+    m_queue.wake();
+  }
+
+  /**
+   * @brief Get the # of messages discarded because the queue was full.
+   */
+  uint64_t n_dropped(void) const { return m_queue.n_dropped(); }
+
+  /**
+   * @brief Flush all remaining entries in the queue to stdout/the log file,
+   * from the calling thread.
    */
   void flush(void) override;
 
@@ -81,25 +119,37 @@ class mt_server : public server, public multithread::threadable {
   void* thread_main(__unused void* arg) override;
 
   /**
-   * @brief Report a message. Messages may or not actually be printed/logged,
-   * depending on the current level settings in the server/module.
+   * @brief Hand off a message to the server thread for reporting. Messages
+   * lost to the overflow policy are counted as dropped in the \ref
+   * er_metrics.
    *
-   * @param er_id The module reporting the message.
-   * @param lvl The level of the message.
-   * @param str The message.
+   * @param msg The message.
    */
-  void report(const boost::uuids::uuid& er_id,
-              const er_lvl::value& lvl,
-              const std::string& str) override {
-    msg_int msg(er_id, lvl, str);
-    msg_report(msg);
-    m_queue.enqueue(msg);
+  void dispatch(msg_int msg) override {
+    m_queue.enqueue(std::move(msg), [this](const msg_int& dropped) {
+      metrics().dropped(dropped.handle, dropped.lvl);
+    });
   }
 
  private:
-  multithread::mt_queue<msg_int> m_queue;
+  /**
+   * @brief How long the server thread sleeps waiting for messages before
+   * re-checking if it has been told to terminate and giving the sinks a chance
+   * to do time-based flushing.
+   */
+  static constexpr std::size_t kWAIT_TIMEOUT_MS = 100;
+
+  /**
+   * @brief Report everything in the queue. Must be called with \ref
+   * m_report_mtx held.
+   */
+  void drain(void);
+
+  multithread::mpsc_ring<msg_int> m_queue;
+  /* serializes taking messages off the queue and writing them out */
+  boost::mutex m_report_mtx{};
 };
 
 NS_END(er, rcppsw);
 
-#endif /* INCLUDE_RCPPSW_ER_SERVER_HPP_ */
+#endif /* INCLUDE_RCPPSW_ER_MT_SERVER_HPP_ */
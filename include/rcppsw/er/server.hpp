@@ -24,12 +24,23 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-#include <boost/uuid/uuid_generators.hpp>
-#include <iosfwd>
+#include <atomic>
+#include <boost/uuid/uuid.hpp>
+#include <functional>
+#include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "rcppsw/common/common.hpp"
+#include "rcppsw/er/er_metrics.hpp"
+#include "rcppsw/er/flight_recorder.hpp"
+#include "rcppsw/er/fmt_descriptor.hpp"
+#include "rcppsw/er/mod_idgen.hpp"
 #include "rcppsw/er/server_mod.hpp"
+#include "rcppsw/er/sink.hpp"
+#include "rcppsw/er/sink_streambuf.hpp"
+#include "rcppsw/er/timestamp.hpp"
+#include "rcppsw/er/ts_formatter.hpp"
 #include "rcppsw/patterns/singleton.hpp"
 
 /*******************************************************************************
@@ -37,6 +48,8 @@
  ******************************************************************************/
 NS_START(rcppsw, er);
 
+class binlog_writer;
+
 /*******************************************************************************
  * Class Definitions
  ******************************************************************************/
@@ -53,6 +66,17 @@ NS_START(rcppsw, er);
  * Modules corresponding to classes derived from \ref client are run-time
  * installable/removable, and can independently have their logging (writing to a
  * file) and debugging (writing to stdout) levels set.
+ *
+ * Formatted records are written to a pair of \ref sink objects (one for the
+ * logfile, one for stdout), which batch them up rather than doing I/O for each
+ * message. By default these are a \ref file_sink and a \ref stdout_sink, but
+ * either can be replaced.
+ *
+ * Installed modules live in a flat table indexed by \ref mod_handle, which
+ * clients cache so that reporting a message does not need to search for the
+ * module. Lookup by UUID goes through a hash index on the 64 bit \ref mod_key
+ * of the UUID into the same table. Module UUIDs are handed out sequentially by
+ * default (see \ref mod_idgen).
  */
 class server {
  public:
@@ -63,15 +87,55 @@ class server {
    * @brief Internal class wrapping all the information needed to processing a
    * message besides the text of the message itself.
    *
+   * If \c fmt is non-NULL, the message has not been formatted yet, and \c str
+   * holds the arguments encoded by \ref deferred_encoder rather than text.
+   *
+   * \c handle is a hint; if it is invalid or no longer refers to the module
+   * with UUID \c id, the module is looked up by UUID.
+   *
+   * \c ts is the raw \ref timestamp of when the message was reported, and
+   * \c t_report the precise time of the report call if latency is being
+   * measured (0 otherwise).
+   *
    * @endinternal
    */
   struct msg_int {
+    msg_int(void)
+        : id(),
+          handle(kINVALID_MOD_HANDLE),
+          lvl(er_lvl::OFF),
+          ts(0),
+          t_report(0),
+          fmt(nullptr),
+          str() {}
+    msg_int(const boost::uuids::uuid& id_,
+            const er_lvl::value& lvl_,
+            std::string str_)
+        : id(id_),
+          handle(kINVALID_MOD_HANDLE),
+          lvl(lvl_),
+          ts(timestamp::now()),
+          t_report(0),
+          fmt(nullptr),
+          str(std::move(str_)) {}
     msg_int(const boost::uuids::uuid& id_,
+            mod_handle handle_,
             const er_lvl::value& lvl_,
+            const fmt_descriptor* fmt_,
             std::string str_)
-        : id(id_), lvl(lvl_), str(std::move(str_)) {}
+        : id(id_),
+          handle(handle_),
+          lvl(lvl_),
+          ts(timestamp::now()),
+          t_report(0),
+          fmt(fmt_),
+          str(std::move(str_)) {}
     boost::uuids::uuid id;
+    mod_handle handle;
     er_lvl::value lvl;
+    uint64_t ts;
+    uint64_t t_report;
+    const fmt_descriptor* fmt;
     std::string str;
   };
 
@@ -99,23 +163,96 @@ class server {
   virtual ~server(void);
 
   /**
-   * @brief Get a reference to the logging stream.
+   * @brief Get a reference to the logging stream. Output goes to the logging
+   * \ref sink, and so is buffered like everything else.
+   */
+  std::ostream& log_stream(void) { return m_log_stream; }
+
+  /**
+   * @brief Get a reference to the debugging stream. Output goes to the
+   * debugging \ref sink, and so is buffered like everything else.
+   */
+  std::ostream& dbg_stream(void) { return m_dbg_stream; }
+
+  /**
+   * @brief Replace the sink that logged messages are written to. The old sink
+   * is flushed and destroyed.
+   */
+  void log_sink(std::unique_ptr<sink> s);
+  sink* log_sink(void) const { return m_log_sink.get(); }
+
+  /**
+   * @brief Replace the sink that debug messages are written to. The old sink
+   * is flushed and destroyed.
    */
-  std::ofstream& log_stream(void);
+  void dbg_sink(std::unique_ptr<sink> s);
+  sink* dbg_sink(void) const { return m_dbg_sink.get(); }
 
   /**
-   * @brief Get a reference to the debugging stream.
+   * @brief Log messages in binary form via the specified writer instead of as
+   * text to the logfile. Passing NULL goes back to logging to the logfile.
    */
-  std::ostream& dbg_stream(void);
+  void binlog(std::unique_ptr<binlog_writer> writer);
+  binlog_writer* binlog(void) const { return m_binlog.get(); }
+
+  /**
+   * @brief Log messages in binary form to the specified file instead of as
+   * text to the logfile (\c __no_file__ goes back to the logfile). Use the
+   * \c er-decode tool to turn it back into text.
+   */
+  void change_binlog(const std::string& new_fname);
+
+  /**
+   * @brief Keep the most recent messages at every level from all modules in
+   * the specified \ref flight_recorder, whatever the module levels are (NULL
+   * stops recording). Should be set before messages are reported from
+   * multiple threads.
+   */
+  void recorder(std::shared_ptr<flight_recorder> rec);
+  const std::shared_ptr<flight_recorder>& recorder(void) const {
+    return m_recorder;
+  }
 
   const std::string& logfile_fname(void) const { return m_logfile_fname; }
 
+  /**
+   * @brief Get the counters for what the server and its clients are doing
+   * (see \ref er_metrics).
+   */
+  er_metrics& metrics(void) { return m_metrics; }
+  const er_metrics& metrics(void) const { return m_metrics; }
+
+  /**
+   * @brief Write the counters for each installed module (and for messages that
+   * could not be attributed to one), the per-level totals, and the latency
+   * histogram.
+   *
+   * @param os The stream to write to.
+   */
+  void metrics_dump(std::ostream& os) const;
+
+  /**
+   * @brief Prepend the time each message was reported (see \ref ts_formatter)
+   * to every message that is sent to stdout. Ignored if a calculator is
+   * installed via \ref dbg_ts_calculator().
+   */
+  void dbg_ts_builtin(bool en) { m_dbg_ts_builtin = en; }
+
+  /**
+   * @brief Prepend the time each message was reported (see \ref ts_formatter)
+   * to every message that is sent to a logfile. Ignored if a calculator is
+   * installed via \ref log_ts_calculator().
+   */
+  void log_ts_builtin(bool en) { m_log_ts_builtin = en; }
+
   /**
    * @brief Install a callback to calculate a timestamp to be prepended to every
    * message that is sent to stdout.
    *
    * This is useful when working with frameworks that do not provide such a
-   * timestamp, or that provide it for only logged messages.
+   * timestamp, or that provide it for only logged messages. The callback is
+   * called when the message is written out, which may be some time after it
+   * was reported; prefer \ref dbg_ts_builtin() if that matters.
    */
   void dbg_ts_calculator(std::function<std::string(void)> cb);
   const std::function<std::string(void)>& dbg_ts_calculator(void) const;
@@ -125,7 +262,9 @@ class server {
    * message that is sent to a logfile.
    *
    * This is useful when working with frameworks that do not provide such a
-   * timestamp, or that provide it for only messages sent to stdout.
+   * timestamp, or that provide it for only messages sent to stdout. As with
+   * \ref dbg_ts_calculator(), prefer \ref log_ts_builtin() if the time the
+   * message was reported matters.
    */
   void log_ts_calculator(std::function<std::string(void)> cb);
   const std::function<std::string(void)>& log_ts_calculator(void) const;
@@ -158,7 +297,39 @@ class server {
   status_t insmod(const boost::uuids::uuid& mod_id,
                   const er_lvl::value& loglvl,
                   const er_lvl::value& dbglvl,
-                  const std::string& mod_name);
+                  const std::string& mod_name) {
+    mod_handle h = insmod_handle(mod_id, loglvl, dbglvl, mod_name);
+    return (kINVALID_MOD_HANDLE != h) ? OK : ERROR;
+  }
+
+  /**
+   * @brief Unconditionally install a new module into the list of active
+   * debugging/logging modules, returning the handle for the new module.
+   *
+   * @param mod_id The UUID of the module to install.
+   * @param loglvl The initial logging level of the module.
+   * @param dbglvl The initial debug printing level of the module.
+   * @param mod_name The name of the module, which will be prepended to all
+   *                 messages.
+   *
+   * @return The handle for the new module, or \ref kINVALID_MOD_HANDLE if a
+   * module with the same UUID is already installed.
+   */
+  mod_handle insmod_handle(const boost::uuids::uuid& mod_id,
+                           const er_lvl::value& loglvl,
+                           const er_lvl::value& dbglvl,
+                           const std::string& mod_name);
+
+  /**
+   * @brief Get the handle for an installed module.
+   *
+   * @param id The UUID of the module.
+   *
+   * @return The handle, or \ref kINVALID_MOD_HANDLE if no such module is
+   * currently installed.
+   */
+  mod_handle mod_lookup(const boost::uuids::uuid& id) const;
+
   /**
    * @brief Unconditionally install a new module into the list of active
    * debuging/logging modules, short version. Uses the default logging/debugging
@@ -181,7 +352,8 @@ class server {
    *
    * @return \ref status_t.
    */
-  status_t rmmod(const boost::uuids::uuid& id);
+  status_t rmmod(const boost::uuids::uuid& id) { return rmmod(mod_lookup(id)); }
+  status_t rmmod(mod_handle handle);
 
   /**
    * @brief Set the debugging level of a module.
@@ -191,7 +363,10 @@ class server {
    *
    * @return \ref status_t.
    */
-  status_t mod_dbglvl(const boost::uuids::uuid& id, const er_lvl::value& lvl);
+  status_t mod_dbglvl(const boost::uuids::uuid& id, const er_lvl::value& lvl) {
+    return mod_dbglvl(mod_lookup(id), lvl);
+  }
+  status_t mod_dbglvl(mod_handle handle, const er_lvl::value& lvl);
 
   /**
    * @brief Get the current debugging level for the module.
@@ -217,19 +392,76 @@ class server {
    *
    * @return \ref status_t.
    */
-  status_t mod_loglvl(const boost::uuids::uuid& id, const er_lvl::value& lvl);
+  status_t mod_loglvl(const boost::uuids::uuid& id, const er_lvl::value& lvl) {
+    return mod_loglvl(mod_lookup(id), lvl);
+  }
+  status_t mod_loglvl(mod_handle handle, const er_lvl::value& lvl);
+
+  /**
+   * @brief Get the level gate for a module (see \ref server_mod::gate()).
+   *
+   * @return The gate, or NULL if no such module is currently installed.
+   */
+  std::shared_ptr<const std::atomic<int>> mod_gate(
+      const boost::uuids::uuid& id) {
+    return mod_gate(mod_lookup(id));
+  }
+  std::shared_ptr<const std::atomic<int>> mod_gate(mod_handle handle);
+
+  /**
+   * @brief Rate limit and/or sample the messages from a module (see \ref
+   * mod_limiter). Messages are checked by clients before they are formatted;
+   * suppressed ones are summarized periodically, and on \ref flush().
+   *
+   * @param id The UUID of the module.
+   * @param cfg The limits. A configuration that limits nothing removes any
+   *            limits on the module.
+   *
+   * @return \ref status_t.
+   */
+  status_t mod_limits(const boost::uuids::uuid& id,
+                      const mod_limiter::config& cfg) {
+    return mod_limits(mod_lookup(id), cfg);
+  }
+  status_t mod_limits(mod_handle handle, const mod_limiter::config& cfg);
+
+  /**
+   * @brief Get the limiter for a module, or NULL if the module does not exist
+   * or its messages are not limited. Used by clients to cache it.
+   */
+  std::shared_ptr<mod_limiter> limiter(mod_handle handle) const;
 
   /**
-   * @brief Change the logfile that the server will report events to.
+   * @brief Get a counter that changes every time a module is installed or
+   * removed, so that clients know when their cached module state may be stale.
+   */
+  uint64_t generation(void) const {
+    return m_generation.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Change the logfile that the server will report events to. This
+   * replaces the logging sink with a new \ref async_file_sink if rcppsw was
+   * built with io_uring support, or a \ref file_sink otherwise (or a \ref
+   * null_sink for \c __no_file__).
    */
   void change_logfile(const std::string& new_fname);
 
   /**
-   * @brief Generate a UUID for a new module.
+   * @brief Generate a UUID for a new module, according to the current \ref
+   * idgen_mode().
    *
    * @return The UUID.
    */
-  boost::uuids::uuid idgen(void);
+  boost::uuids::uuid idgen(void) { return m_idgen(); }
+
+  /**
+   * @brief Get/set how module UUIDs are generated. Switch to \ref
+   * mod_idgen::RANDOM if the UUIDs of clients need to be unique across
+   * processes.
+   */
+  mod_idgen::mode idgen_mode(void) const { return m_idgen.get_mode(); }
+  void idgen_mode(mod_idgen::mode m) { m_idgen.set_mode(m); }
 
   /**
    * @brief Get the current default logging level.
@@ -255,6 +487,17 @@ class server {
    */
   void dbglvl(const er_lvl::value& lvl) { m_dbglvl_dflt = lvl; }
 
+  /**
+   * @brief Get the default limits for new modules.
+   */
+  const mod_limiter::config& limits(void) const { return m_limits_dflt; }
+
+  /**
+   * @brief Set the default limits for new modules. Modules that are already
+   * installed are not affected.
+   */
+  void limits(const mod_limiter::config& cfg) { m_limits_dflt = cfg; }
+
   /**
    * @brief Get the hostname the server is running on.
    *
@@ -278,14 +521,60 @@ class server {
    * @param er_id The module reporting the message.
    * @param lvl The level of the message.
    * @param str The message.
+   * @param handle The handle of the reporting module, if known.
    */
-  virtual void report(const boost::uuids::uuid& er_id,
-                      const er_lvl::value& lvl,
-                      const std::string& str) {
-    msg_int msg(er_id, lvl, str);
-    msg_report(msg);
+  void report(const boost::uuids::uuid& er_id,
+              const er_lvl::value& lvl,
+              const std::string& str,
+              mod_handle handle = kINVALID_MOD_HANDLE) {
+    if (nullptr != m_recorder) {
+      m_recorder->record(handle, lvl, nullptr, str.data(), str.size());
+    }
+    msg_int msg(er_id, handle, lvl, nullptr, str);
+    if (m_metrics.enabled()) {
+      msg.t_report = timestamp::precise();
+    }
+    dispatch(std::move(msg));
   }
 
+  /**
+   * @brief Report a message whose formatting has been deferred. The message is
+   * only formatted if it will actually be printed/logged.
+   *
+   * @param er_id The module reporting the message.
+   * @param lvl The level of the message.
+   * @param desc The static descriptor for the reporting statement.
+   * @param args The arguments, as encoded by \ref deferred_encoder. Only
+   *             needs to be valid for the duration of the call (it is usually
+   *             the encoder's per-thread buffer).
+   * @param len The # of bytes of encoded arguments.
+   * @param handle The handle of the reporting module, if known.
+   */
+  void report_deferred(const boost::uuids::uuid& er_id,
+                       const er_lvl::value& lvl,
+                       const fmt_descriptor* desc,
+                       const char* args,
+                       std::size_t len,
+                       mod_handle handle = kINVALID_MOD_HANDLE) {
+    if (nullptr != m_recorder) {
+      m_recorder->record(handle, lvl, desc, args, len);
+    }
+    msg_int msg(er_id, handle, lvl, desc, std::string(args, len));
+    if (m_metrics.enabled()) {
+      msg.t_report = timestamp::precise();
+    }
+    dispatch(std::move(msg));
+  }
+
+  /**
+   * @brief Hand off a message for reporting. All reporting funnels through
+   * here, so this is the extension point for servers that want to report
+   * messages somewhere other than in the calling thread.
+   *
+   * @param msg The message.
+   */
+  virtual void dispatch(msg_int msg) { msg_report(msg); }
+
   /**
    * @brief Flush all pending messages to stdout/the log file.
    */
@@ -294,13 +583,101 @@ class server {
  protected:
   void msg_report(const msg_int& msg);
 
+  /**
+   * @brief Find the module a message is from, and where the message should go
+   * according to the module's levels.
+   *
+   * @param msg The message.
+   * @param handle To be filled with the handle of the module.
+   * @param to_log To be filled with whether the message should be logged.
+   * @param to_dbg To be filled with whether the message should be printed.
+   *
+   * @return The module, or NULL if it is not installed.
+   */
+  server_mod* msg_route(const msg_int& msg,
+                        mod_handle* handle,
+                        bool* to_log,
+                        bool* to_dbg) const;
+
+  /**
+   * @brief Write a message from the named module to the logfile (or binary
+   * log) and/or stdout, and update the metrics. No level checks are done.
+   *
+   * @param handle The handle the message is counted/binary logged under.
+   * @param mod_name The name of the module the message is from.
+   * @param msg The message.
+   * @param to_log Should the message be logged?
+   * @param to_dbg Should the message be printed?
+   */
+  void msg_write(mod_handle handle,
+                 const std::string& mod_name,
+                 const msg_int& msg,
+                 bool to_log,
+                 bool to_dbg);
+
+  /**
+   * @brief Give the sinks a chance to do time-based flushing. Should be called
+   * periodically by derived servers that have a thread of their own.
+   */
+  void sinks_poll(void);
+
+  /**
+   * @brief Write the counters for each module, for \ref metrics_dump(). Derived
+   * servers that count messages under handles of their own (i.e. for modules
+   * that are not installed here) should add those too.
+   *
+   * @param os The stream to write to.
+   */
+  virtual void metrics_dump_mods(std::ostream& os) const;
+
  private:
+  /**
+   * @brief Get the handle of the module a message is from, or \ref
+   * kINVALID_MOD_HANDLE if it is not installed.
+   */
+  mod_handle msg_handle(const msg_int& msg) const;
+
+  /**
+   * @brief Update the metrics for a message once it has been reported.
+   *
+   * @param handle The handle of the module the message is from.
+   * @param msg The message.
+   * @param bytes The # of bytes written for it; 0 means it was filtered out.
+   */
+  void msg_count(mod_handle handle, const msg_int& msg, std::size_t bytes);
+
+  /**
+   * @brief Write a summary for each module that has suppressed messages not yet
+   * summarized.
+   */
+  void limits_flush(void);
+
+  /**
+   * @brief Get the module for a handle, or NULL if the handle is invalid.
+   */
+  server_mod* mod_get(mod_handle handle) const {
+    return (handle < m_modules.size()) ? m_modules[handle].get() : nullptr;
+  }
+
   /* data members */
   char m_hostname[32];
 
-  std::vector<server_mod> m_modules;
+  /** Installed modules, indexed by handle. Removed modules leave a NULL. */
+  std::vector<std::unique_ptr<server_mod>> m_modules;
+
+  /** Handles of removed modules, available for reuse. */
+  std::vector<mod_handle> m_free_handles;
+
+  std::unordered_map<mod_key, mod_handle> m_index;
   std::string m_logfile_fname;              /// File to log events to.
-  std::unique_ptr<std::ofstream> m_logfile; /// Logfile handle.
+  std::unique_ptr<sink> m_log_sink;
+  std::unique_ptr<sink> m_dbg_sink;
+  sink_streambuf m_log_buf;
+  sink_streambuf m_dbg_buf;
+  std::ostream m_log_stream;
+  std::ostream m_dbg_stream;
+  std::unique_ptr<binlog_writer> m_binlog;
+  std::shared_ptr<flight_recorder> m_recorder{nullptr};
 
   /** Default log level for new modules */
   er_lvl::value m_loglvl_dflt;
@@ -308,11 +685,22 @@ class server {
   /** Default debug printing level for new modules. */
   er_lvl::value m_dbglvl_dflt;
 
+  /** Default limits for new modules. */
+  mod_limiter::config m_limits_dflt{};
+
   std::function<std::string(void)> m_dbg_ts_calculator;
   std::function<std::string(void)> m_log_ts_calculator;
+  bool m_dbg_ts_builtin{false};
+  bool m_log_ts_builtin{false};
+  ts_formatter m_ts_fmt{};
+  er_metrics m_metrics{};
+
+  /** Bumped on every module install/removal; starts at 1 so that clients
+   * (which start at 0) always fetch their gate on the first report. */
+  std::atomic<uint64_t> m_generation{1};
 
-  /** Generator for universally unique identifiers for modules */
-  boost::uuids::random_generator m_generator;
+  /** Generator for the identifiers of modules */
+  mod_idgen m_idgen{};
   boost::uuids::uuid m_er_id;
 };
 
@@ -26,16 +26,36 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <atomic>
 #include <boost/uuid/uuid.hpp>
+#include <cstdint>
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include "rcppsw/er/er_lvl.hpp"
+#include "rcppsw/er/mod_idgen.hpp"
+#include "rcppsw/er/mod_limiter.hpp"
 
 /*******************************************************************************
  * Namespaces
  ******************************************************************************/
 NS_START(rcppsw, er);
 
+/*******************************************************************************
+ * Type Definitions
+ ******************************************************************************/
+/**
+ * @brief A small, dense index identifying a module installed in a particular
+ * \ref server. Handles of removed modules are reused, so they are only
+ * meaningful together with the module's UUID.
+ */
+typedef uint32_t mod_handle;
+
+/**
+ * @brief The handle that does not refer to any module.
+ */
+constexpr mod_handle kINVALID_MOD_HANDLE = UINT32_MAX;
+
 /*******************************************************************************
  * Class Definitions
  ******************************************************************************/
@@ -44,6 +64,10 @@ NS_START(rcppsw, er);
  * @ingroup er
  *
  * @brief Representation of a module within the ER framework.
+ *
+ * Only the 64 bit \ref mod_key of the module's UUID is kept; \ref id() gives
+ * back the canonical UUID for it, which is interchangeable with the original
+ * for all lookups.
  */
 class server_mod {
  public:
@@ -72,30 +96,46 @@ class server_mod {
   er_lvl::value loglvl(void) { return m_loglvl; }
 
   /**
-   * @brief Log a message to a file if the message level is high enough.
+   * @brief Get the level gate for the module: the least severe level that will
+   * be either printed or logged. Shared with all copies of the module, and
+   * updated whenever the debug/log levels change, so that clients can cheaply
+   * skip messages that would be dropped anyway.
+   */
+  std::shared_ptr<const std::atomic<int>> gate(void) const { return m_gate; }
+
+  /**
+   * @brief Get the rate limiter/sampler for the module, or NULL if its
+   * messages are not limited. Shared with clients the same way as the gate.
+   */
+  std::shared_ptr<mod_limiter> limiter(void) const { return m_limiter; }
+
+  /**
+   * @brief Limit the messages from the module. Any count of suppressed
+   * messages not yet summarized carries over to the new limiter.
    *
-   * @param header The header for the msg (timestamp, etc.). Can be empty.
-   * @param msg The message to log.
-   * @param msg_lvl The level of the message.
-   * @param log_lvl The level of the message.
-   * @param stream The stream to log the message to.
+   * @param cfg The limits; if nothing is limited, the limiter is removed.
    */
-  void msg_report(const std::string& header,
-                  const std::string& msg,
-                  er_lvl::value msg_lvl,
-                  er_lvl::value log_lvl,
-                  std::ostream& stream) const;
+  void set_limits(const mod_limiter::config& cfg);
+
   bool operator==(const server_mod& rhs);
-  const boost::uuids::uuid& id(void) const { return m_id; }
-  void change_id(boost::uuids::uuid id) { m_id = id; }
+  boost::uuids::uuid id(void) const { return mod_idgen::from_key(m_key); }
+  mod_key key(void) const { return m_key; }
+  void change_id(boost::uuids::uuid id) { m_key = mod_idgen::key(id); }
   const std::string& name(void) const { return m_name; }
 
  private:
+  /**
+   * @brief Recompute the level gate after a level change.
+   */
+  void gate_update(void);
+
   /* data members */
-  boost::uuids::uuid m_id;
+  mod_key m_key;
   std::string m_name;
   er_lvl::value m_loglvl;
   er_lvl::value m_dbglvl;
+  std::shared_ptr<std::atomic<int>> m_gate;
+  std::shared_ptr<mod_limiter> m_limiter{nullptr};
 };
 
 /*******************************************************************************
@@ -0,0 +1,253 @@
+/**
+ * @file sharded_server.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_SHARDED_SERVER_HPP_
+#define INCLUDE_RCPPSW_ER_SHARDED_SERVER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <boost/thread/mutex.hpp>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include "rcppsw/er/server.hpp"
+#include "rcppsw/multithread/futex.hpp"
+#include "rcppsw/multithread/mpsc_ring.hpp"
+#include "rcppsw/multithread/threadable.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class sharded_server
+ * @ingroup er
+ *
+ * @brief A multithreaded version of the \ref server in which each reporting
+ * thread has a queue of its own (a shard), so that reporting a message does
+ * not write to any memory shared with other reporting threads.
+ *
+ * A thread's shard is created and registered the first time one of its \ref
+ * client objects reports something through the server; after that the thread
+ * finds it via a thread local cache. The merger thread drains all shards and
+ * reports messages in timestamp order, so the output is globally ordered even
+ * though the shards are filled independently.
+ *
+ * To know when it is safe to report a message, each shard publishes the
+ * timestamp of the message its thread is in the middle of enqueueing. The
+ * merger only reports messages older than both the oldest such timestamp and
+ * the time it started looking, since any message it has not seen yet must have
+ * been stamped after one of those. Messages are stamped with \ref
+ * timestamp::precise(), so messages from different threads only compare equal
+ * if they were stamped in the same nanosecond.
+ *
+ * When there is nothing to merge the merger thread sleeps on a futex, and
+ * reporting threads only wake it if it is asleep, so in the common case
+ * reporting still does not write to any shared memory.
+ */
+class sharded_server : public server, public multithread::threadable {
+ public:
+  /**
+   * @brief Initialize a sharded ER server.
+   *
+   * @param logfile_fname The name of the file to log events to. If the file
+   *                      already exists, it is deleted.
+   * @param dbglvl The initial debug printing level.
+   * @param loglvl The initial logging level.
+   * @param shard_size The # of messages each thread can have waiting for the
+   *                   merger before the overflow policy kicks in.
+   * @param policy What to do with new messages when a shard is full.
+   */
+  sharded_server(const std::string& logfile_fname,
+                 const er_lvl::value& dbglvl,
+                 const er_lvl::value& loglvl,
+                 std::size_t shard_size = kDEFAULT_SHARD_SIZE,
+                 multithread::overflow_policy::value policy =
+                     multithread::overflow_policy::BLOCK);
+
+  /**
+   * @brief Initialize a sharded ER server with default values.
+   */
+  sharded_server(void)
+      : sharded_server("__no_file__", er_lvl::NOM, er_lvl::NOM) {}
+
+  ~sharded_server(void) override;
+
+  /**
+   * @brief The default # of messages each shard can hold.
+   */
+  static constexpr std::size_t kDEFAULT_SHARD_SIZE = 1024;
+
+  /**
+   * @brief Signal the merger thread to terminate. Any messages still in the
+   * shards are reported before it exits.
+   */
+  void term(void) override {
+    threadable::term();
+    wake();
+  }
+
+  /**
+   * @brief Get the # of shards (i.e. reporting threads) currently registered.
+   */
+  std::size_t n_shards(void) const;
+
+  /**
+   * @brief Get the # of messages discarded because a shard was full.
+   */
+  uint64_t n_dropped(void) const;
+
+  /**
+   * @brief Report all messages that can be reported without breaking
+   * timestamp order, and flush stdout/the log file.
+   */
+  void flush(void) override;
+
+  /**
+   * @brief The entry point of the merger thread.
+   *
+   * @param arg Unused.
+   *
+   * @return Unused.
+   */
+  void* thread_main(__unused void* arg) override;
+
+  /**
+   * @brief Put a message in the calling thread's shard, registering the shard
+   * first if this is the first message from the thread.
+   *
+   * @param msg The message.
+   */
+  void dispatch(msg_int msg) override;
+
+ private:
+  /**
+   * @brief Value of \ref shard::inflight when the owning thread is not in the
+   * middle of enqueueing a message.
+   */
+  static constexpr uint64_t kIDLE = std::numeric_limits<uint64_t>::max();
+
+  /**
+   * @brief How long the merger thread sleeps when there is nothing to report
+   * before it polls the sinks anyway, so that time based flushing still
+   * happens.
+   */
+  static constexpr std::size_t kWAIT_TIMEOUT_MS = 100;
+
+  /**
+   * @brief The per-thread state. Only the owning thread enqueues into \c ring
+   * and writes \c inflight; only the merger touches \c staged.
+   */
+  struct shard {
+    shard(std::size_t size, multithread::overflow_policy::value policy)
+        : ring(size, policy) {}
+
+    multithread::mpsc_ring<msg_int> ring;
+    std::atomic<uint64_t> inflight{kIDLE};
+    std::atomic<bool> orphaned{false};
+    std::atomic<bool> dead{false};
+    std::deque<msg_int> staged{};
+  };
+
+  /**
+   * @brief Get the calling thread's shard, creating and registering it if
+   * needed.
+   */
+  shard* shard_get(void);
+
+  /**
+   * @brief Drain all shards and report everything older than the safe
+   * horizon, in timestamp order.
+   *
+   * @param drain_all If \c TRUE, report everything drained regardless of the
+   *                  horizon (used when the merger thread is exiting).
+   *
+   * @return The # of messages reported.
+   */
+  std::size_t merge(bool drain_all);
+
+  /**
+   * @brief Get the timestamp before which no new messages can appear in any
+   * shard.
+   */
+  uint64_t horizon(void) const;
+
+  /**
+   * @brief Update the merger's list of shards from the registry, dropping
+   * shards whose threads have exited and that have nothing left to report.
+   */
+  void shards_refresh(void);
+
+  /**
+   * @brief Determine if there is nothing left for the merger to do: all known
+   * shards are empty and no new ones have been registered since the last
+   * merge.
+   */
+  bool shards_idle(void) const;
+
+  /**
+   * @brief Block the merger thread until a reporting thread or \ref term()
+   * wakes it, or \ref kWAIT_TIMEOUT_MS elapses.
+   *
+   * @param epoch The value of \ref m_wake before the last merge; if it has
+   *              changed since then we return immediately.
+   */
+  void sleep(uint32_t epoch);
+
+  /**
+   * @brief Wake the merger thread.
+   */
+  void wake(void) {
+    m_wake.fetch_add(1, std::memory_order_seq_cst);
+    multithread::futex::wake_all(&m_wake);
+  }
+
+  /** Unique across all sharded servers ever created; keys the thread local
+   * shard caches so that a new server at the address of an old one does not
+   * find the old server's shards. */
+  const uint64_t                       mc_id;
+  const std::size_t                    mc_shard_size;
+  const multithread::overflow_policy::value mc_policy;
+
+  mutable boost::mutex                 m_registry_mtx{};
+  std::vector<std::shared_ptr<shard>>  m_registry{};
+  std::atomic<uint64_t>                m_registry_gen{0};
+
+  /** Held by whoever is merging (the merger thread or \ref flush()) */
+  boost::mutex                         m_merge_mtx{};
+  std::vector<std::shared_ptr<shard>>  m_shards{};
+  uint64_t                             m_shards_gen{0};
+
+  /** Bumped to wake the merger thread, which sleeps on it */
+  std::atomic<uint32_t>                m_wake{0};
+  std::atomic<bool>                    m_sleeping{false};
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_SHARDED_SERVER_HPP_ */
@@ -0,0 +1,228 @@
+/**
+ * @file shm_server.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_SHM_SERVER_HPP_
+#define INCLUDE_RCPPSW_ER_SHM_SERVER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <sys/types.h>
+#include <unistd.h>
+#include <boost/thread/mutex.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "rcppsw/er/server.hpp"
+#include "rcppsw/multiprocess/ipc.hpp"
+#include "rcppsw/multiprocess/ipc_ring.hpp"
+#include "rcppsw/multithread/threadable.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @struct shm_record
+ * @ingroup er
+ *
+ * @brief A message as it travels through shared memory: fully formatted, and
+ * already routed according to the levels of the module it came from in the
+ * reporting process. Text that does not fit is truncated.
+ */
+struct shm_record {
+  static constexpr std::size_t kMOD_NAME_LEN = 40;
+  static constexpr std::size_t kTEXT_LEN = 448;
+
+  uint64_t ts;
+  int32_t pid;
+  uint16_t len;
+  uint8_t lvl;
+  uint8_t to_log : 1;
+  uint8_t to_dbg : 1;
+  char mod_name[kMOD_NAME_LEN];
+  char text[kTEXT_LEN];
+};
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class shm_server
+ * @ingroup er
+ *
+ * @brief A \ref server that collects the messages reported by a whole process
+ * tree and writes them to a single set of sinks.
+ *
+ * The server creates a shared memory segment holding a lock-free \ref
+ * multiprocess::ipc_ring of \ref shm_record. Processes forked after the server
+ * is created (e.g. via \ref multiprocess::forkable) inherit the mapping along
+ * with their copy of the server, and every message reported through any copy
+ * is level checked and formatted in the reporting process (which is the only
+ * one that knows about modules it installed after the fork), then put in the
+ * ring. Reporting is just a memory copy; no pipe and no system call per
+ * message.
+ *
+ * The collector thread, started in the process that created the server, drains
+ * the ring and writes everything to its sinks (or binary log) in the order the
+ * messages went into the ring. When the ring is empty it sleeps on a futex in
+ * the shared segment, which reporting processes only wake if it is asleep.
+ *
+ * Only the creating process removes the segment, when its copy of the server
+ * is destroyed.
+ */
+class shm_server : public server, public multithread::threadable {
+ public:
+  /**
+   * @brief Initialize a shared memory ER server.
+   *
+   * @param logfile_fname The name of the file to log events to. If the file
+   *                      already exists, it is deleted.
+   * @param dbglvl The initial debug printing level.
+   * @param loglvl The initial logging level.
+   * @param shm_name The name of the shared memory segment. Any existing segment
+   *                 with the same name is removed. If empty, a name derived
+   *                 from the PID is used.
+   * @param n_records The # of messages that can be waiting for the collector
+   *                  before the overflow policy kicks in.
+   */
+  shm_server(const std::string& logfile_fname,
+             const er_lvl::value& dbglvl,
+             const er_lvl::value& loglvl,
+             const std::string& shm_name = "",
+             std::size_t n_records = kDEFAULT_N_RECORDS);
+
+  /**
+   * @brief Initialize a shared memory ER server with default values.
+   */
+  shm_server(void) : shm_server("__no_file__", er_lvl::NOM, er_lvl::NOM) {}
+
+  ~shm_server(void) override;
+
+  /**
+   * @brief The default # of records in the ring.
+   */
+  static constexpr std::size_t kDEFAULT_N_RECORDS = 4096;
+
+  /**
+   * @brief What happens to messages when the ring is full. Messages are dropped
+   * rather than blocking, so that a process tree whose collector has died does
+   * not hang.
+   */
+  static constexpr multithread::overflow_policy::value kPOLICY =
+      multithread::overflow_policy::DROP_NEWEST;
+
+  const std::string& shm_name(void) const { return m_shm_name; }
+
+  /**
+   * @brief Signal the collector thread to terminate. Any messages still in the
+   * ring are reported before it exits.
+   */
+  void term(void) override {
+    threadable::term();
+    m_ring->wake();
+  }
+
+  /**
+   * @brief Get the # of messages discarded because the ring was full, across
+   * all processes.
+   */
+  uint64_t n_dropped(void) const { return m_ring->n_dropped(); }
+
+  /**
+   * @brief Write out everything currently in the ring and flush stdout/the log
+   * file. Only does anything in the collecting process.
+   */
+  void flush(void) override;
+
+  /**
+   * @brief The entry point of the collector thread.
+   *
+   * @param arg Unused.
+   *
+   * @return Unused.
+   */
+  void* thread_main(__unused void* arg) override;
+
+  /**
+   * @brief Format and route a message according to the levels of its module
+   * in the calling process, and put it in the ring.
+   *
+   * @param msg The message.
+   */
+  void dispatch(msg_int msg) override;
+
+ protected:
+  /**
+   * @brief Write the counters for each local module, and for each module that
+   * only exists in other processes.
+   */
+  void metrics_dump_mods(std::ostream& os) const override;
+
+ private:
+  typedef multiprocess::ipc_ring<shm_record> ring_type;
+
+  /**
+   * @brief How long the collector sleeps when the ring is empty before it
+   * polls the sinks anyway, so that time based flushing still happens.
+   */
+  static constexpr std::size_t kWAIT_TIMEOUT_MS = 100;
+
+  /**
+   * @brief Handles used for modules that only exist in other processes are
+   * counted from here, in the upper half of the range \ref er_metrics keeps
+   * counters for, so they cannot clash with local ones (which are allocated
+   * densely from 0).
+   */
+  static constexpr mod_handle kREMOTE_HANDLE_BASE =
+      er_metrics::kMAX_HANDLES / 2;
+
+  bool collector(void) const { return getpid() == mc_owner; }
+
+  /**
+   * @brief Write out everything currently in the ring.
+   *
+   * @return The # of records written.
+   */
+  std::size_t drain(void);
+
+  /**
+   * @brief Get the handle a record from the named module is counted/binary
+   * logged under: the handle of the local module with that name if there is
+   * one, and a stable handle of its own otherwise.
+   */
+  mod_handle remote_handle(const std::string& mod_name);
+
+  /* data members */
+  const pid_t                                      mc_owner;
+  std::string                                      m_shm_name;
+  std::unique_ptr<multiprocess::bip::managed_shared_memory> m_segment;
+  ring_type*                                       m_ring{nullptr};
+  std::unordered_map<std::string, mod_handle>      m_remote{};
+  mutable boost::mutex                             m_drain_mtx{};
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_SHM_SERVER_HPP_ */
@@ -0,0 +1,76 @@
+/**
+ * @file sink.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_SINK_HPP_
+#define INCLUDE_RCPPSW_ER_SINK_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include "rcppsw/er/er_lvl.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class sink
+ * @ingroup er
+ *
+ * @brief Somewhere formatted records from the \ref server end up. Sinks are
+ * free to buffer records, but must make everything written so far durable (as
+ * far as the sink is concerned) when \ref flush() is called.
+ */
+class sink {
+ public:
+  sink(void) = default;
+  virtual ~sink(void) = default;
+  sink(const sink&) = delete;
+  sink& operator=(const sink&) = delete;
+
+  /**
+   * @brief Write a formatted record.
+   *
+   * @param data The record.
+   * @param len The length of the record in bytes.
+   * @param lvl The level of the message the record is for.
+   */
+  virtual void write(const char* data, std::size_t len, er_lvl::value lvl) = 0;
+
+  /**
+   * @brief Write out anything that is buffered.
+   */
+  virtual void flush(void) = 0;
+
+  /**
+   * @brief Called periodically by servers that have a thread of their own, so
+   * that time-based flushing happens even when nothing is being reported.
+   */
+  virtual void poll(void) {}
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_SINK_HPP_ */
@@ -0,0 +1,78 @@
+/**
+ * @file sink_streambuf.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_SINK_STREAMBUF_HPP_
+#define INCLUDE_RCPPSW_ER_SINK_STREAMBUF_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <streambuf>
+#include "rcppsw/er/sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class sink_streambuf
+ * @ingroup er
+ *
+ * @brief Adapts a \ref sink so that it can sit behind a \c std::ostream. The
+ * sink does the buffering, so this does none of its own. Everything written
+ * through it is treated as \ref er_lvl::NOM.
+ */
+class sink_streambuf : public std::streambuf {
+ public:
+  explicit sink_streambuf(sink* target) : m_target(target) {}
+
+  /**
+   * @brief Change the sink that output goes to.
+   */
+  void target(sink* target) { m_target = target; }
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    m_target->write(s, static_cast<std::size_t>(n), er_lvl::NOM);
+    return n;
+  }
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      char ch = traits_type::to_char_type(c);
+      m_target->write(&ch, 1, er_lvl::NOM);
+    }
+    return traits_type::not_eof(c);
+  }
+  int sync(void) override {
+    m_target->flush();
+    return 0;
+  }
+
+ private:
+  sink* m_target;
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_SINK_STREAMBUF_HPP_ */
@@ -0,0 +1,63 @@
+/**
+ * @file stdout_sink.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_STDOUT_SINK_HPP_
+#define INCLUDE_RCPPSW_ER_STDOUT_SINK_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/buffered_sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class stdout_sink
+ * @ingroup er
+ *
+ * @brief A \ref buffered_sink that writes to stdout. Batches go through stdio
+ * (and are flushed out of it immediately), so that they stay correctly ordered
+ * with respect to anything else the application prints via stdio or
+ * \c std::cout.
+ */
+class stdout_sink : public buffered_sink {
+ public:
+  /**
+   * @param capacity Size of the buffer in bytes.
+   * @param interval_ms Max time a record sits in the buffer, in milliseconds.
+   */
+  explicit stdout_sink(std::size_t capacity = kDEFAULT_CAPACITY,
+                       uint32_t interval_ms = kDEFAULT_INTERVAL_MS)
+      : buffered_sink(capacity, interval_ms, false) {}
+  ~stdout_sink(void) override { flush(); }
+
+ protected:
+  void sink_write(const char* data, std::size_t len) override;
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_STDOUT_SINK_HPP_ */
@@ -0,0 +1,81 @@
+/**
+ * @file timestamp.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_TIMESTAMP_HPP_
+#define INCLUDE_RCPPSW_ER_TIMESTAMP_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <time.h>
+#include <cstdint>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class timestamp
+ * @ingroup er
+ *
+ * @brief The clock that reported messages are stamped with.
+ *
+ * Reading it is just a vDSO call returning a raw integer, so it is cheap enough
+ * to do for every message at the time it is reported; turning the raw value
+ * into something human readable is left to \ref ts_formatter on the writing
+ * side. CLOCK_MONOTONIC_COARSE only has the resolution of the kernel tick
+ * (usually 1-4 ms), which is fine for log timestamps, and does not jump.
+ */
+class timestamp {
+ public:
+  /**
+   * @brief Get the current raw timestamp, in nanoseconds since some arbitrary
+   * point in the past.
+   */
+  static uint64_t now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * kNS_PER_SEC +
+           static_cast<uint64_t>(ts.tv_nsec);
+  }
+
+  /**
+   * @brief Get the current time from the same clock as \ref now(), but at
+   * full resolution. Costs a bit more, so it is only used where the
+   * resolution of \ref now() is not enough.
+   */
+  static uint64_t precise(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * kNS_PER_SEC +
+           static_cast<uint64_t>(ts.tv_nsec);
+  }
+
+  static constexpr uint64_t kNS_PER_SEC = 1000000000;
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_TIMESTAMP_HPP_ */
@@ -0,0 +1,84 @@
+/**
+ * @file ts_formatter.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_ER_TS_FORMATTER_HPP_
+#define INCLUDE_RCPPSW_ER_TS_FORMATTER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstdint>
+#include <string>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class ts_formatter
+ * @ingroup er
+ *
+ * @brief Turns raw \ref timestamp values into wall clock time, and wall clock
+ * time into text of the form "[YYYY-MM-DD HH:MM:SS.mmm]".
+ *
+ * The date/time part only changes once a second, so it is cached and only the
+ * milliseconds are formatted for each message. The offset between the raw
+ * clock and the wall clock is re-sampled whenever the cached second changes,
+ * so that wall clock adjustments are picked up.
+ *
+ * Not thread safe; meant to be used by whichever thread writes messages out.
+ */
+class ts_formatter {
+ public:
+  ts_formatter(void);
+
+  /**
+   * @brief Convert a raw \ref timestamp value to nanoseconds since the UNIX
+   * epoch.
+   */
+  uint64_t wall_ns(uint64_t raw) const;
+
+  /**
+   * @brief Format a raw \ref timestamp value.
+   */
+  std::string format(uint64_t raw) { return format_wall(wall_ns(raw)); }
+
+  /**
+   * @brief Format a time in nanoseconds since the UNIX epoch.
+   */
+  std::string format_wall(uint64_t wall_ns);
+
+ private:
+  void offset_update(void);
+
+  /* data members */
+  int64_t m_offset{0};
+  uint64_t m_cached_sec{UINT64_MAX};
+  std::string m_cached_prefix{};
+};
+
+NS_END(er, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_ER_TS_FORMATTER_HPP_ */
@@ -26,14 +26,18 @@
 #include <time.h>
 #include <algorithm>
 #include <boost/shared_ptr.hpp>
+#include <cassert>
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 #include "rcppsw/common/common.hpp"
 #include "rcppsw/er/client.hpp"
+#include "rcppsw/er/server.hpp"
 #include "rcppsw/kmeans/cluster.hpp"
+#include "rcppsw/multithread/task_graph.hpp"
 #include "rcsw/utils/time_utils.h"
 
 /*******************************************************************************
@@ -48,7 +52,7 @@ NS_START(rcppsw, kmeans);
  * @brief Base class implementation of k-means clustering algorithm.
  */
 template <typename T>
-class cluster_algorithm : public common::er_client {
+class cluster_algorithm : public er::client {
  public:
   cluster_algorithm(std::size_t n_iterations,
                     std::size_t n_clusters,
@@ -57,8 +61,8 @@ class cluster_algorithm : public common::er_client {
                     std::size_t n_points,
                     const std::string& clusters_fname,
                     const std::string& centroids_fname,
-                    common::er_server* const erf)
-      : common::er_client(erf),
+                    const std::shared_ptr<er::server>& server)
+      : er::client(server),
         m_n_iterations(n_iterations),
         m_n_clusters(n_clusters),
         m_n_threads(n_threads),
@@ -69,8 +73,8 @@ class cluster_algorithm : public common::er_client {
         m_clusters_fname(clusters_fname),
         m_centroids_fname(centroids_fname),
         m_clusters(new std::vector<kmeans_cluster<T>*>()) {
-    server_handle()->insmod(er_id(), "KMEANS");
-    ER_NOM("n_points=%lu, n_clusters=%lu, n_iterations=%lu\n",
+    client::insmod("KMEANS");
+    ER_NOM("n_points=%lu, n_clusters=%lu, n_iterations=%lu",
            m_n_points,
            m_n_clusters,
            m_n_iterations);
@@ -108,23 +112,34 @@ class cluster_algorithm : public common::er_client {
                   m_clusters->end(),
                   [&](const kmeans_cluster<T>* c) { c->report_center(ofile); });
   }
+  /**
+   * @brief Write out the cluster memberships and centroids. The two do not
+   * depend on each other, so they are written concurrently.
+   */
+  void report(void) {
+    multithread::task_graph graph;
+    graph.add([this]() { report_clusters(); });
+    graph.add([this]() { report_centroids(); });
+    graph.run();
+    graph.wait();
+  }
   void cluster(void) {
-    ER_NOM("Begin clustering\n");
+    ER_NOM("Begin clustering");
     double end = 0.0;
     double start = time_monotonic_sec();
     for (std::size_t i = 0; i < m_n_iterations; ++i) {
       double iter_start = time_monotonic_sec();
       if (cluster_iterate()) {
-        ER_NOM("Clusters report convergence: terminating\n");
+        ER_NOM("Clusters report convergence: terminating");
         end = time_monotonic_sec();
         break;
       } else {
         end = time_monotonic_sec();
       }
-      ER_DIAG("Iteration %lu time: %.8fms\n", i, (end - iter_start) * 1000);
+      ER_DIAG("Iteration %lu time: %.8fms", i, (end - iter_start) * 1000);
     } /* for(i..) */
 
-    ER_NOM("k-means clustering time: %0.04fs\n", end - start);
+    ER_NOM("k-means clustering time: %0.04fs", end - start);
   } /* cluster_algorithm::cluster() */
 
   virtual void initialize(std::vector<multidim_point<T>>* data_in) {
@@ -173,8 +188,8 @@ class cluster_algorithm : public common::er_client {
   std::size_t m_n_points;
   T* m_data;
   std::size_t* m_membership;
-  const std::string& m_clusters_fname;
-  const std::string& m_centroids_fname;
+  std::string m_clusters_fname;
+  std::string m_centroids_fname;
   boost::shared_ptr<std::vector<kmeans_cluster<T>*>> m_clusters;
 };
 
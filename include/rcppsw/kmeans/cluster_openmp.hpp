@@ -31,7 +31,7 @@ class cluster_openmp : public cluster_algorithm<T> {
                  std::size_t n_points,
                  const std::string& clusters_fname,
                  const std::string& centroids_fname,
-                 common::er_server* const erf)
+                 const std::shared_ptr<er::server>& server)
       : cluster_algorithm<T>(n_iterations,
                              n_clusters,
                              n_threads,
@@ -39,7 +39,7 @@ class cluster_openmp : public cluster_algorithm<T> {
                              n_points,
                              clusters_fname,
                              centroids_fname,
-                             erf) {}
+                             server) {}
 
   void first_touch_allocation(void) {
 #pragma omp parallel for num_threads(cluster_algorithm < T > ::n_threads())
@@ -24,11 +24,13 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
+#include <memory>
 #include <string>
 #include <vector>
 #include "rcppsw/common/common.hpp"
 #include "rcppsw/kmeans/cluster_algorithm.hpp"
 #include "rcppsw/kmeans/pthread_worker.hpp"
+#include "rcppsw/multithread/range.hpp"
 
 /*******************************************************************************
  * Namespaces
@@ -52,7 +54,7 @@ class cluster_pthread : public cluster_algorithm<T> {
                   std::size_t n_points,
                   const std::string& m_clustersfname,
                   const std::string& centroids_fname,
-                  common::er_server* const erf)
+                  const std::shared_ptr<er::server>& server)
       : cluster_algorithm<T>(n_iterations,
                              n_clusters,
                              n_threads,
@@ -60,44 +62,42 @@ class cluster_pthread : public cluster_algorithm<T> {
                              n_points,
                              m_clustersfname,
                              centroids_fname,
-                             erf),
+                             server),
+        m_ctl(n_threads),
         m_workers() {
-    std::size_t data_chunk_size = n_points / n_threads;
-    std::size_t centers_chunk_size = n_clusters / n_threads;
-    std::size_t prev_centers_i = 0;
-    std::size_t prev_data_i = 0;
-    std::size_t data_chunk_start = 0;
-    std::size_t centers_chunk_start = 0;
+    multithread::range data(0, n_points);
+    multithread::range centers(0, n_clusters);
 
     for (std::size_t i = 0; i < n_threads; ++i) {
-      if (n_points % n_threads != 0 && i == n_threads - 1) {
-        data_chunk_size = n_points - data_chunk_start;
-      }
-      if (n_clusters % n_threads != 0 && i == n_threads - 1) {
-        centers_chunk_size = n_points - centers_chunk_start;
-      }
-      ER_NOM("Worker %lu: %lu - %lu, %lu - %lu\n",
+      multithread::range data_chunk = data.piece(i, n_threads);
+      multithread::range centers_chunk = centers.piece(i, n_threads);
+      ER_NOM("Worker %lu: points %lu - %lu, centers %lu - %lu",
              i,
-             data_chunk_start,
-             data_chunk_start + data_chunk_size,
-             centers_chunk_start,
-             centers_chunk_start + centers_chunk_size);
-
-      m_workers.emplace_back(
-          pthread_worker<T>(i,
-                            data_chunk_start,
-                            data_chunk_size,
-                            centers_chunk_start,
-                            centers_chunk_size,
-                            dimension,
-                            cluster_algorithm<T>::clusters()));
-      data_chunk_start = prev_data_i + data_chunk_size;
-      centers_chunk_start = prev_centers_i + centers_chunk_size;
-      prev_centers_i += centers_chunk_size;
-      prev_data_i += data_chunk_size;
+             data_chunk.begin(),
+             data_chunk.end(),
+             centers_chunk.begin(),
+             centers_chunk.end());
+
+      m_workers.emplace_back(new pthread_worker<T>(
+          i,
+          data_chunk.begin(),
+          data_chunk.size(),
+          centers_chunk.begin(),
+          centers_chunk.size(),
+          dimension,
+          cluster_algorithm<T>::clusters()));
+      m_workers.back()->start(&m_ctl);
     } /* for(i..) */
   }   /* kmeans_cluster_pthread::kmeans_cluster_pthread() */
 
+  ~cluster_pthread(void) override {
+    m_ctl.instr = nullptr;
+    m_ctl.step.wait();
+    for (auto& w : m_workers) {
+      w->join();
+    } /* for(w..) */
+  }
+
   /**
    * @brief Perform first-touch memory/page allocation for all threads.
    */
@@ -110,13 +110,7 @@ class cluster_pthread : public cluster_algorithm<T> {
         cluster_algorithm<T>::data(),
         cluster_algorithm<T>::membership(),
     };
-
-    std::for_each(m_workers.begin(),
-                  m_workers.end(),
-                  [&](pthread_worker<T>& w) { w.start(&instr); });
-    std::for_each(m_workers.begin(),
-                  m_workers.end(),
-                  [&](pthread_worker<T>& w) { w.join(); });
+    phase_run(instr);
   }
 
   /**
@@ -133,14 +127,7 @@ class cluster_pthread : public cluster_algorithm<T> {
         pthread_worker<T>::instruction::CLUSTER_POINTS,
         cluster_algorithm<T>::data(),
         cluster_algorithm<T>::membership()};
-
-    for (std::size_t i = 0; i < m_workers.size(); ++i) {
-      m_workers[i].start(&instr1);
-    } /* for(i..) */
-
-    for (std::size_t i = 0; i < m_workers.size(); ++i) {
-      m_workers[i].join();
-    } /* for(i..) */
+    phase_run(instr1);
 
     /*
      * Update the center for all clusters
@@ -150,21 +137,15 @@ class cluster_pthread : public cluster_algorithm<T> {
         cluster_algorithm<T>::data(),
         cluster_algorithm<T>::membership(),
     };
-    for (std::size_t i = 0; i < m_workers.size(); ++i) {
-      m_workers[i].start(&instr2);
-    } /* for(i..) */
-
-    for (std::size_t i = 0; i < m_workers.size(); ++i) {
-      m_workers[i].join();
-    } /* for(i..) */
+    phase_run(instr2);
 
     /* Finally, check for convergence */
     bool ret = true;
     for (std::size_t i = 0; i < cluster_algorithm<T>::n_clusters(); ++i) {
       if (cluster_algorithm<T>::clusters()->at(i)->convergence()) {
-        ER_DIAG("Cluster %lu reports convergence\n", i);
+        ER_DIAG("Cluster %lu reports convergence", i);
       } else {
-        ER_DIAG("Cluster %lu reports no convergence\n", i);
+        ER_DIAG("Cluster %lu reports no convergence", i);
         ret = false;
       }
     } /* for(i..) */
@@ -172,7 +153,17 @@ class cluster_pthread : public cluster_algorithm<T> {
   } /* cluster_pthread::cluster_iterate() */
 
  private:
-  std::vector<pthread_worker<T>> m_workers;
+  /**
+   * @brief Have all workers run a single phase, returning when they are done.
+   */
+  void phase_run(const typename pthread_worker<T>::instruction_data& instr) {
+    m_ctl.instr = &instr;
+    m_ctl.step.wait(); /* go */
+    m_ctl.step.wait(); /* done */
+  }
+
+  typename pthread_worker<T>::phase_control m_ctl;
+  std::vector<std::unique_ptr<pthread_worker<T>>> m_workers;
 };
 
 NS_END(kmeans, rcppsw);
@@ -32,6 +32,7 @@
 #include <vector>
 #include "rcppsw/common/common.hpp"
 #include "rcppsw/kmeans/cluster.hpp"
+#include "rcppsw/multithread/barrier.hpp"
 #include "rcppsw/multithread/threadable.hpp"
 #include "rcsw/multithread/threadm.h"
 
@@ -43,9 +44,39 @@ NS_START(rcppsw, kmeans);
 /*******************************************************************************
  * Class Definitions
  ******************************************************************************/
+/**
+ * @brief A long-lived worker thread for \ref cluster_pthread.
+ *
+ * Each worker is started once, and then steps through the phases of the
+ * algorithm in lock-step with the other workers and the controlling thread via
+ * a shared \ref multithread::barrier, rather than a new thread being created
+ * for every phase.
+ */
 template <typename T>
 class pthread_worker : public multithread::threadable {
  public:
+  enum instruction { FIRST_TOUCH, UPDATE_CENTER, CLUSTER_POINTS };
+  struct instruction_data {
+    enum instruction type;
+    T* const data;
+    std::size_t* membership;
+  };
+
+  /**
+   * @brief State shared between the controlling thread and all workers, passed
+   * to \ref start().
+   *
+   * To run a phase, the controlling thread sets \a instr and then waits on \a
+   * step twice: once to release the workers, and once for them to finish. A
+   * NULL \a instr tells the workers to exit.
+   */
+  struct phase_control {
+    explicit phase_control(std::size_t n_workers) : step(n_workers + 1) {}
+
+    multithread::barrier step;
+    const instruction_data* instr{nullptr};
+  };
+
   pthread_worker(
       std::size_t id,
       std::size_t points_start,
@@ -65,37 +96,40 @@ class pthread_worker : public multithread::threadable {
             const_cast<boost::shared_ptr<std::vector<kmeans_cluster<T>*>>&>(
                 clusters)) {}
 
-  enum instruction { FIRST_TOUCH, UPDATE_CENTER, CLUSTER_POINTS };
-  struct instruction_data {
-    enum instruction type;
-    T* const data;
-    std::size_t* membership;
-  };
-
   void* thread_main(void* arg) {
-    ER_REPORT("%lu: points %lu - %lu, centers %lu - %lu\n",
-              m_id,
-              m_points_start,
-              m_points_start + m_points_size,
-              m_centers_start,
-              m_centers_start + m_centers_size);
     /*
-     * Lock each new invocation to a core--don't want the OS moving threads
-     * around.
+     * Lock each worker to a core--don't want the OS moving threads around.
      */
     threadm_core_lock(thread_handle(), m_id);
-    struct instruction_data* instr = (struct instruction_data*)arg;
+    auto* ctl = static_cast<phase_control*>(arg);
+
+    for (;;) {
+      ctl->step.wait();
+      if (nullptr == ctl->instr) {
+        break;
+      }
+      execute(*ctl->instr);
+      ctl->step.wait();
+    } /* for(;;) */
+    return NULL;
+  } /* kmeans_pthread_worker::thread_main() */
+
+ private:
+  pthread_worker& operator=(pthread_worker&) = delete;
 
-    if (FIRST_TOUCH == instr->type) {
+  /**
+   * @brief Do this worker's share of a single phase.
+   */
+  void execute(const instruction_data& instr) {
+    if (FIRST_TOUCH == instr.type) {
       for (std::size_t i = m_points_start; i < m_points_start + m_points_size;
            ++i) {
         for (std::size_t j = 0; j < m_dimension; ++j) {
-          instr->data[i * m_dimension + j] = 0;
+          instr.data[i * m_dimension + j] = 0;
         } /* for(j..) */
-        instr->membership[i] = -1;
+        instr.membership[i] = -1;
       } /* for(i...) */
-      return NULL;
-    } else if (UPDATE_CENTER == instr->type) {
+    } else if (UPDATE_CENTER == instr.type) {
       /*
        * Each thread is responsible for update the centers of clusters that fall
        * within a range based on the id of the thread
@@ -104,7 +138,6 @@ class pthread_worker : public multithread::threadable {
            ++i) {
         m_clusters->at(i)->update_center();
       } /* for(i..) */
-      return NULL;
     } else {
       /*
        * For each point in the data that is assigned to the current thread,
@@ -117,7 +150,7 @@ class pthread_worker : public multithread::threadable {
         double min_dist = std::numeric_limits<float>::max();
         for (std::size_t j = 0; j < m_clusters->size(); ++j) {
           double dist =
-              m_clusters->at(j)->dist_to_center(instr->data + i * m_dimension);
+              m_clusters->at(j)->dist_to_center(instr.data + i * m_dimension);
           if (dist < min_dist) {
             min_dist = dist;
             closest = j;
@@ -125,23 +158,8 @@ class pthread_worker : public multithread::threadable {
         } /* for(j..) */
         m_clusters->at(closest)->add_point(i);
       } /* for(i..) */
-
-      return NULL;
     }
-  } /* kmeans_pthread_worker::thread_main() */
-
-  pthread_worker(const pthread_worker& other)
-      : threadable(),
-        m_id(other.m_id),
-        m_points_start(other.m_points_start),
-        m_points_size(other.m_points_size),
-        m_centers_start(other.m_centers_start),
-        m_centers_size(other.m_centers_size),
-        m_dimension(other.m_dimension),
-        m_clusters(other.m_clusters) {}
-
- private:
-  pthread_worker& operator=(pthread_worker&) = delete;
+  } /* execute() */
 
   std::size_t m_id;
   std::size_t m_points_start;
@@ -0,0 +1,296 @@
+/**
+ * @file ipc_ring.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTIPROCESS_IPC_RING_HPP_
+#define INCLUDE_RCPPSW_MULTIPROCESS_IPC_RING_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <boost/interprocess/offset_ptr.hpp>
+#include <cstdint>
+#include <sched.h>
+#include <type_traits>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multiprocess/ipc.hpp"
+#include "rcppsw/multithread/futex.hpp"
+#include "rcppsw/multithread/overflow_policy.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multiprocess);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class ipc_ring
+ * @ingroup multiprocess
+ *
+ * @brief A bounded, lock-free multiple-producer/multiple-consumer ring buffer
+ * that lives in shared memory (like \ref multithread::mpsc_ring, but for
+ * processes).
+ *
+ * The ring must itself be constructed in a managed shared memory segment, and
+ * the slots are allocated from the same segment and referred to via an offset
+ * pointer, so it works no matter where the segment is mapped in each
+ * process. Synchronization is purely via atomics on 64 bit sequence numbers and
+ * indices, so elements must be trivially copyable, and neither side makes a
+ * system call on the fast path. Producers that find the ring full under \ref
+ * multithread::overflow_policy::BLOCK yield until there is room.
+ *
+ * A consumer can block waiting for data via \ref wait(), on a futex that is in
+ * the ring itself; producers only make a system call to wake it if it is
+ * actually asleep.
+ *
+ * A process that dies between claiming a slot and filling it will leave the
+ * ring stuck at that slot; consumers will see it as empty from then on.
+ */
+template <typename T>
+class ipc_ring {
+ public:
+  typedef ipc_allocator<T> allocator_type;
+
+  static_assert(std::is_trivially_copyable<T>::value,
+                "ipc_ring elements are copied between processes as raw bytes");
+  static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+                "ipc_ring needs address-free 64 bit atomics");
+  static_assert(ATOMIC_INT_LOCK_FREE == 2,
+                "ipc_ring needs address-free 32 bit atomics");
+
+  /**
+   * @param capacity Minimum # of elements the ring can hold. Rounded up to the
+   *                 next power of 2.
+   * @param policy What to do when a producer finds the ring full.
+   * @param alloc Allocator for the segment the ring is in.
+   */
+  ipc_ring(std::size_t capacity,
+           multithread::overflow_policy::value policy,
+           allocator_type alloc)
+      : mc_policy(policy),
+        mc_mask(round_pow2(capacity) - 1),
+        m_alloc(alloc),
+        m_slots(slot_allocator(alloc).allocate(mc_mask + 1)) {
+    for (uint64_t i = 0; i <= mc_mask; ++i) {
+      new (&m_slots[i]) slot();
+      m_slots[i].seq.store(i, std::memory_order_relaxed);
+    } /* for(i..) */
+  }
+
+  ~ipc_ring(void) {
+    slot_allocator(m_alloc).deallocate(m_slots, mc_mask + 1);
+  }
+
+  ipc_ring(const ipc_ring& other) = delete;
+  ipc_ring& operator=(const ipc_ring& other) = delete;
+
+  /**
+   * @brief Add an element to the ring, applying the overflow policy if the ring
+   * is full.
+   *
+   * @param data The element to add.
+   *
+   * @return \c TRUE if the element was added, \c FALSE if it was dropped.
+   */
+  bool enqueue(const T& data) {
+    while (!try_push(data)) {
+      if (multithread::overflow_policy::DROP_NEWEST == mc_policy) {
+        m_n_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else if (multithread::overflow_policy::OVERWRITE_OLDEST == mc_policy) {
+        if (try_dequeue(nullptr)) {
+          m_n_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+      } else {
+        sched_yield();
+      }
+    } /* while() */
+    return true;
+  }
+
+  /**
+   * @brief Remove the element at the front of the ring, if there is one.
+   *
+   * @param data To be filled with the front element (can be NULL to just
+   *             discard it).
+   *
+   * @return \c TRUE if an element was removed, \c FALSE if the ring was empty.
+   */
+  bool try_dequeue(T* const data) {
+    uint64_t pos = m_head.load(std::memory_order_relaxed);
+    slot* s = nullptr;
+    for (;;) {
+      s = &m_slots[pos & mc_mask];
+      uint64_t seq = s->seq.load(std::memory_order_acquire);
+      auto diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos + 1);
+      if (0 == diff) {
+        if (m_head.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_head.load(std::memory_order_relaxed);
+      }
+    } /* for(;;) */
+
+    if (nullptr != data) {
+      *data = s->data;
+    }
+    s->seq.store(pos + mc_mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Wait up to \a timeout_ms milliseconds for the front element of the
+   * ring to be ready, without removing anything.
+   *
+   * @return \c TRUE if the front element is ready, \c FALSE on timeout or if
+   * \ref wake() was called.
+   */
+  bool wait(std::size_t timeout_ms) {
+    if (front_ready()) {
+      return true;
+    }
+    uint32_t epoch = m_wake.load(std::memory_order_acquire);
+    m_consumer_waiting.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    /* re-check now that producers can see we are about to sleep */
+    if (!front_ready()) {
+      multithread::futex::wait_for(&m_wake, epoch, timeout_ms, true);
+    }
+    m_consumer_waiting.store(0, std::memory_order_relaxed);
+    return front_ready();
+  }
+
+  /**
+   * @brief Wake up a consumer blocked in \ref wait(), in any process, even if
+   * there is nothing in the ring (used to signal termination).
+   */
+  void wake(void) {
+    m_wake.fetch_add(1, std::memory_order_release);
+    multithread::futex::wake_all(&m_wake, true);
+  }
+
+  /**
+   * @brief Get the # of elements currently in the ring. Only approximate if
+   * there are concurrent producers/consumers.
+   */
+  std::size_t size(void) const {
+    uint64_t tail = m_tail.load(std::memory_order_acquire);
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    return (tail > head) ? tail - head : 0;
+  }
+  bool empty(void) const { return 0 == size(); }
+  std::size_t capacity(void) const { return mc_mask + 1; }
+
+  /**
+   * @brief Get the # of elements discarded because of the overflow policy since
+   * the ring was created, by all processes.
+   */
+  uint64_t n_dropped(void) const {
+    return m_n_dropped.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr std::size_t kCACHE_LINE = 64;
+
+  struct slot {
+    slot(void) : seq(0), data() {}
+    std::atomic<uint64_t> seq;
+    T data;
+  };
+  typedef bip::allocator<slot, bip::managed_shared_memory::segment_manager>
+      slot_allocator;
+
+  static uint64_t round_pow2(std::size_t n) {
+    uint64_t ret = 2;
+    while (ret < n) {
+      ret <<= 1;
+    } /* while() */
+    return ret;
+  }
+
+  bool try_push(const T& data) {
+    uint64_t pos = m_tail.load(std::memory_order_relaxed);
+    slot* s = nullptr;
+    for (;;) {
+      s = &m_slots[pos & mc_mask];
+      uint64_t seq = s->seq.load(std::memory_order_acquire);
+      auto diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+      if (0 == diff) {
+        if (m_tail.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    } /* for(;;) */
+
+    s->data = data;
+    s->seq.store(pos + 1, std::memory_order_release);
+    notify_consumer();
+    return true;
+  }
+
+  /**
+   * @brief Determine if the element at the front of the ring has been filled
+   * in (a producer that died before filling in its slot leaves the ring
+   * looking empty, rather than non-empty but stuck).
+   */
+  bool front_ready(void) const {
+    uint64_t pos = m_head.load(std::memory_order_acquire);
+    return m_slots[pos & mc_mask].seq.load(std::memory_order_acquire) ==
+           pos + 1;
+  }
+
+  void notify_consumer(void) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (0 != m_consumer_waiting.load(std::memory_order_relaxed)) {
+      wake();
+    }
+  }
+
+  /* data members */
+  const multithread::overflow_policy::value mc_policy;
+  const uint64_t mc_mask;
+  allocator_type m_alloc;
+  bip::offset_ptr<slot> m_slots;
+
+  char m_pad0[kCACHE_LINE]{};
+  std::atomic<uint64_t> m_tail{0};
+  char m_pad1[kCACHE_LINE - sizeof(std::atomic<uint64_t>)]{};
+  std::atomic<uint64_t> m_head{0};
+  char m_pad2[kCACHE_LINE - sizeof(std::atomic<uint64_t>)]{};
+  std::atomic<uint64_t> m_n_dropped{0};
+  std::atomic<uint32_t> m_wake{0};
+  std::atomic<uint32_t> m_consumer_waiting{0};
+};
+
+NS_END(multiprocess, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTIPROCESS_IPC_RING_HPP_ */
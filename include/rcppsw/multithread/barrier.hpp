@@ -0,0 +1,84 @@
+/**
+ * @file barrier.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_BARRIER_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_BARRIER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <cstdint>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class barrier
+ * @ingroup multithread
+ *
+ * @brief A reusable barrier for a fixed # of threads.
+ *
+ * Sense-reversing: the last thread to arrive resets the count and flips the
+ * sense (here a generation counter, so it can never be confused with the sense
+ * of a phase two generations ago), which releases everyone waiting on the old
+ * generation. Waiters spin briefly, since in lock-step workloads the other
+ * threads are usually close behind, and then sleep on a futex. The futex is
+ * only woken if someone actually went to sleep.
+ */
+class barrier {
+ public:
+  /**
+   * @param n_threads The # of threads that must call \ref wait() for any of
+   *                  them to proceed.
+   */
+  explicit barrier(std::size_t n_threads);
+
+  barrier(const barrier& other) = delete;
+  barrier& operator=(const barrier& other) = delete;
+
+  /**
+   * @brief Wait for all threads to arrive at the barrier.
+   *
+   * @return \c TRUE for exactly one of the threads each time the barrier
+   * opens (the last one to arrive), so it can do any serial work between
+   * phases; \c FALSE for the rest.
+   */
+  bool wait(void);
+
+  std::size_t n_threads(void) const { return mc_n_threads; }
+
+ private:
+  /* data members */
+  const uint32_t mc_n_threads;
+  std::atomic<uint32_t> m_remaining;
+  std::atomic<uint32_t> m_generation{0};
+  std::atomic<uint32_t> m_n_sleeping{0};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_BARRIER_HPP_ */
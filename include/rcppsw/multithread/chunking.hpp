@@ -0,0 +1,60 @@
+/**
+ * @file chunking.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_CHUNKING_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_CHUNKING_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class chunking
+ * @ingroup multithread
+ *
+ * @brief How the chunks of a \ref range are handed out to threads by the
+ * parallel algorithms (\ref parallel_for(), etc.).
+ *
+ * STATIC: Each thread gets one contiguous block of chunks, decided up front.
+ *         No coordination at all while running, and each thread touches the
+ *         same data on every call (good for first-touch NUMA placement), but
+ *         the slowest thread determines the run time.
+ *
+ * DYNAMIC: Threads take the next chunk from a shared atomic counter as they
+ *          finish the last one. Balances uneven work at the cost of one atomic
+ *          increment per chunk.
+ */
+class chunking {
+ public:
+  enum value { STATIC, DYNAMIC };
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_CHUNKING_HPP_ */
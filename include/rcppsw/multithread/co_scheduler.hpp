@@ -0,0 +1,289 @@
+/**
+ * @file co_scheduler.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_CO_SCHEDULER_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_CO_SCHEDULER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multithread/co_task.hpp"
+
+/*
+ * Coroutine support is only available when compiling as C++20; in earlier
+ * modes this header is empty.
+ */
+#if defined(__cpp_impl_coroutine)
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cassert>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "rcppsw/multithread/mt_queue.hpp"
+#include "rcppsw/multithread/threadable.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class co_scheduler
+ * @ingroup multithread
+ *
+ * @brief Runs \ref co_task coroutines on a single thread, so that thousands of
+ * lightweight activities (e.g. simulated agents) can each wait on events
+ * without holding an OS thread apiece.
+ *
+ * A coroutine suspends by co_await-ing one of the awaitables returned by the
+ * scheduler, and is made ready again when the event happens: a timer expires
+ * (\ref sleep_for()), an element arrives on an \ref mt_queue (\ref dequeue()),
+ * or a \ref threadable finishes (\ref join()). Events can come from any
+ * thread; they just queue the coroutine, and the thread in \ref run() resumes
+ * it.
+ */
+class co_scheduler {
+ public:
+  typedef std::chrono::steady_clock clock_type;
+
+  co_scheduler(void) = default;
+
+  /**
+   * @brief Frees any unfinished coroutines that are ready to run or waiting on
+   * a timer.
+   *
+   * Coroutines parked in \ref dequeue() or \ref join() cannot be freed: the
+   * queue/thread holds a callback that refers to both the coroutine and the
+   * scheduler. Such coroutines must have been woken (and run) before the
+   * scheduler is destroyed.
+   */
+  ~co_scheduler(void) {
+    assert(0 == m_n_parked);
+    for (auto h : m_ready) {
+      h.destroy();
+    } /* for(h..) */
+    while (!m_timers.empty()) {
+      std::get<2>(m_timers.top()).destroy();
+      m_timers.pop();
+    } /* while() */
+  }
+
+  co_scheduler(const co_scheduler& other) = delete;
+  co_scheduler& operator=(const co_scheduler& other) = delete;
+
+  /**
+   * @brief Add a coroutine to be run. Thread safe.
+   */
+  void spawn(co_task task) {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    ++m_n_live;
+    m_ready.push_back(task.release());
+    m_cv.notify_one();
+  }
+
+  /**
+   * @brief Make a suspended coroutine ready to run again. Thread safe.
+   */
+  void post(std::coroutine_handle<> h) {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    m_ready.push_back(h);
+    m_cv.notify_one();
+  }
+
+  /**
+   * @brief Run coroutines until all of them have finished.
+   */
+  void run(void) {
+    boost::unique_lock<boost::mutex> lock(m_mtx);
+    while (m_n_live > 0) {
+      timers_expire(clock_type::now());
+      if (!m_ready.empty()) {
+        std::coroutine_handle<> h = m_ready.front();
+        m_ready.pop_front();
+        lock.unlock();
+        h.resume();
+        bool done = h.done();
+        if (done) {
+          h.destroy();
+        }
+        lock.lock();
+        m_n_live -= done ? 1 : 0;
+      } else if (!m_timers.empty()) {
+        auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::get<0>(m_timers.top()) - clock_type::now());
+        m_cv.timed_wait(lock,
+                        boost::posix_time::microseconds(remaining.count() + 1));
+      } else {
+        m_cv.wait(lock);
+      }
+    } /* while() */
+  } /* run() */
+
+  /**
+   * @brief Get the # of coroutines that have been spawned but not finished.
+   */
+  std::size_t n_live(void) const {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    return m_n_live;
+  }
+
+  /**
+   * @brief Awaitable that suspends the coroutine for (at least) \a duration.
+   */
+  struct sleep_awaiter {
+    co_scheduler* sched;
+    clock_type::time_point deadline;
+
+    bool await_ready(void) const { return deadline <= clock_type::now(); }
+    void await_suspend(std::coroutine_handle<> h) { sched->timer_add(deadline, h); }
+    void await_resume(void) const {}
+  };
+  template <typename Rep, typename Period>
+  sleep_awaiter sleep_for(std::chrono::duration<Rep, Period> duration) {
+    return sleep_awaiter{this, clock_type::now() + duration};
+  }
+
+  /**
+   * @brief Awaitable that lets other ready coroutines run before continuing.
+   */
+  struct yield_awaiter {
+    co_scheduler* sched;
+
+    bool await_ready(void) const { return false; }
+    void await_suspend(std::coroutine_handle<> h) { sched->post(h); }
+    void await_resume(void) const {}
+  };
+  yield_awaiter yield(void) { return yield_awaiter{this}; }
+
+  /**
+   * @brief Awaitable that removes the front element from a queue, suspending
+   * the coroutine until there is one. Resolves to the element.
+   */
+  template <typename T>
+  struct dequeue_awaiter {
+    co_scheduler* sched;
+    mt_queue<T>* queue;
+    std::optional<T> data{};
+
+    bool await_ready(void) {
+      T tmp;
+      if (queue->try_dequeue(&tmp)) {
+        data.emplace(std::move(tmp));
+        return true;
+      }
+      return false;
+    }
+    void await_suspend(std::coroutine_handle<> h) {
+      sched->park();
+      queue->dequeue_async([this, h](T in) {
+        data.emplace(std::move(in));
+        sched->unpark(h);
+      });
+    }
+    T await_resume(void) { return std::move(*data); }
+  };
+  template <typename T>
+  dequeue_awaiter<T> dequeue(mt_queue<T>& queue) {
+    return dequeue_awaiter<T>{this, &queue};
+  }
+
+  /**
+   * @brief Awaitable that suspends the coroutine until a thread finishes, and
+   * then joins it. The thread must have been started.
+   */
+  struct join_awaiter {
+    co_scheduler* sched;
+    threadable* thread;
+
+    bool await_ready(void) const {
+      assert(thread->started());
+      return thread->exited();
+    }
+    void await_suspend(std::coroutine_handle<> h) {
+      auto* s = sched;
+      s->park();
+      thread->on_exit([s, h]() { s->unpark(h); });
+    }
+    void await_resume(void) const { thread->join(); }
+  };
+  join_awaiter join(threadable& thread) { return join_awaiter{this, &thread}; }
+
+ private:
+  typedef std::tuple<clock_type::time_point, uint64_t, std::coroutine_handle<>>
+      timer_type;
+
+  void timer_add(clock_type::time_point deadline, std::coroutine_handle<> h) {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    m_timers.emplace(deadline, m_timer_seq++, h);
+  }
+
+  /*
+   * Track coroutines suspended on an event outside the scheduler; must be
+   * called before handing out the callback that will unpark them.
+   */
+  void park(void) {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    ++m_n_parked;
+  }
+  void unpark(std::coroutine_handle<> h) {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    --m_n_parked;
+    m_ready.push_back(h);
+    m_cv.notify_one();
+  }
+
+  /* must be called with the lock held */
+  void timers_expire(clock_type::time_point now) {
+    while (!m_timers.empty() && std::get<0>(m_timers.top()) <= now) {
+      m_ready.push_back(std::get<2>(m_timers.top()));
+      m_timers.pop();
+    } /* while() */
+  }
+
+  /* data members */
+  mutable boost::mutex m_mtx{};
+  boost::condition_variable m_cv{};
+  std::deque<std::coroutine_handle<>> m_ready{};
+  /* earliest deadline on top; the sequence # keeps equal deadlines FIFO */
+  std::priority_queue<timer_type, std::vector<timer_type>, std::greater<timer_type>>
+      m_timers{};
+  uint64_t m_timer_seq{0};
+  std::size_t m_n_live{0};
+  std::size_t m_n_parked{0};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* __cpp_impl_coroutine */
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_CO_SCHEDULER_HPP_ */
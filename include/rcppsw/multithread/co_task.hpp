@@ -0,0 +1,112 @@
+/**
+ * @file co_task.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_CO_TASK_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_CO_TASK_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/common/common.hpp"
+
+/*
+ * Coroutine support is only available when compiling as C++20; in earlier
+ * modes this header is empty.
+ */
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class co_task
+ * @ingroup multithread
+ *
+ * @brief The return type of a coroutine that is run by a \ref co_scheduler,
+ * e.g.:
+ *
+ * \code
+ * co_task agent(co_scheduler& sched, mt_queue<event>& inbox) {
+ *   for (;;) {
+ *     event e = co_await sched.dequeue(inbox);
+ *     ...
+ *     co_await sched.sleep_for(std::chrono::milliseconds(10));
+ *   }
+ * }
+ * sched.spawn(agent(sched, inbox));
+ * \endcode
+ *
+ * The coroutine does not start until it is spawned, and its frame is freed by
+ * the scheduler when it finishes. Exceptions escaping the coroutine terminate
+ * the program, as with \ref thread_pool tasks.
+ */
+class co_task {
+ public:
+  struct promise_type {
+    co_task get_return_object(void) {
+      return co_task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend(void) noexcept { return {}; }
+    std::suspend_always final_suspend(void) noexcept { return {}; }
+    void return_void(void) {}
+    void unhandled_exception(void) { std::terminate(); }
+  };
+
+  co_task(co_task&& other) noexcept
+      : m_handle(std::exchange(other.m_handle, nullptr)) {}
+  co_task(const co_task& other) = delete;
+  co_task& operator=(const co_task& other) = delete;
+
+  /**
+   * @brief Frees the coroutine if it was never spawned.
+   */
+  ~co_task(void) {
+    if (m_handle) {
+      m_handle.destroy();
+    }
+  }
+
+  /**
+   * @brief Give up ownership of the coroutine (to the scheduler).
+   */
+  std::coroutine_handle<> release(void) {
+    return std::exchange(m_handle, nullptr);
+  }
+
+ private:
+  explicit co_task(std::coroutine_handle<promise_type> handle)
+      : m_handle(handle) {}
+
+  std::coroutine_handle<promise_type> m_handle;
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* __cpp_impl_coroutine */
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_CO_TASK_HPP_ */
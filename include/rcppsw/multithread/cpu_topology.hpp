@@ -0,0 +1,124 @@
+/**
+ * @file cpu_topology.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_CPU_TOPOLOGY_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_CPU_TOPOLOGY_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <string>
+#include <vector>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class cpu_topology
+ * @ingroup multithread
+ *
+ * @brief The layout of the online CPUs in the machine: which physical core,
+ * socket (package) and NUMA node each one belongs to, as read from sysfs.
+ *
+ * If sysfs cannot be read, the machine is treated as a single node/socket with
+ * one core per hardware thread.
+ */
+class cpu_topology {
+ public:
+  struct cpu {
+    int id;      /// The logical CPU # (what affinity masks use).
+    int core;    /// The physical core ID within the package.
+    int package; /// The socket.
+    int node;    /// The NUMA node.
+    int smt;     /// Which hardware thread of its core this is (0 = first).
+  };
+
+  /**
+   * @brief Where the CPU and NUMA node directories live in sysfs.
+   */
+  static constexpr const char* kSYSFS_ROOT = "/sys/devices/system";
+
+  /**
+   * @param sysfs_root The directory containing the cpu/ and node/
+   *                   directories.
+   */
+  explicit cpu_topology(const std::string& sysfs_root = kSYSFS_ROOT);
+
+  /**
+   * @brief Get the topology of the machine we are running on, discovered on
+   * first use.
+   */
+  static const cpu_topology& instance(void);
+
+  /**
+   * @brief Parse a sysfs CPU/node list, such as "0-3,8,10-11".
+   *
+   * @return The listed #s, in order (empty if the list is malformed).
+   */
+  static std::vector<int> list_parse(const std::string& list);
+
+  /**
+   * @brief Get all online CPUs, sorted by ID.
+   */
+  const std::vector<cpu>& cpus(void) const { return m_cpus; }
+
+  /**
+   * @brief Get the IDs of the NUMA nodes that have CPUs, sorted.
+   */
+  const std::vector<int>& nodes(void) const { return m_nodes; }
+
+  std::size_t n_packages(void) const { return m_n_packages; }
+
+  /**
+   * @brief Get the CPUs on \a node, sorted by ID.
+   */
+  std::vector<cpu> node_cpus(int node) const;
+
+  /**
+   * @brief Get the NUMA node that \a cpu_id is on (-1 if it is not online).
+   */
+  int node_of(int cpu_id) const;
+
+  /**
+   * @brief Determine if the topology was actually read from sysfs, rather
+   * than guessed.
+   */
+  bool discovered(void) const { return m_discovered; }
+
+ private:
+  status_t discover(const std::string& sysfs_root);
+  void fallback(void);
+
+  /* data members */
+  std::vector<cpu> m_cpus{};
+  std::vector<int> m_nodes{};
+  std::size_t m_n_packages{0};
+  bool m_discovered{false};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_CPU_TOPOLOGY_HPP_ */
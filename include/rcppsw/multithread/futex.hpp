@@ -0,0 +1,141 @@
+/**
+ * @file futex.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_FUTEX_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_FUTEX_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class futex
+ * @ingroup multithread
+ *
+ * @brief Thin wrappers around the Linux futex syscall for blocking on a 32-bit
+ * atomic, plus spinning on one before blocking, for synchronization primitives
+ * where the wait is usually short.
+ */
+class futex {
+ public:
+  /**
+   * @brief # of rounds to spin for in \ref spin_wait() by default, roughly a
+   * few microseconds on current hardware.
+   */
+  static constexpr std::size_t kSPIN_ROUNDS = 2048;
+
+  /**
+   * @brief Block until woken, if \a word still holds \a val (checked
+   * atomically with going to sleep). May return spuriously.
+   *
+   * @param shared \c TRUE if \a word is in memory shared between processes.
+   */
+  static void wait(std::atomic<uint32_t>* const word,
+                   uint32_t val,
+                   bool shared = false) {
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(word),
+            shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE,
+            val,
+            nullptr,
+            nullptr,
+            0);
+  }
+
+  /**
+   * @brief As \ref wait(), but give up after \a timeout_ms milliseconds.
+   */
+  static void wait_for(std::atomic<uint32_t>* const word,
+                       uint32_t val,
+                       std::size_t timeout_ms,
+                       bool shared = false) {
+    struct timespec timeout;
+    timeout.tv_sec = static_cast<time_t>(timeout_ms / 1000);
+    timeout.tv_nsec = static_cast<long>((timeout_ms % 1000) * 1000000);
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(word),
+            shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE,
+            val,
+            &timeout,
+            nullptr,
+            0);
+  }
+
+  /**
+   * @brief Wake up all threads blocked in \ref wait() or \ref wait_for() on
+   * \a word.
+   */
+  static void wake_all(std::atomic<uint32_t>* const word,
+                       bool shared = false) {
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(word),
+            shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE,
+            INT_MAX,
+            nullptr,
+            nullptr,
+            0);
+  }
+
+  /**
+   * @brief Spin while \a word holds \a val, for at most \a rounds rounds.
+   *
+   * @return \c TRUE if \a word changed, \c FALSE if we gave up.
+   */
+  static bool spin_wait(const std::atomic<uint32_t>* const word,
+                        uint32_t val,
+                        std::size_t rounds = kSPIN_ROUNDS) {
+    for (std::size_t i = 0; i < rounds; ++i) {
+      if (word->load(std::memory_order_acquire) != val) {
+        return true;
+      }
+      relax();
+    } /* for(i..) */
+    return false;
+  }
+
+  /**
+   * @brief Tell the CPU we are in a spin loop.
+   */
+  static void relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+  }
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_FUTEX_HPP_ */
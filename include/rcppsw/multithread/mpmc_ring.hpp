@@ -0,0 +1,199 @@
+/**
+ * @file mpmc_ring.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_MPMC_RING_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_MPMC_RING_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class mpmc_ring
+ * @ingroup multithread
+ *
+ * @brief A bounded, lock-free multiple-producer/multiple-consumer ring buffer.
+ *
+ * Each slot carries a sequence number that tells producers and consumers
+ * whether it is free or full for the current lap around the ring, so the only
+ * contended operation is a CAS on the head/tail index. The capacity is rounded
+ * up to the next power of 2.
+ *
+ * Has the same non-blocking interface as \ref spsc_ring and \ref mt_queue
+ * (try_enqueue(), try_dequeue(), size(), empty(), capacity()), so that a
+ * pipeline stage can be templated on the queue type.
+ */
+template <typename T>
+class mpmc_ring {
+ public:
+  /**
+   * @param capacity Minimum # of elements the ring can hold.
+   */
+  explicit mpmc_ring(std::size_t capacity)
+      : mc_mask(round_pow2(capacity) - 1), m_slots(new slot[mc_mask + 1]) {
+    for (std::size_t i = 0; i <= mc_mask; ++i) {
+      m_slots[i].seq.store(i, std::memory_order_relaxed);
+    } /* for(i..) */
+  }
+
+  ~mpmc_ring(void) {
+    while (try_dequeue(nullptr)) {
+    }
+  }
+
+  mpmc_ring(const mpmc_ring& other) = delete;
+  mpmc_ring& operator=(const mpmc_ring& other) = delete;
+
+  /**
+   * @brief Add an element to the ring if there is room for it.
+   *
+   * @return \c TRUE if the element was added, \c FALSE if the ring was full
+   * (in which case \a data is not moved from).
+   */
+  bool try_enqueue(const T& data) { return push(data); }
+  bool try_enqueue(T&& data) { return push(std::move(data)); }
+
+  /**
+   * @brief Remove the element at the front of the ring, if there is one.
+   *
+   * @param data To be filled with the front element. If NULL, the element is
+   *             just destroyed.
+   *
+   * @return \c TRUE if an element was removed, \c FALSE if the ring was empty.
+   */
+  bool try_dequeue(T* const data) {
+    std::size_t pos = m_head.load(std::memory_order_relaxed);
+    slot* s = nullptr;
+    for (;;) {
+      s = &m_slots[pos & mc_mask];
+      std::size_t seq = s->seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::intptr_t>(seq) -
+                  static_cast<std::intptr_t>(pos + 1);
+      if (0 == diff) {
+        if (m_head.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_head.load(std::memory_order_relaxed);
+      }
+    } /* for(;;) */
+
+    T* elt = s->elt();
+    if (nullptr != data) {
+      *data = std::move(*elt);
+    }
+    elt->~T();
+    s->seq.store(pos + mc_mask + 1, std::memory_order_release);
+    return true;
+  } /* try_dequeue() */
+
+  /**
+   * @brief Get the # of elements currently in the ring. Only approximate if
+   * there are concurrent producers/consumers.
+   */
+  std::size_t size(void) const {
+    std::size_t tail = m_tail.load(std::memory_order_acquire);
+    std::size_t head = m_head.load(std::memory_order_acquire);
+    return (tail > head) ? tail - head : 0;
+  }
+  bool empty(void) const { return 0 == size(); }
+  std::size_t capacity(void) const { return mc_mask + 1; }
+
+ private:
+  /**
+   * @brief The size of a cache line on the platforms we care about, used to
+   * keep the producer and consumer indices from false sharing.
+   */
+  static constexpr std::size_t kCACHE_LINE = 64;
+
+  struct slot {
+    slot(void) : seq(0), storage() {}
+    T* elt(void) { return reinterpret_cast<T*>(&storage); }
+
+    std::atomic<std::size_t> seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  static std::size_t round_pow2(std::size_t n) {
+    std::size_t ret = 2;
+    while (ret < n) {
+      ret <<= 1;
+    } /* while() */
+    return ret;
+  }
+
+  template <typename U>
+  bool push(U&& data) {
+    std::size_t pos = m_tail.load(std::memory_order_relaxed);
+    slot* s = nullptr;
+    for (;;) {
+      s = &m_slots[pos & mc_mask];
+      std::size_t seq = s->seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::intptr_t>(seq) -
+                  static_cast<std::intptr_t>(pos);
+      if (0 == diff) {
+        if (m_tail.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    } /* for(;;) */
+
+    new (&s->storage) T(std::forward<U>(data));
+    s->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  } /* push() */
+
+  /* data members */
+  const std::size_t mc_mask;
+  std::unique_ptr<slot[]> m_slots;
+
+  char m_pad0[kCACHE_LINE]{};
+  std::atomic<std::size_t> m_tail{0};
+  char m_pad1[kCACHE_LINE - sizeof(std::atomic<std::size_t>)]{};
+  std::atomic<std::size_t> m_head{0};
+  char m_pad2[kCACHE_LINE - sizeof(std::atomic<std::size_t>)]{};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_MPMC_RING_HPP_ */
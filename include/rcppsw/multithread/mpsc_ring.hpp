@@ -0,0 +1,253 @@
+/**
+ * @file mpsc_ring.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_MPSC_RING_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_MPSC_RING_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <boost/thread.hpp>
+#include <boost/thread/locks.hpp>
+#include <cstdint>
+#include <utility>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multithread/mpmc_ring.hpp"
+#include "rcppsw/multithread/overflow_policy.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class mpsc_ring
+ * @ingroup multithread
+ *
+ * @brief A bounded, lock-free multiple-producer/single-consumer ring buffer
+ * with overflow policies and blocking waits, built on \ref mpmc_ring. The
+ * capacity is rounded up to the next power of 2.
+ *
+ * The consumer can block waiting for data via \ref wait_dequeue(). Producers
+ * only touch the mutex/condition variable pair if the consumer is actually
+ * asleep, so the common case of enqueueing into a busy ring does not lock.
+ *
+ * Dequeueing also uses a CAS, so it is safe for a second thread to drain the
+ * ring (e.g. during a flush), and for producers to evict the oldest element
+ * under \ref overflow_policy::OVERWRITE_OLDEST.
+ */
+template <typename T>
+class mpsc_ring {
+ public:
+  /**
+   * @param capacity Minimum # of elements the ring can hold.
+   * @param policy What to do when a producer finds the ring full.
+   */
+  explicit mpsc_ring(std::size_t capacity,
+                     overflow_policy::value policy = overflow_policy::BLOCK)
+      : mc_policy(policy), m_ring(capacity) {}
+
+  mpsc_ring(const mpsc_ring& other) = delete;
+  mpsc_ring& operator=(const mpsc_ring& other) = delete;
+
+  /**
+   * @brief Add an element to the ring, applying the overflow policy if the ring
+   * is full.
+   *
+   * @param data The element to add.
+   *
+   * @return \c TRUE if the element was added, \c FALSE if it was dropped.
+   */
+  bool enqueue(T data) {
+    return enqueue(std::move(data), [](const T&) {});
+  }
+
+  /**
+   * @brief Add an element to the ring, applying the overflow policy if the ring
+   * is full, and telling the caller about each element that is discarded as a
+   * result.
+   *
+   * @param data The element to add.
+   * @param on_drop Callable invoked with each discarded element: \a data under
+   *                \ref overflow_policy::DROP_NEWEST, the evicted element(s)
+   *                under \ref overflow_policy::OVERWRITE_OLDEST.
+   *
+   * @return \c TRUE if the element was added, \c FALSE if it was dropped.
+   */
+  template <typename F>
+  bool enqueue(T data, F on_drop) {
+    while (!m_ring.try_enqueue(std::move(data))) {
+      if (overflow_policy::DROP_NEWEST == mc_policy) {
+        m_n_dropped.fetch_add(1, std::memory_order_relaxed);
+        on_drop(data);
+        return false;
+      } else if (overflow_policy::OVERWRITE_OLDEST == mc_policy) {
+        T evicted;
+        if (pop(&evicted)) {
+          m_n_dropped.fetch_add(1, std::memory_order_relaxed);
+          on_drop(evicted);
+        }
+      } else {
+        wait_not_full();
+      }
+    } /* while() */
+    notify_consumer();
+    return true;
+  }
+
+  /**
+   * @brief Remove the element at the front of the ring, if there is one.
+   *
+   * @param data To be filled with the front element.
+   *
+   * @return \c TRUE if an element was removed, \c FALSE if the ring was empty.
+   */
+  bool try_dequeue(T* const data) { return pop(data); }
+
+  /**
+   * @brief Remove the element at the front of the ring, waiting up to \a
+   * timeout_ms milliseconds for one to become available.
+   *
+   * @param data To be filled with the front element.
+   * @param timeout_ms How long to wait before giving up.
+   *
+   * @return \c TRUE if an element was removed, \c FALSE on timeout or if \ref
+   * wake() was called.
+   */
+  bool wait_dequeue(T* const data, std::size_t timeout_ms) {
+    if (try_dequeue(data)) {
+      return true;
+    }
+    wait(timeout_ms);
+    return try_dequeue(data);
+  }
+
+  /**
+   * @brief Wait up to \a timeout_ms milliseconds for the ring to be non-empty,
+   * without removing anything, so the consumer can dequeue under a lock of its
+   * own.
+   *
+   * @return \c TRUE if the ring is non-empty, \c FALSE on timeout or if \ref
+   * wake() was called.
+   */
+  bool wait(std::size_t timeout_ms) {
+    if (!empty()) {
+      return true;
+    }
+    {
+      boost::unique_lock<boost::mutex> lock(m_mtx);
+      m_consumer_waiting.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      /* re-check now that producers can see we are about to sleep */
+      if (empty()) {
+        m_not_empty.timed_wait(lock,
+                               boost::posix_time::milliseconds(timeout_ms));
+      }
+      m_consumer_waiting.store(false, std::memory_order_relaxed);
+    }
+    return !empty();
+  }
+
+  /**
+   * @brief Wake up the consumer if it is blocked in \ref wait_dequeue(), even if
+   * there is nothing in the ring (used to signal termination).
+   */
+  void wake(void) {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    m_not_empty.notify_all();
+  }
+
+  /**
+   * @brief Get the # of elements currently in the ring. Only approximate if
+   * there are concurrent producers/consumers.
+   */
+  std::size_t size(void) const { return m_ring.size(); }
+  bool empty(void) const { return m_ring.empty(); }
+  std::size_t capacity(void) const { return m_ring.capacity(); }
+  overflow_policy::value policy(void) const { return mc_policy; }
+
+  /**
+   * @brief Get the # of elements discarded because of the overflow policy since
+   * the ring was created.
+   */
+  uint64_t n_dropped(void) const {
+    return m_n_dropped.load(std::memory_order_relaxed);
+  }
+
+ private:
+  /**
+   * @brief Remove the front element, moving it into \a data, or just
+   * destroying it if \a data is NULL, and wake up any producers blocked on the
+   * ring being full.
+   */
+  bool pop(T* const data) {
+    if (!m_ring.try_dequeue(data)) {
+      return false;
+    }
+    if (m_n_blocked.load(std::memory_order_acquire) > 0) {
+      boost::lock_guard<boost::mutex> lock(m_mtx);
+      m_not_full.notify_all();
+    }
+    return true;
+  }
+
+  void notify_consumer(void) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_consumer_waiting.load(std::memory_order_relaxed)) {
+      boost::lock_guard<boost::mutex> lock(m_mtx);
+      m_not_empty.notify_one();
+    }
+  }
+
+  void wait_not_full(void) {
+    m_n_blocked.fetch_add(1, std::memory_order_acq_rel);
+    {
+      boost::unique_lock<boost::mutex> lock(m_mtx);
+      if (size() >= capacity()) {
+        /*
+         * Timed wait so that a dequeue racing with our check of size() cannot
+         * leave us asleep forever.
+         */
+        m_not_full.timed_wait(lock, boost::posix_time::milliseconds(1));
+      }
+    }
+    m_n_blocked.fetch_sub(1, std::memory_order_acq_rel);
+  }
+
+  /* data members */
+  const overflow_policy::value mc_policy;
+  mpmc_ring<T> m_ring;
+
+  std::atomic<uint64_t> m_n_dropped{0};
+  std::atomic<std::size_t> m_n_blocked{0};
+  std::atomic<bool> m_consumer_waiting{false};
+  boost::mutex m_mtx{};
+  boost::condition_variable m_not_empty{};
+  boost::condition_variable m_not_full{};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_MPSC_RING_HPP_ */
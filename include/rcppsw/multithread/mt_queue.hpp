@@ -26,7 +26,11 @@
  ******************************************************************************/
 #include <boost/thread.hpp>
 #include <boost/thread/locks.hpp>
+#include <algorithm>
 #include <deque>
+#include <functional>
+#include <utility>
+#include <vector>
 #include "rcppsw/common/common.hpp"
 
 /*******************************************************************************
@@ -42,57 +46,319 @@ NS_START(rcppsw, multithread);
  * @ingroup multithread
  *
  * @brief A simple multiple-producer/consumer queue with locking.
+ *
+ * The queue can optionally be bounded, in which case producers block (or fail,
+ * for the try_/wait_ variants) when it is full, so that a slow consumer cannot
+ * make it grow without limit. Elements are moved in and out, so move-only
+ * types are supported. The bulk operations move as many elements as possible
+ * per lock acquisition/wakeup, which is much cheaper than one at a time when
+ * the queue is busy.
+ *
+ * Consumers that cannot block (e.g. coroutines) can use \ref dequeue_async()
+ * to have the next element handed to a callback instead.
  */
 template <typename T>
 class mt_queue {
  public:
-  mt_queue(void) : m_queue(), m_mtx(), m_cv() {}
+  /**
+   * @brief Capacity value meaning the queue can grow without limit.
+   */
+  static constexpr std::size_t kUNBOUNDED = 0;
+
+  typedef std::function<void(T)> async_cb_type;
+
+  /**
+   * @param capacity Max # of elements in the queue, or \ref kUNBOUNDED.
+   */
+  explicit mt_queue(std::size_t capacity = kUNBOUNDED)
+      : mc_capacity(capacity),
+        m_queue(),
+        m_mtx(),
+        m_not_empty(),
+        m_not_full(),
+        m_async() {}
+
+  mt_queue(const mt_queue& other) = delete;
+  mt_queue& operator=(const mt_queue& other) = delete;
 
   using const_iterator = typename std::deque<T>::const_iterator;
 
-  typename std::deque<T>::const_iterator begin(void) const {
-    return m_queue.begin();
+  /*
+   * Iteration and indexing do not lock, and are only safe when no other
+   * threads are using the queue.
+   */
+  const_iterator begin(void) const { return m_queue.begin(); }
+  const_iterator end(void) const { return m_queue.end(); }
+  const T& operator[](std::size_t pos) const { return m_queue[pos]; }
+
+  /**
+   * @brief Add data to the queue and notify others, waiting for room if the
+   * queue is bounded and full.
+   */
+  void enqueue(const T& data) { push(data, nullptr); }
+  void enqueue(T&& data) { push(std::move(data), nullptr); }
+
+  /**
+   * @brief Add data to the queue if there is room for it.
+   *
+   * @return \c TRUE if the data was added, \c FALSE if the queue was full (in
+   * which case \a data is not moved from).
+   */
+  bool try_enqueue(const T& data) { return push(data, &kNO_WAIT); }
+  bool try_enqueue(T&& data) { return push(std::move(data), &kNO_WAIT); }
+
+  /**
+   * @brief Add data to the queue, waiting up to \a timeout_ms milliseconds for
+   * there to be room for it.
+   *
+   * @return \c TRUE if the data was added, \c FALSE on timeout (in which case
+   * \a data is not moved from).
+   */
+  bool wait_enqueue(const T& data, std::size_t timeout_ms) {
+    return push(data, &timeout_ms);
   }
-  typename std::deque<T>::const_iterator end(void) const {
-    return m_queue.end();
+  bool wait_enqueue(T&& data, std::size_t timeout_ms) {
+    return push(std::move(data), &timeout_ms);
   }
 
   /**
-   * @brief Add data to the queue and notify others
+   * @brief Move all elements in [first, last) into the queue, waiting for room
+   * as needed if the queue is bounded. As many elements as will fit are added
+   * each time the lock is taken.
    */
-  void enqueue(const T& data) {
+  template <typename InputIt>
+  void enqueue_bulk(InputIt first, InputIt last) {
+    std::vector<std::pair<async_cb_type, T>> handoff;
     boost::unique_lock<boost::mutex> lock(m_mtx);
-    m_queue.push_back(data);
-    m_cv.notify_one();
-  }
+    while (first != last) {
+      /* async consumers first; they are only waiting if the queue is empty */
+      while (first != last && !m_async.empty()) {
+        handoff.emplace_back(std::move(m_async.front()), std::move(*first));
+        m_async.pop_front();
+        ++first;
+      } /* while() */
+      if (!handoff.empty()) {
+        lock.unlock();
+        handoff_run(&handoff);
+        lock.lock();
+        continue;
+      }
+      m_not_full.wait(lock, [&]() { return !full() || !m_async.empty(); });
+      while (first != last && !full()) {
+        m_queue.push_back(std::move(*first));
+        ++first;
+      } /* while() */
+      m_not_empty.notify_all();
+    } /* while() */
+  } /* enqueue_bulk() */
 
   /**
    * @brief Get data from the queue. Wait for data if not available.
    */
-  T dequeue() {
+  T dequeue(void) {
     boost::unique_lock<boost::mutex> lock(m_mtx);
 
     /* When there is no data, wait till someone fills it. Lock is automatically
      * released in the wait and obtained again after the wait.
      */
-    while (m_queue.empty()) { m_cv.wait(lock); }
+    m_not_empty.wait(lock, [&]() { return !m_queue.empty(); });
+    return pop();
+  }
 
-    auto result = static_cast<T>(m_queue.front());
-    m_queue.pop_front();
-    return result;
+  /**
+   * @brief Have the front element removed and passed to \a cb, without
+   * waiting: right away in the calling thread if the queue is not empty,
+   * otherwise in whichever thread enqueues the next element (in which case the
+   * element never enters the queue). Callbacks are served in the order they
+   * were registered, and must not block.
+   */
+  void dequeue_async(async_cb_type cb) {
+    boost::unique_lock<boost::mutex> lock(m_mtx);
+    if (m_queue.empty()) {
+      m_async.push_back(std::move(cb));
+      return;
+    }
+    T data = pop();
+    lock.unlock();
+    cb(std::move(data));
   }
 
-  size_t size() const { return m_queue.size(); }
-  T front(void) { return m_queue.front(); }
-  void clear(void) { m_queue.clear(); }
-  const T& operator[](std::size_t pos) const { return m_queue[pos]; }
+  /**
+   * @brief Remove the element at the front of the queue, if there is one.
+   *
+   * @param data To be filled with the front element.
+   *
+   * @return \c TRUE if an element was removed, \c FALSE if the queue was empty.
+   */
+  bool try_dequeue(T* const data) {
+    boost::unique_lock<boost::mutex> lock(m_mtx);
+    if (m_queue.empty()) {
+      return false;
+    }
+    *data = pop();
+    return true;
+  }
+
+  /**
+   * @brief Remove the element at the front of the queue, waiting up to \a
+   * timeout_ms milliseconds for one to become available.
+   *
+   * @param data To be filled with the front element.
+   * @param timeout_ms How long to wait before giving up.
+   *
+   * @return \c TRUE if an element was removed, \c FALSE on timeout.
+   */
+  bool wait_dequeue(T* const data, std::size_t timeout_ms) {
+    boost::unique_lock<boost::mutex> lock(m_mtx);
+    if (!m_not_empty.timed_wait(lock,
+                                boost::posix_time::milliseconds(timeout_ms),
+                                [&]() { return !m_queue.empty(); })) {
+      return false;
+    }
+    *data = pop();
+    return true;
+  }
+
+  /**
+   * @brief Move up to \a max_n elements from the front of the queue to \a out,
+   * without waiting.
+   *
+   * @return The # of elements removed.
+   */
+  template <typename OutputIt>
+  std::size_t try_dequeue_bulk(OutputIt out, std::size_t max_n) {
+    boost::unique_lock<boost::mutex> lock(m_mtx);
+    return pop_bulk(out, max_n);
+  }
+
+  /**
+   * @brief Move up to \a max_n elements from the front of the queue to \a out,
+   * waiting up to \a timeout_ms milliseconds for at least one to become
+   * available.
+   *
+   * @return The # of elements removed (0 on timeout).
+   */
+  template <typename OutputIt>
+  std::size_t wait_dequeue_bulk(OutputIt out,
+                                std::size_t max_n,
+                                std::size_t timeout_ms) {
+    boost::unique_lock<boost::mutex> lock(m_mtx);
+    m_not_empty.timed_wait(lock,
+                           boost::posix_time::milliseconds(timeout_ms),
+                           [&]() { return !m_queue.empty(); });
+    return pop_bulk(out, max_n);
+  }
+
+  std::size_t size(void) const {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    return m_queue.size();
+  }
+  bool empty(void) const { return 0 == size(); }
+  std::size_t capacity(void) const { return mc_capacity; }
+
+  /**
+   * @brief Get a copy of the front element. The queue must not be empty.
+   */
+  T front(void) const {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    return m_queue.front();
+  }
+  void clear(void) {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    m_queue.clear();
+    m_not_full.notify_all();
+  }
 
  private:
+  static constexpr std::size_t kNO_WAIT = 0;
+
+  /* must be called with the lock held */
+  bool full(void) const {
+    return kUNBOUNDED != mc_capacity && m_queue.size() >= mc_capacity;
+  }
+
+  /**
+   * @brief Add an element, waiting forever for room if \a timeout_ms is NULL,
+   * or for the specified # of milliseconds otherwise.
+   */
+  template <typename U>
+  bool push(U&& data, const std::size_t* const timeout_ms) {
+    boost::unique_lock<boost::mutex> lock(m_mtx);
+
+    /*
+     * An async consumer can register while we are waiting for room (the lock
+     * is released during the wait), so check for one after the wait too.
+     */
+    auto can_push = [&]() { return !full() || !m_async.empty(); };
+    if (nullptr == timeout_ms) {
+      m_not_full.wait(lock, can_push);
+    } else if (!m_not_full.timed_wait(
+                   lock, boost::posix_time::milliseconds(*timeout_ms),
+                   can_push)) {
+      return false;
+    }
+    if (!m_async.empty()) {
+      async_cb_type cb = std::move(m_async.front());
+      m_async.pop_front();
+      /* we did not use the room we may have been woken for; pass it on */
+      if (kUNBOUNDED != mc_capacity && !full()) {
+        m_not_full.notify_one();
+      }
+      lock.unlock();
+      cb(T(std::forward<U>(data)));
+      return true;
+    }
+    m_queue.push_back(std::forward<U>(data));
+    m_not_empty.notify_one();
+    return true;
+  } /* push() */
+
+  static void handoff_run(std::vector<std::pair<async_cb_type, T>>* handoff) {
+    for (auto& h : *handoff) {
+      h.first(std::move(h.second));
+    } /* for(h..) */
+    handoff->clear();
+  }
+
+  /* must be called with the lock held, and the queue non-empty */
+  T pop(void) {
+    T ret = std::move(m_queue.front());
+    m_queue.pop_front();
+    if (kUNBOUNDED != mc_capacity) {
+      m_not_full.notify_one();
+    }
+    return ret;
+  } /* pop() */
+
+  /* must be called with the lock held */
+  template <typename OutputIt>
+  std::size_t pop_bulk(OutputIt out, std::size_t max_n) {
+    std::size_t n = std::min(max_n, m_queue.size());
+    for (std::size_t i = 0; i < n; ++i) {
+      *out = std::move(m_queue.front());
+      ++out;
+      m_queue.pop_front();
+    } /* for(i..) */
+    if (n > 0 && kUNBOUNDED != mc_capacity) {
+      m_not_full.notify_all();
+    }
+    return n;
+  } /* pop_bulk() */
+
+  /* data members */
+  const std::size_t mc_capacity;
   std::deque<T> m_queue;
-  boost::mutex m_mtx;
-  boost::condition_variable m_cv;
+  mutable boost::mutex m_mtx;
+  boost::condition_variable m_not_empty;
+  boost::condition_variable m_not_full;
+  std::deque<async_cb_type> m_async;
 };
 
+template <typename T>
+constexpr std::size_t mt_queue<T>::kUNBOUNDED;
+template <typename T>
+constexpr std::size_t mt_queue<T>::kNO_WAIT;
+
 NS_END(multithread, rcppsw);
 
 #endif /* INCLUDE_RCPPSW_MULTITHREAD_MT_QUEUE_HPP_ */
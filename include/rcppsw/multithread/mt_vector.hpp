@@ -24,9 +24,12 @@
 /*******************************************************************************
  * Includes
  ******************************************************************************/
-#include <boost/thread.hpp>
-#include <boost/thread/locks.hpp>
-#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include "rcppsw/common/common.hpp"
 
 /*******************************************************************************
@@ -41,35 +44,298 @@ NS_START(rcppsw, multithread);
  * @class mt_vector
  * @ingroup multithread
  *
- * @brief A thread-safe vector implementation. Use when you need fast access to
- *        a large contiguous chunk of memory.
+ * @brief A thread-safe, append-only vector. Use when many threads need to add
+ *        results to a common collection while others read it.
+ *
+ * Elements live in segments that are never moved: segment 0 holds \ref
+ * kFIRST_SEGMENT elements and each one after that is twice the size of the
+ * one before, so references to elements stay valid until \ref clear() and the
+ * segment table never has to grow. Appending is lock-free: a writer claims an
+ * index with a single atomic increment, allocates the segment if it is the
+ * first one there, and constructs its element in place.
+ *
+ * Elements only become visible through \ref size(), indexing and iteration
+ * once they and all elements before them have been constructed, so readers
+ * can safely walk [0, size()) while writers are appending. Elements are not
+ * protected from concurrent modification after they are appended.
+ *
+ * An index that has been claimed must always end up holding an element, or
+ * nothing after it would ever become visible. Elements whose constructor can
+ * throw are therefore constructed before claiming an index, and moved into
+ * place afterwards, so \c T must be nothrow move constructible in that case.
  */
 template <typename T>
 class mt_vector {
  public:
-  mt_vector(void) : m_v(), m_mtx() {}
+  /**
+   * @brief The # of elements in the first segment.
+   */
+  static constexpr std::size_t kFIRST_SEGMENT_LOG2 = 5;
+  static constexpr std::size_t kFIRST_SEGMENT = 1UL << kFIRST_SEGMENT_LOG2;
+
+  class const_iterator;
+
+  mt_vector(void) = default;
+  ~mt_vector(void) { clear(); }
+
+  mt_vector(const mt_vector& other) = delete;
+  mt_vector& operator=(const mt_vector& other) = delete;
+
+  const_iterator begin(void) const { return const_iterator(this, 0); }
+  const_iterator end(void) const { return const_iterator(this, size()); }
+
+  /**
+   * @brief Append an element.
+   *
+   * @return A reference to the new element, which stays valid until the vector
+   * is cleared.
+   */
+  T& push_back(const T& data) { return emplace_back(data); }
+  T& push_back(T&& data) { return emplace_back(std::move(data)); }
 
-  /* type definitions */
-  typedef typename std::vector<T>::const_iterator const_iterator;
-  typename std::vector<T>::const_iterator begin(void) const {
-    return m_v.begin();
+  /**
+   * @brief Append an element constructed in place from \a args.
+   *
+   * @return A reference to the new element, which stays valid until the vector
+   * is cleared.
+   */
+  template <typename... Args>
+  T& emplace_back(Args&&... args) {
+    return emplace(std::is_nothrow_constructible<T, Args&&...>(),
+                   std::forward<Args>(args)...);
+  } /* emplace_back() */
+
+  /**
+   * @brief Get the # of elements that are fully constructed and visible to
+   * readers.
+   */
+  std::size_t size(void) const {
+    return m_size.load(std::memory_order_acquire);
   }
-  typename std::vector<T>::const_iterator end(void) const { return m_v.end(); }
+  bool empty(void) const { return 0 == size(); }
 
-  void push_back(const T& data) {
-    boost::unique_lock<boost::mutex> lock(m_mtx);
-    m_v.push_back(data);
+  /**
+   * @brief Destroy all elements and free all segments. Not safe to call
+   * concurrently with anything else.
+   */
+  void clear(void) {
+    std::size_t n = m_n_claimed.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < n; ++i) {
+      /* the segment allocation may have failed after the index was claimed */
+      std::size_t seg = 0;
+      std::size_t offset = 0;
+      locate(i, &seg, &offset);
+      cell* cells = m_segments[seg].load(std::memory_order_relaxed);
+      if (nullptr != cells && cells[offset].ready.load()) {
+        cells[offset].elt()->~T();
+      }
+    } /* for(i..) */
+    for (auto& seg : m_segments) {
+      delete[] seg.exchange(nullptr, std::memory_order_relaxed);
+    } /* for(seg..) */
+    m_n_claimed.store(0, std::memory_order_relaxed);
+    m_size.store(0, std::memory_order_release);
   }
 
-  size_t size() const { return m_v.size(); }
-  void clear(void) { m_v.clear(); }
-  const T& operator[](std::size_t pos) const { return m_v[pos]; }
+  /*
+   * Only valid for pos < size().
+   */
+  const T& operator[](std::size_t pos) const { return *cell_get(pos)->elt(); }
+  T& operator[](std::size_t pos) { return *cell_get(pos)->elt(); }
+
+  /**
+   * @brief Random access iterator over the elements visible when it was
+   * created.
+   */
+  class const_iterator {
+   public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const T* pointer;
+    typedef const T& reference;
+
+    const_iterator(void) = default;
+    const_iterator(const mt_vector* v, std::size_t pos) : m_v(v), m_pos(pos) {}
+
+    const T& operator*(void) const { return (*m_v)[m_pos]; }
+    const T* operator->(void) const { return &(*m_v)[m_pos]; }
+    const T& operator[](std::ptrdiff_t n) const { return *(*this + n); }
+
+    const_iterator& operator++(void) {
+      ++m_pos;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator tmp(*this);
+      ++m_pos;
+      return tmp;
+    }
+    const_iterator& operator--(void) {
+      --m_pos;
+      return *this;
+    }
+    const_iterator operator--(int) {
+      const_iterator tmp(*this);
+      --m_pos;
+      return tmp;
+    }
+    const_iterator& operator+=(std::ptrdiff_t n) {
+      m_pos = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(m_pos) + n);
+      return *this;
+    }
+    const_iterator& operator-=(std::ptrdiff_t n) { return *this += -n; }
+    const_iterator operator+(std::ptrdiff_t n) const {
+      const_iterator tmp(*this);
+      return tmp += n;
+    }
+    const_iterator operator-(std::ptrdiff_t n) const {
+      const_iterator tmp(*this);
+      return tmp -= n;
+    }
+    std::ptrdiff_t operator-(const const_iterator& other) const {
+      return static_cast<std::ptrdiff_t>(m_pos) -
+             static_cast<std::ptrdiff_t>(other.m_pos);
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return m_pos == other.m_pos;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return m_pos != other.m_pos;
+    }
+    bool operator<(const const_iterator& other) const {
+      return m_pos < other.m_pos;
+    }
+    bool operator>(const const_iterator& other) const {
+      return m_pos > other.m_pos;
+    }
+    bool operator<=(const const_iterator& other) const {
+      return m_pos <= other.m_pos;
+    }
+    bool operator>=(const const_iterator& other) const {
+      return m_pos >= other.m_pos;
+    }
+
+   private:
+    const mt_vector* m_v{nullptr};
+    std::size_t m_pos{0};
+  };
 
  private:
-  std::vector<T> m_v;
-  boost::mutex m_mtx;
+  static constexpr std::size_t kMAX_SEGMENTS = 64 - kFIRST_SEGMENT_LOG2;
+
+  struct cell {
+    cell(void) : ready(false), storage() {}
+    T* elt(void) { return reinterpret_cast<T*>(&storage); }
+
+    std::atomic<bool> ready;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  /**
+   * @brief Claim an index and construct an element there from \a args, which
+   * cannot throw.
+   */
+  template <typename... Args>
+  T& emplace(std::true_type, Args&&... args) {
+    std::size_t i = m_n_claimed.fetch_add(1, std::memory_order_relaxed);
+    cell* c = cell_alloc(i);
+    new (&c->storage) T(std::forward<Args>(args)...);
+    c->ready.store(true);
+    publish();
+    return *c->elt();
+  } /* emplace() */
+
+  /**
+   * @brief Construct an element from \a args, which might throw, before
+   * claiming an index for it.
+   */
+  template <typename... Args>
+  T& emplace(std::false_type, Args&&... args) {
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "T must be nothrow move constructible if it can throw "
+                  "when constructed");
+    T tmp(std::forward<Args>(args)...);
+    return emplace(std::true_type(), std::move(tmp));
+  } /* emplace() */
+
+  /**
+   * @brief Map an element index to its segment and the offset within it.
+   */
+  static void locate(std::size_t i, std::size_t* seg, std::size_t* offset) {
+    auto j = static_cast<uint64_t>(i + kFIRST_SEGMENT);
+    auto hb = static_cast<std::size_t>(63 - __builtin_clzll(j));
+    *seg = hb - kFIRST_SEGMENT_LOG2;
+    *offset = static_cast<std::size_t>(j - (uint64_t(1) << hb));
+  }
+
+  cell* cell_get(std::size_t i) const {
+    std::size_t seg = 0;
+    std::size_t offset = 0;
+    locate(i, &seg, &offset);
+    return m_segments[seg].load(std::memory_order_acquire) + offset;
+  }
+
+  /**
+   * @brief Get the cell for index \a i, allocating its segment if no one has
+   * yet. Threads that race to allocate the same segment agree on one via a CAS.
+   */
+  cell* cell_alloc(std::size_t i) {
+    std::size_t seg = 0;
+    std::size_t offset = 0;
+    locate(i, &seg, &offset);
+    cell* cells = m_segments[seg].load(std::memory_order_acquire);
+    if (nullptr == cells) {
+      auto* fresh = new cell[kFIRST_SEGMENT << seg];
+      if (m_segments[seg].compare_exchange_strong(cells, fresh)) {
+        cells = fresh;
+      } else {
+        delete[] fresh;
+      }
+    }
+    return cells + offset;
+  }
+
+  /**
+   * @brief Advance the visible size past every constructed element that
+   * directly follows it. Whichever writer finishes the element at the current
+   * size moves it forward, including over elements finished earlier by other
+   * writers.
+   */
+  void publish(void) {
+    /*
+     * Everything here is sequentially consistent, so that of two writers
+     * finishing adjacent elements at the same time, at least one sees the other
+     * is done.
+     */
+    std::size_t n = m_size.load();
+    for (;;) {
+      std::size_t seg = 0;
+      std::size_t offset = 0;
+      locate(n, &seg, &offset);
+      cell* cells = m_segments[seg].load();
+      if (nullptr == cells || !cells[offset].ready.load()) {
+        break;
+      }
+      /* on failure n is reloaded, as someone else has advanced it */
+      if (m_size.compare_exchange_weak(n, n + 1)) {
+        ++n;
+      }
+    } /* for(;;) */
+  } /* publish() */
+
+  /* data members */
+  std::atomic<cell*> m_segments[kMAX_SEGMENTS]{};
+  std::atomic<std::size_t> m_n_claimed{0};
+  std::atomic<std::size_t> m_size{0};
 };
 
+template <typename T>
+constexpr std::size_t mt_vector<T>::kFIRST_SEGMENT_LOG2;
+template <typename T>
+constexpr std::size_t mt_vector<T>::kFIRST_SEGMENT;
+
 NS_END(multithread, rcppsw);
 
 #endif /* INCLUDE_RCPPSW_MULTITHREAD_MT_VECTOR_HPP_ */
@@ -0,0 +1,86 @@
+/**
+ * @file numa_alloc.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_NUMA_ALLOC_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_NUMA_ALLOC_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <cstddef>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class numa_alloc
+ * @ingroup multithread
+ *
+ * @brief Allocate memory whose pages are placed on a particular NUMA node.
+ *
+ * Memory comes straight from mmap() and is tied to the node with the mbind()
+ * syscall (called directly, so libnuma is not needed), as a preference rather
+ * than a hard binding: if the node runs out of memory, pages come from
+ * elsewhere instead of the allocation failing. On kernels without NUMA support
+ * the binding is silently skipped. Allocations are whole pages, so this is for
+ * large per-thread buffers, not individual objects.
+ */
+class numa_alloc {
+ public:
+  /**
+   * @brief Allocate \a bytes bytes of zeroed memory on \a node.
+   *
+   * @param bytes The size of the allocation.
+   * @param node The NUMA node, or -1 for no preference.
+   *
+   * @return The memory, or NULL if the allocation failed.
+   */
+  static void* alloc(std::size_t bytes, int node);
+
+  /**
+   * @brief Allocate \a bytes bytes of zeroed memory on the node the calling
+   * thread is currently running on.
+   */
+  static void* alloc_local(std::size_t bytes) {
+    return alloc(bytes, current_node());
+  }
+
+  /**
+   * @brief Free memory from \ref alloc(). \a bytes must be the size that was
+   * allocated.
+   */
+  static void free(void* ptr, std::size_t bytes);
+
+  /**
+   * @brief Get the NUMA node the calling thread is currently running on (-1
+   * if it cannot be determined).
+   */
+  static int current_node(void);
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_NUMA_ALLOC_HPP_ */
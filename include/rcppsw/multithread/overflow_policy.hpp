@@ -0,0 +1,60 @@
+/**
+ * @file overflow_policy.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_OVERFLOW_POLICY_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_OVERFLOW_POLICY_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class overflow_policy
+ * @ingroup multithread
+ *
+ * @brief What a bounded queue does when a producer tries to add an element and
+ * the queue is full.
+ *
+ * BLOCK: The producer waits until the consumer has made room. Nothing is ever
+ *        lost, but a slow consumer will stall all producers.
+ *
+ * DROP_NEWEST: The element being added is discarded, and the producer returns
+ *              immediately. The queue keeps the oldest elements.
+ *
+ * OVERWRITE_OLDEST: The oldest element in the queue is discarded to make room
+ *                   for the new one. The queue keeps the newest elements.
+ */
+class overflow_policy {
+ public:
+  enum value { BLOCK, DROP_NEWEST, OVERWRITE_OLDEST };
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_OVERFLOW_POLICY_HPP_ */
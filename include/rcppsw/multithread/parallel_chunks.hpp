@@ -0,0 +1,95 @@
+/**
+ * @file parallel_chunks.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_CHUNKS_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_CHUNKS_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multithread/chunking.hpp"
+#include "rcppsw/multithread/task_group.hpp"
+#include "rcppsw/multithread/thread_pool.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Call \a f(k) for each chunk index k in [0, n_chunks) on a thread
+ * pool, returning when all calls have finished. The building block for the
+ * other parallel algorithms.
+ *
+ * At most one task per pool thread is created, and the calling thread does the
+ * first task's share itself. \a f is called concurrently from multiple threads.
+ *
+ * @param n_chunks # of chunks.
+ * @param f The callable to run for each chunk.
+ * @param policy How chunks are handed out to the tasks.
+ * @param pool The pool to run on.
+ */
+template <typename F>
+void parallel_chunks(std::size_t n_chunks,
+                     F f,
+                     chunking::value policy = chunking::DYNAMIC,
+                     thread_pool& pool = thread_pool::instance()) {
+  std::size_t n_tasks = std::min(n_chunks, pool.n_threads());
+  if (n_tasks <= 1) {
+    for (std::size_t k = 0; k < n_chunks; ++k) {
+      f(k);
+    } /* for(k..) */
+    return;
+  }
+
+  std::atomic<std::size_t> next{0};
+  auto work = [&](std::size_t t) {
+    if (chunking::STATIC == policy) {
+      for (std::size_t k = t * n_chunks / n_tasks;
+           k < (t + 1) * n_chunks / n_tasks;
+           ++k) {
+        f(k);
+      } /* for(k..) */
+    } else {
+      for (std::size_t k = next.fetch_add(1, std::memory_order_relaxed);
+           k < n_chunks;
+           k = next.fetch_add(1, std::memory_order_relaxed)) {
+        f(k);
+      } /* for(k..) */
+    }
+  };
+
+  task_group group(pool);
+  for (std::size_t t = 1; t < n_tasks; ++t) {
+    group.run([&work, t]() { work(t); });
+  } /* for(t..) */
+  work(0);
+  group.wait();
+} /* parallel_chunks() */
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_CHUNKS_HPP_ */
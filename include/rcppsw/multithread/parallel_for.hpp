@@ -0,0 +1,64 @@
+/**
+ * @file parallel_for.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_FOR_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_FOR_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multithread/parallel_chunks.hpp"
+#include "rcppsw/multithread/range.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Run a loop body over a range in parallel.
+ *
+ * @param r The range of indices; its grain size sets the size of the chunks
+ *          that \a body is called on.
+ * @param body Callable as \c body(const range& chunk); must process each index
+ *             in the chunk. Called concurrently from multiple threads.
+ * @param policy How chunks are handed out to threads. \ref chunking::STATIC
+ *               gives each thread the same indices on every call with the
+ *               same range and pool.
+ * @param pool The pool to run on.
+ */
+template <typename F>
+void parallel_for(const range& r,
+                  F body,
+                  chunking::value policy = chunking::STATIC,
+                  thread_pool& pool = thread_pool::instance()) {
+  parallel_chunks(r.n_chunks(),
+                  [&](std::size_t k) { body(r.chunk(k)); },
+                  policy,
+                  pool);
+} /* parallel_for() */
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_FOR_HPP_ */
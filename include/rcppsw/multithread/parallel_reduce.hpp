@@ -0,0 +1,86 @@
+/**
+ * @file parallel_reduce.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_REDUCE_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_REDUCE_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <vector>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multithread/parallel_chunks.hpp"
+#include "rcppsw/multithread/range.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Reduce a range in parallel.
+ *
+ * Each chunk of the range is reduced on its own, starting from \a identity,
+ * and the per-chunk results are then combined in chunk order on the calling
+ * thread. Since chunk boundaries only depend on the range, the result is the
+ * same for any # of threads, even if \a combine is only approximately
+ * associative (e.g. floating point addition).
+ *
+ * @param r The range of indices.
+ * @param identity The identity element for \a combine.
+ * @param body Callable as \c T body(const range& chunk, T init), returning
+ *             \a init combined with the values for each index in the chunk.
+ *             Called concurrently from multiple threads.
+ * @param combine Callable as \c T combine(T lhs, T rhs).
+ * @param pool The pool to run on.
+ *
+ * @return The reduced value.
+ */
+template <typename T, typename F, typename C>
+T parallel_reduce(const range& r,
+                  const T& identity,
+                  F body,
+                  C combine,
+                  thread_pool& pool = thread_pool::instance()) {
+  /* wrapped so that T=bool does not get the bit-packed vector */
+  struct partial {
+    T val;
+  };
+  std::vector<partial> partials(r.n_chunks(), partial{identity});
+  parallel_chunks(r.n_chunks(),
+                  [&](std::size_t k) {
+                    partials[k].val = body(r.chunk(k), identity);
+                  },
+                  chunking::DYNAMIC,
+                  pool);
+
+  T ret = identity;
+  for (auto& p : partials) {
+    ret = combine(ret, p.val);
+  } /* for(p..) */
+  return ret;
+} /* parallel_reduce() */
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_REDUCE_HPP_ */
@@ -0,0 +1,106 @@
+/**
+ * @file parallel_scan.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_SCAN_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_SCAN_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <iterator>
+#include <vector>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multithread/parallel_chunks.hpp"
+#include "rcppsw/multithread/range.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/**
+ * @brief Compute an inclusive prefix scan in parallel: out[i] = in[b] + ... +
+ * in[i] for each i in the range [b, e), where + is \a combine.
+ *
+ * Done in two passes over the chunks of the range: the first computes the
+ * total of each chunk, which are then scanned serially on the calling thread,
+ * and the second scans each chunk starting from the total of the chunks before
+ * it. Like \ref parallel_reduce(), the result does not depend on the # of
+ * threads. \a out may be the same as \a in.
+ *
+ * @param r The range of indices into \a in and \a out.
+ * @param in Random access iterator to the input.
+ * @param out Random access iterator to the output.
+ * @param combine Associative callable as \c T combine(T lhs, T rhs).
+ * @param pool The pool to run on.
+ */
+template <typename InIt, typename OutIt, typename C>
+void parallel_scan(const range& r,
+                   InIt in,
+                   OutIt out,
+                   C combine,
+                   thread_pool& pool = thread_pool::instance()) {
+  typedef typename std::iterator_traits<InIt>::value_type value_type;
+  struct partial {
+    value_type val;
+  };
+  std::vector<partial> sums(r.n_chunks());
+
+  /* pass 1: chunk totals */
+  parallel_chunks(r.n_chunks(),
+                  [&](std::size_t k) {
+                    range c = r.chunk(k);
+                    value_type acc = in[c.begin()];
+                    for (std::size_t i = c.begin() + 1; i < c.end(); ++i) {
+                      acc = combine(acc, in[i]);
+                    } /* for(i..) */
+                    sums[k].val = acc;
+                  },
+                  chunking::DYNAMIC,
+                  pool);
+
+  for (std::size_t k = 1; k < sums.size(); ++k) {
+    sums[k].val = combine(sums[k - 1].val, sums[k].val);
+  } /* for(k..) */
+
+  /* pass 2: scan each chunk, starting from everything before it */
+  parallel_chunks(r.n_chunks(),
+                  [&](std::size_t k) {
+                    range c = r.chunk(k);
+                    value_type acc = (0 == k)
+                                         ? value_type(in[c.begin()])
+                                         : combine(sums[k - 1].val,
+                                                   in[c.begin()]);
+                    out[c.begin()] = acc;
+                    for (std::size_t i = c.begin() + 1; i < c.end(); ++i) {
+                      acc = combine(acc, in[i]);
+                      out[i] = acc;
+                    } /* for(i..) */
+                  },
+                  chunking::DYNAMIC,
+                  pool);
+} /* parallel_scan() */
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_PARALLEL_SCAN_HPP_ */
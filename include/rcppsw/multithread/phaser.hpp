@@ -0,0 +1,137 @@
+/**
+ * @file phaser.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_PHASER_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_PHASER_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <cstdint>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class phaser
+ * @ingroup multithread
+ *
+ * @brief A reusable barrier whose set of parties can change between (or
+ * during) phases, and where arriving and waiting are separate operations, so a
+ * party can signal it is done with a phase, do unrelated work, and only then
+ * wait for the others.
+ *
+ * The phase #, # of registered parties and # of parties yet to arrive are
+ * packed into one 64-bit word that is updated with a CAS, so arriving and
+ * (de)registering never lock. Waiting spins briefly and then sleeps on a
+ * futex, like \ref barrier. Up to 65535 parties are supported. Phase #s wrap
+ * around, and are compared so that the wraparound does not matter.
+ */
+class phaser {
+ public:
+  /**
+   * @param n_parties The # of parties initially registered.
+   */
+  explicit phaser(std::size_t n_parties = 0);
+
+  phaser(const phaser& other) = delete;
+  phaser& operator=(const phaser& other) = delete;
+
+  /**
+   * @brief Add a party, which must arrive before the current phase can
+   * complete.
+   *
+   * @return The current phase.
+   */
+  uint32_t register_party(void);
+
+  /**
+   * @brief Arrive at the current phase without waiting for the others.
+   *
+   * @return The phase arrived at, to pass to \ref await_advance().
+   */
+  uint32_t arrive(void) { return arrive_impl(false); }
+
+  /**
+   * @brief Arrive at the current phase and stop participating in future
+   * ones.
+   *
+   * @return The phase arrived at.
+   */
+  uint32_t arrive_and_deregister(void) { return arrive_impl(true); }
+
+  /**
+   * @brief Wait until the phaser has moved past \a phase. Returns immediately
+   * if it already has.
+   */
+  void await_advance(uint32_t phase);
+
+  /**
+   * @brief Arrive at the current phase and wait for all the other parties to.
+   *
+   * @return The phase arrived at.
+   */
+  uint32_t arrive_and_await(void) {
+    uint32_t phase = arrive();
+    await_advance(phase);
+    return phase;
+  }
+
+  /**
+   * @brief Get the current phase.
+   */
+  uint32_t phase(void) const {
+    return static_cast<uint32_t>(m_state.load(std::memory_order_acquire) >>
+                                 32);
+  }
+  std::size_t n_parties(void) const {
+    return (m_state.load(std::memory_order_acquire) >> 16) & kCOUNT_MASK;
+  }
+  std::size_t n_unarrived(void) const {
+    return m_state.load(std::memory_order_acquire) & kCOUNT_MASK;
+  }
+
+ private:
+  static constexpr uint64_t kCOUNT_MASK = 0xFFFF;
+
+  uint32_t arrive_impl(bool deregister);
+
+  /* data members */
+  /* phase (32 bits) | parties (16 bits) | unarrived (16 bits) */
+  std::atomic<uint64_t> m_state;
+
+  /*
+   * Incremented after each phase completes (trailing m_state slightly); what
+   * waiters block on.
+   */
+  std::atomic<uint32_t> m_completed{0};
+  std::atomic<uint32_t> m_n_sleeping{0};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_PHASER_HPP_ */
@@ -0,0 +1,58 @@
+/**
+ * @file placement.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_PLACEMENT_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_PLACEMENT_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class placement
+ * @ingroup multithread
+ *
+ * @brief How a \ref thread_group assigns its threads to CPUs. In both cases,
+ * each physical core gets one thread before any core gets a second one on a
+ * sibling hardware thread.
+ *
+ * COMPACT: Fill up the first NUMA node before moving on to the next one. Best
+ *          when the threads share data, or there are few of them.
+ *
+ * SPREAD: Deal threads out to the NUMA nodes round robin. Best when each
+ *         thread works on its own data and memory bandwidth is the limit.
+ */
+class placement {
+ public:
+  enum value { COMPACT, SPREAD };
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_PLACEMENT_HPP_ */
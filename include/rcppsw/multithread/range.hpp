@@ -0,0 +1,131 @@
+/**
+ * @file range.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_RANGE_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_RANGE_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <algorithm>
+#include <cstddef>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class range
+ * @ingroup multithread
+ *
+ * @brief A half open range of indices [begin, end) to be processed in
+ * parallel, along with the grain size: the # of indices in each chunk handed
+ * to a thread.
+ *
+ * Chunk boundaries only depend on the range and the grain size, never on the
+ * # of threads, which is what lets \ref parallel_reduce() and \ref
+ * parallel_scan() give the same results however many threads they run on.
+ */
+class range {
+ public:
+  /**
+   * @brief # of chunks a range is divided into if no grain size is given.
+   */
+  static constexpr std::size_t kAUTO_CHUNKS = 256;
+
+  /**
+   * @param begin First index.
+   * @param end One past the last index.
+   * @param grain # of indices per chunk. 0 picks one that divides the range
+   *              into about \ref kAUTO_CHUNKS chunks.
+   */
+  range(std::size_t begin, std::size_t end, std::size_t grain = 0)
+      : m_begin(begin),
+        m_end(std::max(begin, end)),
+        m_grain((0 != grain) ? grain
+                             : std::max<std::size_t>(
+                                   1,
+                                   (m_end - m_begin + kAUTO_CHUNKS - 1) /
+                                       kAUTO_CHUNKS)) {}
+
+  std::size_t begin(void) const { return m_begin; }
+  std::size_t end(void) const { return m_end; }
+  std::size_t size(void) const { return m_end - m_begin; }
+  bool empty(void) const { return m_begin == m_end; }
+  std::size_t grain(void) const { return m_grain; }
+
+  /**
+   * @brief Get the # of grain sized chunks in the range (the last one may be
+   * smaller).
+   */
+  std::size_t n_chunks(void) const {
+    return (size() + m_grain - 1) / m_grain;
+  }
+
+  /**
+   * @brief Get the \a k-th grain sized chunk.
+   */
+  range chunk(std::size_t k) const {
+    std::size_t b = std::min(m_end, m_begin + k * m_grain);
+    return range(b, std::min(m_end, b + m_grain), m_grain);
+  }
+
+  /**
+   * @brief Get the \a i-th of \a n pieces that the range is divided into as
+   * evenly as possible: the first size() % n pieces get one extra index.
+   */
+  range piece(std::size_t i, std::size_t n) const {
+    std::size_t base = size() / n;
+    std::size_t extra = size() % n;
+    std::size_t b = m_begin + i * base + std::min(i, extra);
+    return range(b, b + base + ((i < extra) ? 1 : 0), m_grain);
+  }
+
+  /**
+   * @brief Determine if the range is worth splitting: if it has more than one
+   * chunk's worth of indices.
+   */
+  bool is_divisible(void) const { return size() > m_grain; }
+
+  /**
+   * @brief Split the range in half, keeping the lower half and returning the
+   * upper half. Both keep the grain size.
+   */
+  range split(void) {
+    std::size_t mid = m_begin + size() / 2;
+    range upper(mid, m_end, m_grain);
+    m_end = mid;
+    return upper;
+  }
+
+ private:
+  std::size_t m_begin;
+  std::size_t m_end;
+  std::size_t m_grain;
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_RANGE_HPP_ */
@@ -0,0 +1,178 @@
+/**
+ * @file spsc_ring.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_SPSC_RING_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_SPSC_RING_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class spsc_ring
+ * @ingroup multithread
+ *
+ * @brief A bounded, wait-free single-producer/single-consumer ring buffer.
+ *
+ * The producer only writes the tail index and the consumer only writes the
+ * head index, each on its own cache line. Each side also keeps a private copy
+ * of the other side's index, and only re-reads the shared one when the copy
+ * says the ring is full/empty, so in steady state neither side touches the
+ * other's cache line. The capacity is rounded up to the next power of 2.
+ *
+ * Has the same non-blocking interface as \ref mpmc_ring and \ref mt_queue.
+ * Calling try_enqueue() from more than one thread (or try_dequeue()) at a time
+ * is undefined.
+ */
+template <typename T>
+class spsc_ring {
+ public:
+  /**
+   * @param capacity Minimum # of elements the ring can hold.
+   */
+  explicit spsc_ring(std::size_t capacity)
+      : mc_mask(round_pow2(capacity) - 1), m_slots(new slot[mc_mask + 1]) {}
+
+  ~spsc_ring(void) {
+    while (try_dequeue(nullptr)) {
+    }
+  }
+
+  spsc_ring(const spsc_ring& other) = delete;
+  spsc_ring& operator=(const spsc_ring& other) = delete;
+
+  /**
+   * @brief Add an element to the ring if there is room for it. Producer only.
+   *
+   * @return \c TRUE if the element was added, \c FALSE if the ring was full
+   * (in which case \a data is not moved from).
+   */
+  bool try_enqueue(const T& data) { return push(data); }
+  bool try_enqueue(T&& data) { return push(std::move(data)); }
+
+  /**
+   * @brief Remove the element at the front of the ring, if there is
+   * one. Consumer only.
+   *
+   * @param data To be filled with the front element. If NULL, the element is
+   *             just destroyed.
+   *
+   * @return \c TRUE if an element was removed, \c FALSE if the ring was empty.
+   */
+  bool try_dequeue(T* const data) {
+    std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail_cache) {
+      m_tail_cache = m_tail.load(std::memory_order_acquire);
+      if (head == m_tail_cache) {
+        return false;
+      }
+    }
+    T* elt = m_slots[head & mc_mask].elt();
+    if (nullptr != data) {
+      *data = std::move(*elt);
+    }
+    elt->~T();
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  } /* try_dequeue() */
+
+  /**
+   * @brief Get the # of elements currently in the ring. Only approximate if
+   * called from a thread other than the producer/consumer.
+   */
+  std::size_t size(void) const {
+    std::size_t head = m_head.load(std::memory_order_acquire);
+    std::size_t tail = m_tail.load(std::memory_order_acquire);
+    return (tail > head) ? tail - head : 0;
+  }
+  bool empty(void) const { return 0 == size(); }
+  std::size_t capacity(void) const { return mc_mask + 1; }
+
+ private:
+  /**
+   * @brief The size of a cache line on the platforms we care about, used to
+   * keep the producer and consumer indices from false sharing.
+   */
+  static constexpr std::size_t kCACHE_LINE = 64;
+
+  struct slot {
+    slot(void) : storage() {}
+    T* elt(void) { return reinterpret_cast<T*>(&storage); }
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+  };
+
+  static std::size_t round_pow2(std::size_t n) {
+    std::size_t ret = 2;
+    while (ret < n) {
+      ret <<= 1;
+    } /* while() */
+    return ret;
+  }
+
+  template <typename U>
+  bool push(U&& data) {
+    std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head_cache > mc_mask) {
+      m_head_cache = m_head.load(std::memory_order_acquire);
+      if (tail - m_head_cache > mc_mask) {
+        return false;
+      }
+    }
+    new (&m_slots[tail & mc_mask].storage) T(std::forward<U>(data));
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  } /* push() */
+
+  /* data members */
+  const std::size_t mc_mask;
+  std::unique_ptr<slot[]> m_slots;
+
+  /* producer side */
+  char m_pad0[kCACHE_LINE]{};
+  std::atomic<std::size_t> m_tail{0};
+  std::size_t m_head_cache{0};
+  char m_pad1[kCACHE_LINE - sizeof(std::atomic<std::size_t>) -
+              sizeof(std::size_t)]{};
+
+  /* consumer side */
+  std::atomic<std::size_t> m_head{0};
+  std::size_t m_tail_cache{0};
+  char m_pad2[kCACHE_LINE - sizeof(std::atomic<std::size_t>) -
+              sizeof(std::size_t)]{};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_SPSC_RING_HPP_ */
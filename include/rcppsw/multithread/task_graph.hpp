@@ -0,0 +1,181 @@
+/**
+ * @file task_graph.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_TASK_GRAPH_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_TASK_GRAPH_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multithread/task_group.hpp"
+#include "rcppsw/multithread/thread_pool.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class task_graph
+ * @ingroup multithread
+ *
+ * @brief Runs a set of tasks with dependencies between them (a directed
+ * acyclic graph) on a \ref thread_pool, starting each task as soon as all the
+ * tasks it depends on have finished, so independent stages overlap.
+ *
+ * Each task's return value (or the exception it threw) is available through a
+ * future, and \ref then() adds a task that receives another task's result. A
+ * task that throws does not stop the tasks that depend on it from running;
+ * they see the exception if they get the result.
+ *
+ * A graph is built single threaded, then \ref run() once. Blocking on a
+ * task's future from inside a pool task ties up a worker; prefer \ref then()
+ * or \ref wait(), which runs other tasks while it waits.
+ */
+class task_graph {
+  /**
+   * @brief How to call a continuation with the result of its predecessor
+   * (declared first, as \ref then() needs it).
+   */
+  template <typename R, typename F>
+  struct continuation {
+    typedef typename std::result_of<F(R)>::type type;
+    static type call(F& f, const std::shared_future<R>& in) {
+      return f(in.get());
+    }
+  };
+  template <typename F>
+  struct continuation<void, F> {
+    typedef typename std::result_of<F()>::type type;
+    static type call(F& f, const std::shared_future<void>& in) {
+      in.get(); /* rethrows */
+      return f();
+    }
+  };
+
+ public:
+  typedef std::size_t node_id;
+
+  /**
+   * @brief A task in the graph: its ID, for adding dependencies, and its
+   * result.
+   */
+  template <typename R>
+  struct node {
+    node_id id;
+    std::shared_future<R> result;
+  };
+
+  explicit task_graph(thread_pool& pool = thread_pool::instance())
+      : m_group(pool) {}
+
+  /**
+   * @brief Waits for all tasks to finish, if the graph was run.
+   */
+  ~task_graph(void) { wait(); }
+
+  task_graph(const task_graph& other) = delete;
+  task_graph& operator=(const task_graph& other) = delete;
+
+  /**
+   * @brief Add a task with no dependencies (yet).
+   *
+   * @param f Callable as f().
+   */
+  template <typename F>
+  node<typename std::result_of<F()>::type> add(F f) {
+    typedef typename std::result_of<F()>::type R;
+    auto task = std::make_shared<std::packaged_task<R()>>(std::move(f));
+    return node<R>{vertex_add([task]() { (*task)(); }),
+                   task->get_future().share()};
+  }
+
+  /**
+   * @brief Add a task that runs after \a pred, and is passed its result (or
+   * nothing, if \a pred returns void).
+   *
+   * @param pred The task to continue from.
+   * @param f Callable as f(R), or f() if R is void.
+   */
+  template <typename R, typename F>
+  node<typename continuation<R, F>::type> then(const node<R>& pred, F f) {
+    std::shared_future<R> in = pred.result;
+    auto ret =
+        add([f, in]() mutable { return continuation<R, F>::call(f, in); });
+    precede(pred.id, ret.id);
+    return ret;
+  }
+
+  /**
+   * @brief Make \a after wait for \a before to finish.
+   */
+  void precede(node_id before, node_id after);
+
+  /**
+   * @brief Start all tasks that have no dependencies, and the rest as they
+   * become ready. Returns without waiting.
+   *
+   * @return \ref OK if the graph was started, \ref ERROR if it has already
+   * been run or has a cycle in it.
+   */
+  status_t run(void);
+
+  /**
+   * @brief Wait for all tasks to finish, running other pool tasks meanwhile.
+   */
+  void wait(void) { m_group.wait(); }
+
+  std::size_t size(void) const { return m_vertices.size(); }
+
+ private:
+  struct vertex {
+    explicit vertex(std::function<void(void)> f) : fn(std::move(f)) {}
+
+    std::function<void(void)> fn;
+    std::vector<node_id>      succ{};
+    std::size_t               n_preds{0};
+    std::atomic<std::size_t>  n_waiting{0};
+  };
+
+  node_id vertex_add(std::function<void(void)> fn);
+  void vertex_run(node_id id);
+  bool is_acyclic(void) const;
+
+  /* data members */
+  std::deque<vertex> m_vertices{};
+  bool               m_started{false};
+  task_group         m_group;
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_TASK_GRAPH_HPP_ */
@@ -0,0 +1,94 @@
+/**
+ * @file task_group.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_TASK_GROUP_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_TASK_GROUP_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multithread/thread_pool.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class task_group
+ * @ingroup multithread
+ *
+ * @brief A set of tasks run on a \ref thread_pool that can be waited on
+ * together, independently of whatever else the pool is doing.
+ *
+ * The thread waiting on the group runs pending tasks from the pool while it
+ * waits, so a task can split its work into a group of its own without tying up
+ * a worker. Finishing a task touches nothing but an atomic counter in the
+ * group, so the waiter polls it (backing off to short sleeps) rather than
+ * being woken up; the group can be destroyed as soon as \ref wait() returns.
+ */
+class task_group {
+ public:
+  explicit task_group(thread_pool& pool = thread_pool::instance())
+      : m_pool(pool) {}
+
+  /**
+   * @brief Waits for all tasks in the group to finish.
+   */
+  ~task_group(void) { wait(); }
+
+  task_group(const task_group& other) = delete;
+  task_group& operator=(const task_group& other) = delete;
+
+  /**
+   * @brief Queue a task in the group.
+   */
+  void run(thread_pool::task_type fn);
+
+  /**
+   * @brief Wait until all tasks in the group (including any run by tasks in
+   * the group while waiting) have finished.
+   */
+  void wait(void);
+
+  std::size_t n_pending(void) const {
+    return m_n_pending.load(std::memory_order_acquire);
+  }
+
+  thread_pool& pool(void) const { return m_pool; }
+
+ private:
+  friend class thread_pool;
+
+  void task_done(void) { m_n_pending.fetch_sub(1, std::memory_order_acq_rel); }
+
+  /* data members */
+  thread_pool&             m_pool;
+  std::atomic<std::size_t> m_n_pending{0};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_TASK_GROUP_HPP_ */
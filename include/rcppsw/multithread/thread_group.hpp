@@ -0,0 +1,149 @@
+/**
+ * @file thread_group.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_THREAD_GROUP_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_THREAD_GROUP_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <functional>
+#include <memory>
+#include <vector>
+#include "rcppsw/common/common.hpp"
+#include "rcppsw/multithread/cpu_topology.hpp"
+#include "rcppsw/multithread/numa_alloc.hpp"
+#include "rcppsw/multithread/placement.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class thread_group
+ * @ingroup multithread
+ *
+ * @brief A set of threads that all run the same function, each pinned to its
+ * own CPU according to the machine's \ref cpu_topology and a \ref placement
+ * policy.
+ *
+ * Threads pin themselves before running anything else, so memory they touch
+ * first (e.g. via \ref member::alloc()) is placed on their own NUMA node.
+ */
+class thread_group {
+ public:
+  /**
+   * @brief What each thread in the group is told about itself.
+   */
+  class member {
+   public:
+    member(std::size_t rank, int cpu, int node)
+        : mc_rank(rank), mc_cpu(cpu), mc_node(node) {}
+
+    /**
+     * @brief The index of the thread in the group, [0, size()).
+     */
+    std::size_t rank(void) const { return mc_rank; }
+    int cpu(void) const { return mc_cpu; }
+    int node(void) const { return mc_node; }
+
+    /**
+     * @brief Allocate memory on this thread's NUMA node, to be freed with
+     * \ref free().
+     */
+    void* alloc(std::size_t bytes) const {
+      return numa_alloc::alloc(bytes, mc_node);
+    }
+    void free(void* ptr, std::size_t bytes) const {
+      numa_alloc::free(ptr, bytes);
+    }
+
+   private:
+    const std::size_t mc_rank;
+    const int         mc_cpu;
+    const int         mc_node;
+  };
+
+  typedef std::function<void(const member&)> body_type;
+
+  /**
+   * @param n_threads The # of threads; 0 means one per online CPU. If there
+   *                  are more threads than CPUs, CPUs are reused in the same
+   *                  order.
+   * @param policy How to assign threads to CPUs.
+   * @param topo The machine layout.
+   */
+  thread_group(std::size_t n_threads,
+               placement::value policy,
+               const cpu_topology& topo = cpu_topology::instance());
+
+  /**
+   * @brief Waits for the threads to finish, if they were started.
+   */
+  ~thread_group(void);
+
+  thread_group(const thread_group& other) = delete;
+  thread_group& operator=(const thread_group& other) = delete;
+
+  /**
+   * @brief Compute which CPU each thread of a group goes on.
+   *
+   * @return The CPU ID for each rank.
+   */
+  static std::vector<int> cpus_assign(const cpu_topology& topo,
+                                      std::size_t n_threads,
+                                      placement::value policy);
+
+  /**
+   * @brief Start all threads running \a body. Can only be called once.
+   *
+   * @return \ref OK if all threads were started, \ref ERROR otherwise.
+   */
+  status_t start(const body_type& body);
+
+  /**
+   * @brief Wait for all threads to return from the body.
+   */
+  void join(void);
+
+  std::size_t size(void) const { return m_members.size(); }
+
+  /**
+   * @brief Get the CPU/node assignment of each thread.
+   */
+  const member& at(std::size_t rank) const { return m_members[rank]; }
+
+ private:
+  class runner;
+
+  /* data members */
+  std::vector<member>                  m_members{};
+  std::vector<std::unique_ptr<runner>> m_runners{};
+  body_type                            m_body{};
+  std::size_t                          m_n_started{0};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_THREAD_GROUP_HPP_ */
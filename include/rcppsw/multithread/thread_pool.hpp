@@ -0,0 +1,189 @@
+/**
+ * @file thread_pool.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_THREAD_POOL_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_THREAD_POOL_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+class task_group;
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class thread_pool
+ * @ingroup multithread
+ *
+ * @brief A fixed set of long-lived worker threads that run submitted tasks,
+ * balancing the load between them by work stealing.
+ *
+ * Each worker (a \ref threadable) has its own \ref ws_deque. Tasks submitted
+ * from inside a task go onto the submitting worker's deque, and it runs them
+ * newest first; idle workers steal the oldest tasks from a random victim's
+ * deque. Tasks submitted from outside the pool go onto a shared injection
+ * queue. Workers that find nothing to do sleep on a condition variable, which
+ * submitters only touch if some worker is actually asleep.
+ *
+ * Tasks must not throw. Waiting for tasks from inside a task (\ref wait_all(),
+ * \ref task_group::wait()) runs other pending tasks while waiting rather than
+ * blocking the worker, so nested parallelism does not deadlock.
+ */
+class thread_pool {
+ public:
+  typedef std::function<void(void)> task_type;
+
+  /**
+   * @param n_threads # of worker threads; 0 means one per hardware thread.
+   * @param pin If \c TRUE, bind worker i to core i (mod the # of cores).
+   */
+  explicit thread_pool(std::size_t n_threads = 0, bool pin = false);
+
+  /**
+   * @brief Waits for all pending tasks to finish, then stops the workers.
+   */
+  ~thread_pool(void);
+
+  thread_pool(const thread_pool& other) = delete;
+  thread_pool& operator=(const thread_pool& other) = delete;
+
+  /**
+   * @brief Get a pool shared by everything in the library (and application)
+   * that does not need a pool of its own, created on first use with one thread
+   * per hardware thread.
+   */
+  static thread_pool& instance(void);
+
+  /**
+   * @brief Queue a task to be run by one of the workers.
+   */
+  void submit(task_type fn) { task_submit(new task{std::move(fn), nullptr}); }
+
+  /**
+   * @brief Wait until all tasks submitted so far (and any tasks they submit)
+   * have finished.
+   */
+  void wait_all(void);
+
+  /**
+   * @brief Run a single pending task in the calling thread, if there is one.
+   *
+   * @return \c TRUE if a task was run.
+   */
+  bool help(void);
+
+  /**
+   * @brief Determine if the calling thread is one of this pool's workers.
+   */
+  bool in_pool(void) const;
+
+  std::size_t n_threads(void) const { return m_workers.size(); }
+
+  /**
+   * @brief Get the # of tasks that have been submitted but not finished.
+   */
+  std::size_t n_pending(void) const {
+    return m_n_pending.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class task_group;
+
+  struct task {
+    task_type fn;
+    task_group* group;
+  };
+  class worker;
+
+  /**
+   * @brief # of times an idle worker looks for work again before going to
+   * sleep.
+   */
+  static constexpr std::size_t kSPIN_ROUNDS = 16;
+
+  /**
+   * @brief Get the worker that the calling thread is (NULL if it is not a
+   * worker of any pool).
+   */
+  static worker*& current(void);
+
+  void task_submit(task* t);
+
+  /**
+   * @brief Find a task to run: from the calling worker's own deque, the
+   * injection queue, or another worker's deque, in that order.
+   *
+   * @param self The calling worker, or NULL if it is not a worker.
+   *
+   * @return The task, or NULL if there is nothing to do.
+   */
+  task* task_find(worker* self);
+
+  /**
+   * @brief Run a task, and account for it having finished.
+   */
+  void task_run(task* t);
+
+  /**
+   * @brief Main loop for a worker.
+   */
+  void worker_main(worker* self);
+
+  /**
+   * @brief Put a worker to sleep until there may be work, unless something has
+   * been submitted since it read \a epoch.
+   */
+  void idle_wait(uint64_t epoch);
+
+  /* data members */
+  std::vector<std::unique_ptr<worker>> m_workers{};
+
+  boost::mutex              m_inject_mtx{};
+  std::deque<task*>         m_inject{};
+  std::atomic<std::size_t>  m_n_injected{0};
+
+  std::atomic<std::size_t>  m_n_pending{0};
+  std::atomic<uint64_t>     m_epoch{0};
+  std::atomic<std::size_t>  m_n_sleeping{0};
+  std::atomic<bool>         m_stop{false};
+  boost::mutex              m_mtx{};
+  boost::condition_variable m_wake_cv{};
+  boost::condition_variable m_idle_cv{};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_THREAD_POOL_HPP_ */
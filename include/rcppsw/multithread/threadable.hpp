@@ -27,6 +27,10 @@
 #include <pthread.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
+#include <boost/thread/mutex.hpp>
+#include <atomic>
+#include <functional>
+#include <vector>
 #include "rcppsw/common/common.hpp"
 
 /*******************************************************************************
@@ -80,6 +84,25 @@ class threadable {
    */
   void join(void) { pthread_join(m_thread, nullptr); }
 
+  /**
+   * @brief Register a callback to be run when the thread finishes (returns
+   * from \ref thread_main() or calls \ref exit()), for callers that cannot
+   * block in \ref join(). The callback runs in the exiting thread, or right
+   * away in the calling thread if the thread has already finished.
+   */
+  void on_exit(std::function<void(void)> cb);
+
+  /**
+   * @brief Determine if the thread has finished. It still needs to be joined.
+   */
+  bool exited(void) const;
+
+  /**
+   * @brief Determine if the thread has been successfully started (it may have
+   * finished since).
+   */
+  bool started(void) const;
+
  protected:
   /**
    * @brief Check if a thread object has been told to terminate elsewhere.
@@ -94,6 +117,7 @@ class threadable {
    */
   __noreturn void exit(void* ret = nullptr) {
     m_thread_run = false;
+    exited_notify();
     if (nullptr == ret) {
       int ret2;
       pthread_exit(&ret2);
@@ -119,12 +143,20 @@ class threadable {
  private:
   static void* entry_point(void* this_p) {
     auto* pt = static_cast<threadable*>(this_p);
-    return pt->thread_main(pt->m_arg);
+    void* ret = pt->thread_main(pt->m_arg);
+    pt->exited_notify();
+    return ret;
   } /* entry_point() */
 
-  bool m_thread_run{false};
+  void exited_notify(void);
+
+  std::atomic<bool> m_thread_run{false};
   pthread_t m_thread{};
   void* m_arg{nullptr};
+  bool m_started{false};
+  bool m_exited{false};
+  mutable boost::mutex m_exit_mtx{};
+  std::vector<std::function<void(void)>> m_exit_cbs{};
 };
 
 NS_END(multithread, rcppsw);
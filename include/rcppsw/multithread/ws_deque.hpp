@@ -0,0 +1,225 @@
+/**
+ * @file ws_deque.hpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+#ifndef INCLUDE_RCPPSW_MULTITHREAD_WS_DEQUE_HPP_
+#define INCLUDE_RCPPSW_MULTITHREAD_WS_DEQUE_HPP_
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "rcppsw/common/common.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @class ws_deque
+ * @ingroup multithread
+ *
+ * @brief A Chase-Lev work-stealing deque: one owner thread pushes and pops at
+ * the bottom (LIFO, so it works on what is hot in its cache), while any
+ * number of thief threads steal from the top (FIFO, so they take the oldest,
+ * usually biggest, pieces of work).
+ *
+ * The owner only needs a CAS when it pops the last element and may be racing a
+ * thief for it; thieves CAS on the top index. This is the formulation with C11
+ * atomics from Le et al., "Correct and Efficient Work-Stealing for Weak Memory
+ * Models" (PPoPP 2013).
+ *
+ * The buffer grows (never shrinks) when the owner pushes onto a full deque.
+ * Thieves may still be reading an old buffer after it is replaced, so old
+ * buffers are kept until the deque is destroyed; since each is half the size
+ * of the next, this at most doubles the memory used.
+ *
+ * Elements are copied in and out with relaxed atomic loads/stores, so \a T
+ * must be trivially copyable (in practice, a pointer).
+ */
+template <typename T>
+class ws_deque {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "ws_deque elements must be trivially copyable");
+
+ public:
+  /**
+   * @param capacity Initial capacity (rounded up to the next power of 2).
+   */
+  explicit ws_deque(std::size_t capacity = 256)
+      : m_array(new array(round_pow2(capacity))) {
+    m_retired.emplace_back(m_array.load(std::memory_order_relaxed));
+  }
+
+  ws_deque(const ws_deque& other) = delete;
+  ws_deque& operator=(const ws_deque& other) = delete;
+
+  /**
+   * @brief Push an element onto the bottom of the deque. Owner only.
+   */
+  void push(T val) {
+    int64_t b = m_bottom.load(std::memory_order_relaxed);
+    int64_t t = m_top.load(std::memory_order_acquire);
+    array* a = m_array.load(std::memory_order_relaxed);
+    if (b - t > static_cast<int64_t>(a->mask)) {
+      a = grow(a, t, b);
+    }
+    a->put(b, val);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Pop the element at the bottom of the deque. Owner only.
+   *
+   * @param val To be filled with the element.
+   *
+   * @return \c FALSE if the deque was empty (or the last element was stolen
+   * out from under us).
+   */
+  bool pop(T* const val) {
+    int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+    array* a = m_array.load(std::memory_order_relaxed);
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = m_top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      /* empty */
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    *val = a->get(b);
+    if (t < b) {
+      return true;
+    }
+
+    /* last element: race any thieves for it */
+    bool won = m_top.compare_exchange_strong(t,
+                                             t + 1,
+                                             std::memory_order_seq_cst,
+                                             std::memory_order_relaxed);
+    m_bottom.store(b + 1, std::memory_order_relaxed);
+    return won;
+  }
+
+  /**
+   * @brief Steal the element at the top of the deque. Any thread.
+   *
+   * @param val To be filled with the element.
+   *
+   * @return \c FALSE if the deque was empty, or another thread got the element
+   * first.
+   */
+  bool steal(T* const val) {
+    int64_t t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = m_bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+      return false;
+    }
+    array* a = m_array.load(std::memory_order_acquire);
+    T tmp = a->get(t);
+    if (!m_top.compare_exchange_strong(t,
+                                       t + 1,
+                                       std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+      return false;
+    }
+    *val = tmp;
+    return true;
+  }
+
+  /**
+   * @brief Get the # of elements in the deque. Only approximate if other
+   * threads are using it.
+   */
+  std::size_t size(void) const {
+    int64_t b = m_bottom.load(std::memory_order_relaxed);
+    int64_t t = m_top.load(std::memory_order_relaxed);
+    return (b > t) ? static_cast<std::size_t>(b - t) : 0;
+  }
+  bool empty(void) const { return 0 == size(); }
+  std::size_t capacity(void) const {
+    return m_array.load(std::memory_order_relaxed)->mask + 1;
+  }
+
+ private:
+  struct array {
+    explicit array(std::size_t cap)
+        : mask(static_cast<int64_t>(cap) - 1),
+          data(new std::atomic<T>[cap]) {}
+
+    T get(int64_t i) const {
+      return data[i & mask].load(std::memory_order_relaxed);
+    }
+    void put(int64_t i, T val) {
+      data[i & mask].store(val, std::memory_order_relaxed);
+    }
+
+    const int64_t mask;
+    std::unique_ptr<std::atomic<T>[]> data;
+  };
+
+  static std::size_t round_pow2(std::size_t n) {
+    std::size_t ret = 2;
+    while (ret < n) {
+      ret <<= 1;
+    } /* while() */
+    return ret;
+  }
+
+  /**
+   * @brief Replace the buffer with one twice as big, holding the elements in
+   * [top, bottom).
+   */
+  array* grow(array* old, int64_t t, int64_t b) {
+    auto* a = new array(static_cast<std::size_t>(old->mask + 1) * 2);
+    for (int64_t i = t; i < b; ++i) {
+      a->put(i, old->get(i));
+    } /* for(i..) */
+    m_retired.emplace_back(a);
+    m_array.store(a, std::memory_order_release);
+    return a;
+  }
+
+  /* data members */
+  static constexpr std::size_t kCACHE_LINE = 64;
+
+  std::atomic<int64_t> m_top{0};
+  char m_pad0[kCACHE_LINE - sizeof(std::atomic<int64_t>)]{};
+  std::atomic<int64_t> m_bottom{0};
+  char m_pad1[kCACHE_LINE - sizeof(std::atomic<int64_t>)]{};
+  std::atomic<array*> m_array;
+
+  /** Every buffer ever used (including the current one), owner only. */
+  std::vector<std::unique_ptr<array>> m_retired{};
+};
+
+NS_END(multithread, rcppsw);
+
+#endif /* INCLUDE_RCPPSW_MULTITHREAD_WS_DEQUE_HPP_ */
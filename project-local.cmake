@@ -9,9 +9,25 @@ add_subdirectory(ext/rcsw)
 include_directories(${rcsw_INCLUDE_DIRS})
 
 # Boost
-find_package(Boost 1.58.0 COMPONENTS system filesystem thread)
+find_package(Boost 1.58.0 COMPONENTS system filesystem thread program_options)
 set(Boost_USE_STATIC_LIBS OFF)
 
+################################################################################
+# Event Reporting                                                              #
+################################################################################
+# Least severe ER level compiled in (see rcppsw/er/client.hpp). Can be
+# overridden for individual submodules via RCPPSW_ER_MIN_LVL_<submodule>.
+set(RCPPSW_ER_MIN_LVL "5" CACHE STRING
+  "Least severe ER level to compile in [0=OFF,1=ERR,...,5=VER]")
+
+# Asynchronous logfile writes via io_uring (see rcppsw/er/async_file_sink.hpp).
+if (WITH_IO_URING)
+  find_library(LIBURING uring)
+  if (NOT LIBURING)
+    message(WARNING "liburing not found: ER logfile writes will block")
+  endif()
+endif()
+
 ################################################################################
 # Includes                                                                     #
 ################################################################################
@@ -42,14 +58,33 @@ foreach(d ${${target}_pattern_SUBDIRS})
   target_include_directories(${target}-${d} PUBLIC "${${target}_INCLUDE_DIRS}")
 endforeach()
 
+foreach(d ${${target}_SUBDIRS} ${${target}_pattern_SUBDIRS})
+  if (DEFINED RCPPSW_ER_MIN_LVL_${d})
+    target_compile_definitions(${target}-${d} PRIVATE
+      RCPPSW_ER_MIN_LVL=${RCPPSW_ER_MIN_LVL_${d}})
+  else()
+    target_compile_definitions(${target}-${d} PRIVATE
+      RCPPSW_ER_MIN_LVL=${RCPPSW_ER_MIN_LVL})
+  endif()
+endforeach()
+
+if (LIBURING)
+  target_compile_definitions(${target}-er PRIVATE RCPPSW_WITH_IO_URING)
+endif()
+
 ################################################################################
 # Libraries                                                                    #
 ################################################################################
 set(${target}_LIBS
   rcsw
   ${Boost_LIBRARIES}
+  rt # shm_open() for er::shm_server on older glibc
   )
 
+if (LIBURING)
+  list(APPEND ${target}_LIBS ${LIBURING})
+endif()
+
 if (NOT TARGET${target})
   add_library(${target}
     $<TARGET_OBJECTS:${target}-er>
@@ -62,6 +97,14 @@ if (NOT TARGET${target})
   target_link_libraries(${target} "${${target}_LIBS}")
 endif()
 
+################################################################################
+# Tools                                                                        #
+################################################################################
+# Decoder for binary ER logs (see rcppsw/er/binlog_writer.hpp)
+add_executable(er-decode ${CMAKE_CURRENT_SOURCE_DIR}/src/er/tools/er_decode.cpp)
+target_include_directories(er-decode PUBLIC "${${target}_INCLUDE_DIRS}")
+target_link_libraries(er-decode ${target} ${Boost_LIBRARIES})
+
 ################################################################################
 # Exports                                                                      #
 ################################################################################
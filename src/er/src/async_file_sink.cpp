@@ -0,0 +1,288 @@
+/**
+ * @file async_file_sink.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/async_file_sink.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#ifdef RCPPSW_WITH_IO_URING
+#include <liburing.h>
+#endif
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+#ifdef RCPPSW_WITH_IO_URING
+struct async_file_sink::io_state {
+  /**
+   * @brief An I/O buffer and the write it is currently the source for.
+   */
+  struct slot {
+    std::vector<char> buf{};
+    std::size_t len{0};
+    std::size_t done{0};
+    off_t offset{0};
+    uint64_t submit_ns{0};
+    bool busy{false};
+  };
+
+  explicit io_state(std::size_t capacity) : slots(kQUEUE_DEPTH) {
+    for (auto& s : slots) {
+      s.buf.resize(capacity);
+    } /* for(s..) */
+    ready = (0 == io_uring_queue_init(kQUEUE_DEPTH, &ring, 0));
+  }
+  ~io_state(void) {
+    if (ready) {
+      io_uring_queue_exit(&ring);
+    }
+  }
+
+  struct io_uring ring {};
+  bool ready{false};
+  std::vector<slot> slots;
+};
+#else
+struct async_file_sink::io_state {};
+#endif /* RCPPSW_WITH_IO_URING */
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+namespace {
+uint64_t now_ns(void) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+} /* now_ns() */
+} // namespace
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+constexpr std::size_t async_file_sink::kQUEUE_DEPTH;
+
+async_file_sink::async_file_sink(const std::string& fname,
+                                 bool sync_on_err,
+                                 std::size_t capacity,
+                                 uint32_t interval_ms)
+    : buffered_sink(capacity, interval_ms, sync_on_err),
+      m_fname(fname),
+      m_fd(::open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  0644)),
+      m_io() {
+#ifdef RCPPSW_WITH_IO_URING
+  if (is_open()) {
+    std::unique_ptr<io_state> io(new io_state(capacity));
+    if (io->ready) {
+      m_io = std::move(io);
+    }
+  }
+#endif
+}
+
+async_file_sink::~async_file_sink(void) {
+  flush();
+  m_io.reset();
+  if (is_open()) {
+    ::close(m_fd);
+  }
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void async_file_sink::flush(void) {
+  buffered_sink::flush();
+  boost::lock_guard<boost::mutex> lock(m_io_mtx);
+  drain();
+} /* flush() */
+
+void async_file_sink::sink_sync(void) {
+  boost::lock_guard<boost::mutex> lock(m_io_mtx);
+  drain();
+  if (is_open()) {
+    ::fsync(m_fd);
+  }
+} /* sink_sync() */
+
+double async_file_sink::mean_latency_us(void) const {
+  uint64_t n = n_writes();
+  if (0 == n) {
+    return 0.0;
+  }
+  return m_lat_total_ns.load(std::memory_order_relaxed) / 1000.0 / n;
+} /* mean_latency_us() */
+
+void async_file_sink::latency_record(uint64_t ns) {
+  m_n_writes.fetch_add(1, std::memory_order_relaxed);
+  m_lat_total_ns.fetch_add(ns, std::memory_order_relaxed);
+  uint64_t max = m_lat_max_ns.load(std::memory_order_relaxed);
+  while (ns > max && !m_lat_max_ns.compare_exchange_weak(
+                         max, ns, std::memory_order_relaxed)) {
+  } /* while() */
+} /* latency_record() */
+
+void async_file_sink::blocking_write(const char* data, std::size_t len) {
+  uint64_t start = now_ns();
+  while (len > 0) {
+    ssize_t n = ::pwrite(m_fd, data, len, m_offset);
+    if (n < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      m_n_errors.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    m_offset += n;
+    data += n;
+    len -= static_cast<std::size_t>(n);
+  } /* while() */
+  latency_record(now_ns() - start);
+} /* blocking_write() */
+
+#ifdef RCPPSW_WITH_IO_URING
+void async_file_sink::sink_write(const char* data, std::size_t len) {
+  if (!is_open()) {
+    return;
+  }
+  boost::lock_guard<boost::mutex> lock(m_io_mtx);
+  if (nullptr == m_io) {
+    blocking_write(data, len);
+    return;
+  }
+  while (len > 0) {
+    std::size_t idx = slot_acquire();
+    auto& s = m_io->slots[idx];
+    s.len = std::min(len, s.buf.size());
+    std::memcpy(s.buf.data(), data, s.len);
+    s.done = 0;
+    s.offset = m_offset;
+    s.submit_ns = now_ns();
+    m_offset += static_cast<off_t>(s.len);
+    data += s.len;
+    len -= s.len;
+    slot_submit(idx);
+  } /* while() */
+
+  /* pick up whatever has finished in the meantime, without waiting */
+  while (reap(false)) {
+  } /* while() */
+} /* sink_write() */
+
+std::size_t async_file_sink::slot_acquire(void) {
+  while (true) {
+    for (std::size_t i = 0; i < m_io->slots.size(); ++i) {
+      if (!m_io->slots[i].busy) {
+        m_io->slots[i].busy = true;
+        return i;
+      }
+    } /* for(i..) */
+    reap(true);
+  } /* while() */
+} /* slot_acquire() */
+
+void async_file_sink::slot_submit(std::size_t idx) {
+  io_state::slot* s = &m_io->slots[idx];
+  struct io_uring_sqe* sqe = io_uring_get_sqe(&m_io->ring);
+  if (nullptr != sqe) {
+    io_uring_prep_write(sqe,
+                        m_fd,
+                        s->buf.data() + s->done,
+                        static_cast<unsigned>(s->len - s->done),
+                        static_cast<uint64_t>(s->offset) + s->done);
+    io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(idx));
+    if (io_uring_submit(&m_io->ring) >= 0) {
+      std::size_t depth = m_depth.fetch_add(1, std::memory_order_relaxed) + 1;
+      if (depth > m_max_depth.load(std::memory_order_relaxed)) {
+        m_max_depth.store(depth, std::memory_order_relaxed);
+      }
+      return;
+    }
+  }
+  /* could not submit; never lose log data over it */
+  off_t end = m_offset;
+  m_offset = s->offset + static_cast<off_t>(s->done);
+  blocking_write(s->buf.data() + s->done, s->len - s->done);
+  m_offset = end;
+  s->busy = false;
+} /* slot_submit() */
+
+bool async_file_sink::reap(bool wait) {
+  struct io_uring_cqe* cqe = nullptr;
+  int rc = wait ? io_uring_wait_cqe(&m_io->ring, &cqe)
+                : io_uring_peek_cqe(&m_io->ring, &cqe);
+  if (rc < 0 || nullptr == cqe) {
+    return false;
+  }
+  auto idx = reinterpret_cast<std::size_t>(io_uring_cqe_get_data(cqe));
+  io_state::slot* s = &m_io->slots[idx];
+  int res = cqe->res;
+  io_uring_cqe_seen(&m_io->ring, cqe);
+  m_depth.fetch_sub(1, std::memory_order_relaxed);
+
+  if (-EINTR == res || -EAGAIN == res) {
+    slot_submit(idx);
+  } else if (res <= 0) {
+    m_n_errors.fetch_add(1, std::memory_order_relaxed);
+    s->busy = false;
+  } else if ((s->done += static_cast<std::size_t>(res)) < s->len) {
+    /* short write: submit the rest */
+    slot_submit(idx);
+  } else {
+    latency_record(now_ns() - s->submit_ns);
+    s->busy = false;
+  }
+  return true;
+} /* reap() */
+
+void async_file_sink::drain(void) {
+  while (nullptr != m_io && queue_depth() > 0) {
+    reap(true);
+  } /* while() */
+} /* drain() */
+
+#else
+void async_file_sink::sink_write(const char* data, std::size_t len) {
+  if (!is_open()) {
+    return;
+  }
+  boost::lock_guard<boost::mutex> lock(m_io_mtx);
+  blocking_write(data, len);
+} /* sink_write() */
+
+void async_file_sink::drain(void) {}
+#endif /* RCPPSW_WITH_IO_URING */
+
+NS_END(er, rcppsw);
@@ -0,0 +1,201 @@
+/**
+ * @file binlog_reader.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/binlog_reader.hpp"
+#include "rcppsw/er/deferred_formatter.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+binlog_reader::binlog_reader(const std::string& fname)
+    : binlog_reader(fname, filter()) {}
+
+binlog_reader::binlog_reader(const std::string& fname, const filter& f)
+    : m_in(fname, std::ios::binary), m_filter(f) {
+  char buf[binlog_format::kFILE_HEADER_SIZE];
+  const char* p = buf;
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  if (m_in.read(buf, sizeof(buf))) {
+    binlog_format::get(&p, buf + sizeof(buf), &magic);
+    binlog_format::get(&p, buf + sizeof(buf), &version);
+  }
+  m_valid = binlog_format::kFILE_MAGIC == magic &&
+            binlog_format::kVERSION == version;
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool binlog_reader::next(record* const rec) {
+  while (m_valid) {
+    if (m_pos >= m_body.size() && !block_load()) {
+      return false;
+    }
+    const char* p = m_body.data() + m_pos;
+    const char* end = m_body.data() + m_body.size();
+    uint32_t handle = 0;
+    uint8_t lvl = 0;
+    uint8_t kind = 0;
+    uint16_t fmt_id = 0;
+    uint32_t len = 0;
+    std::string payload;
+    if (!(binlog_format::get(&p, end, &rec->ts) &&
+          binlog_format::get(&p, end, &handle) &&
+          binlog_format::get(&p, end, &lvl) &&
+          binlog_format::get(&p, end, &kind) &&
+          binlog_format::get(&p, end, &fmt_id) &&
+          binlog_format::get(&p, end, &len) &&
+          binlog_format::get(&p, end, len, &payload))) {
+      /* corrupt block; try the next one */
+      m_pos = m_body.size();
+      continue;
+    }
+    m_pos = static_cast<std::size_t>(p - m_body.data());
+
+    auto mod = m_mods.find(handle);
+    if (rec->ts < m_filter.ts_min || rec->ts > m_filter.ts_max ||
+        lvl > m_filter.lvl || mod == m_mods.end() ||
+        (!m_filter.module.empty() && mod->second != m_filter.module)) {
+      continue;
+    }
+
+    rec->lvl = static_cast<er_lvl::value>(lvl);
+    rec->module = mod->second;
+    if (binlog_format::DEFERRED == kind && fmt_id < m_fmts.size()) {
+      const fmt_entry& e = m_fmts[fmt_id];
+      fmt_descriptor desc = {
+          e.file.c_str(), e.line, e.func.c_str(), e.fmt.c_str()};
+      rec->text = deferred_formatter::format(desc, payload);
+    } else {
+      rec->text = std::move(payload);
+    }
+    return true;
+  } /* while() */
+  return false;
+} /* next() */
+
+bool binlog_reader::block_load(void) {
+  binlog_format::block_header hdr;
+  char buf[binlog_format::kBLOCK_HEADER_SIZE];
+  std::string dict;
+
+  while (m_in.read(buf, sizeof(buf))) {
+    if (!binlog_format::header_decode(buf, &hdr)) {
+      return false;
+    }
+    if (!block_match(hdr)) {
+      block_skip(hdr.body_size);
+      continue;
+    }
+
+    dict.resize(hdr.dict_size);
+    if (!m_in.read(&dict[0], hdr.dict_size) || !dict_decode(dict, hdr)) {
+      return false;
+    }
+
+    /* the module filter can only be checked once we know the handles */
+    bool want = m_filter.module.empty();
+    for (auto& mod : m_mods) {
+      if (mod.second == m_filter.module &&
+          (hdr.module_mask & binlog_format::module_bit(mod.first))) {
+        want = true;
+      }
+    } /* for(mod..) */
+    if (!want) {
+      block_skip(hdr.body_size - hdr.dict_size);
+      continue;
+    }
+
+    m_body.resize(hdr.body_size - hdr.dict_size);
+    if (!m_in.read(&m_body[0], m_body.size())) {
+      return false;
+    }
+    m_pos = 0;
+    ++m_n_read;
+    return true;
+  } /* while() */
+  return false;
+} /* block_load() */
+
+void binlog_reader::block_skip(std::size_t n) {
+  m_in.seekg(static_cast<std::streamoff>(n), std::ios::cur);
+  ++m_n_skipped;
+} /* block_skip() */
+
+bool binlog_reader::block_match(const binlog_format::block_header& hdr) const {
+  /* levels OFF..lvl */
+  auto lvls = static_cast<uint8_t>((1 << (m_filter.lvl + 1)) - 1);
+  return hdr.ts_max >= m_filter.ts_min && hdr.ts_min <= m_filter.ts_max &&
+         0 != (hdr.lvl_mask & lvls);
+} /* block_match() */
+
+bool binlog_reader::dict_decode(const std::string& dict,
+                                const binlog_format::block_header& hdr) {
+  const char* p = dict.data();
+  const char* end = p + dict.size();
+  m_mods.clear();
+  m_fmts.clear();
+
+  for (uint16_t i = 0; i < hdr.n_modules; ++i) {
+    uint32_t handle = 0;
+    uint16_t len = 0;
+    std::string name;
+    if (!(binlog_format::get(&p, end, &handle) &&
+          binlog_format::get(&p, end, &len) &&
+          binlog_format::get(&p, end, len, &name))) {
+      return false;
+    }
+    m_mods[handle] = std::move(name);
+  } /* for(i..) */
+
+  for (uint16_t i = 0; i < hdr.n_formats; ++i) {
+    uint16_t id = 0;
+    uint32_t line = 0;
+    uint16_t file_len = 0;
+    uint16_t func_len = 0;
+    uint16_t fmt_len = 0;
+    fmt_entry e;
+    if (!(binlog_format::get(&p, end, &id) &&
+          binlog_format::get(&p, end, &line) &&
+          binlog_format::get(&p, end, &file_len) &&
+          binlog_format::get(&p, end, &func_len) &&
+          binlog_format::get(&p, end, &fmt_len) &&
+          binlog_format::get(&p, end, file_len, &e.file) &&
+          binlog_format::get(&p, end, func_len, &e.func) &&
+          binlog_format::get(&p, end, fmt_len, &e.fmt)) ||
+        id != m_fmts.size()) {
+      return false;
+    }
+    e.line = static_cast<int>(line);
+    m_fmts.push_back(std::move(e));
+  } /* for(i..) */
+  return true;
+} /* dict_decode() */
+
+NS_END(er, rcppsw);
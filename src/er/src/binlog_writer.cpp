@@ -0,0 +1,178 @@
+/**
+ * @file binlog_writer.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/binlog_writer.hpp"
+#include <algorithm>
+#include <cstring>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+constexpr std::size_t binlog_writer::kDEFAULT_BLOCK_SIZE;
+constexpr uint32_t binlog_writer::kDEFAULT_INTERVAL_MS;
+
+binlog_writer::binlog_writer(std::unique_ptr<sink> out,
+                             std::size_t block_size,
+                             uint32_t interval_ms)
+    : m_out(std::move(out)),
+      mc_block_size(block_size),
+      mc_interval(interval_ms) {
+  std::string hdr;
+  binlog_format::put(&hdr, binlog_format::kFILE_MAGIC);
+  binlog_format::put(&hdr, binlog_format::kVERSION);
+  m_out->write(hdr.data(), hdr.size(), er_lvl::NOM);
+  m_records.reserve(mc_block_size);
+}
+
+binlog_writer::~binlog_writer(void) { flush(); }
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void binlog_writer::record(uint64_t ts,
+                           mod_handle handle,
+                           const std::string& mod_name,
+                           const server::msg_int& msg) {
+  boost::lock_guard<boost::mutex> lock(m_mtx);
+
+  /*
+   * Module handles are reused after removal, and the dictionaries only have
+   * room for so many entries, so start a new block if this record would not
+   * fit in the current one.
+   */
+  auto it = m_mods.find(handle);
+  if ((it != m_mods.end() && it->second != mod_name) ||
+      m_records.size() + binlog_format::kRECORD_HEADER_SIZE + msg.str.size() >
+          mc_block_size ||
+      m_mods.size() == UINT16_MAX || m_fmts.size() == UINT16_MAX) {
+    block_flush();
+  }
+  if (0 == m_hdr.n_records) {
+    m_oldest = clock_type::now();
+  }
+  m_mods[handle] = mod_name;
+
+  bool deferred = (nullptr != msg.fmt);
+  binlog_format::put(&m_records, ts);
+  binlog_format::put(&m_records, handle);
+  binlog_format::put(&m_records, static_cast<uint8_t>(msg.lvl));
+  binlog_format::put(&m_records,
+                     deferred ? binlog_format::DEFERRED : binlog_format::TEXT);
+  binlog_format::put(&m_records,
+                     static_cast<uint16_t>(deferred ? fmt_id(msg.fmt) : 0));
+  binlog_format::put(&m_records, static_cast<uint32_t>(msg.str.size()));
+  m_records.append(msg.str);
+
+  ++m_hdr.n_records;
+  m_hdr.ts_min = std::min(m_hdr.ts_min, ts);
+  m_hdr.ts_max = std::max(m_hdr.ts_max, ts);
+  m_hdr.module_mask |= binlog_format::module_bit(handle);
+  m_hdr.lvl_mask |= binlog_format::lvl_bit(msg.lvl);
+
+  if (er_lvl::ERR == msg.lvl) {
+    block_flush();
+  }
+} /* record() */
+
+void binlog_writer::flush(void) {
+  boost::lock_guard<boost::mutex> lock(m_mtx);
+  block_flush();
+  m_out->flush();
+} /* flush() */
+
+void binlog_writer::poll(void) {
+  boost::lock_guard<boost::mutex> lock(m_mtx);
+  if (m_hdr.n_records > 0 && mc_interval.count() > 0 &&
+      clock_type::now() - m_oldest >= mc_interval) {
+    block_flush();
+  }
+  m_out->poll();
+} /* poll() */
+
+uint16_t binlog_writer::fmt_id(const fmt_descriptor* desc) {
+  auto it = m_fmt_ids.find(desc);
+  if (it != m_fmt_ids.end()) {
+    return it->second;
+  }
+  auto id = static_cast<uint16_t>(m_fmts.size());
+  m_fmt_ids[desc] = id;
+  m_fmts.push_back(desc);
+  return id;
+} /* fmt_id() */
+
+void binlog_writer::dict_encode(std::string* const buf) const {
+  for (auto& mod : m_mods) {
+    binlog_format::put(buf, static_cast<uint32_t>(mod.first));
+    binlog_format::put(buf, static_cast<uint16_t>(mod.second.size()));
+    buf->append(mod.second);
+  } /* for(mod..) */
+
+  for (std::size_t i = 0; i < m_fmts.size(); ++i) {
+    const fmt_descriptor* desc = m_fmts[i];
+    std::size_t file_len = std::strlen(desc->file);
+    std::size_t func_len = std::strlen(desc->func);
+    std::size_t fmt_len = std::strlen(desc->fmt);
+    binlog_format::put(buf, static_cast<uint16_t>(i));
+    binlog_format::put(buf, static_cast<uint32_t>(desc->line));
+    binlog_format::put(buf, static_cast<uint16_t>(file_len));
+    binlog_format::put(buf, static_cast<uint16_t>(func_len));
+    binlog_format::put(buf, static_cast<uint16_t>(fmt_len));
+    buf->append(desc->file, file_len);
+    buf->append(desc->func, func_len);
+    buf->append(desc->fmt, fmt_len);
+  } /* for(i..) */
+} /* dict_encode() */
+
+void binlog_writer::block_flush(void) {
+  if (0 == m_hdr.n_records) {
+    return;
+  }
+  std::string dict;
+  dict_encode(&dict);
+  m_hdr.n_modules = static_cast<uint16_t>(m_mods.size());
+  m_hdr.n_formats = static_cast<uint16_t>(m_fmts.size());
+  m_hdr.dict_size = static_cast<uint32_t>(dict.size());
+  m_hdr.body_size = static_cast<uint32_t>(dict.size() + m_records.size());
+
+  std::string block;
+  block.reserve(binlog_format::kBLOCK_HEADER_SIZE + m_hdr.body_size);
+  binlog_format::header_encode(m_hdr, &block);
+  block.append(dict);
+  block.append(m_records);
+
+  bool has_err = 0 != (m_hdr.lvl_mask & binlog_format::lvl_bit(er_lvl::ERR));
+  m_out->write(block.data(), block.size(), has_err ? er_lvl::ERR : er_lvl::NOM);
+
+  m_hdr = binlog_format::block_header();
+  m_records.clear();
+  m_mods.clear();
+  m_fmt_ids.clear();
+  m_fmts.clear();
+} /* block_flush() */
+
+NS_END(er, rcppsw);
@@ -0,0 +1,101 @@
+/**
+ * @file buffered_sink.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/buffered_sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+constexpr std::size_t buffered_sink::kDEFAULT_CAPACITY;
+constexpr uint32_t buffered_sink::kDEFAULT_INTERVAL_MS;
+
+buffered_sink::buffered_sink(std::size_t capacity,
+                             uint32_t interval_ms,
+                             bool sync_on_err)
+    : m_capacity(capacity),
+      m_interval(interval_ms),
+      m_sync_on_err(sync_on_err) {
+  m_buf.reserve(m_capacity);
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void buffered_sink::write(const char* data,
+                          std::size_t len,
+                          er_lvl::value lvl) {
+  boost::lock_guard<boost::mutex> lock(m_mtx);
+  if (m_buf.size() + len > m_capacity) {
+    flush_locked();
+  }
+
+  /* records too big to ever fit bypass the buffer */
+  if (len > m_capacity) {
+    sink_write(data, len);
+  } else {
+    if (m_buf.empty()) {
+      m_oldest = clock_type::now();
+    }
+    m_buf.insert(m_buf.end(), data, data + len);
+  }
+
+  if (er_lvl::ERR == lvl) {
+    flush_locked();
+    if (m_sync_on_err) {
+      sink_sync();
+    }
+  } else if (expired()) {
+    flush_locked();
+  }
+} /* write() */
+
+void buffered_sink::flush(void) {
+  boost::lock_guard<boost::mutex> lock(m_mtx);
+  flush_locked();
+} /* flush() */
+
+void buffered_sink::poll(void) {
+  boost::lock_guard<boost::mutex> lock(m_mtx);
+  if (expired()) {
+    flush_locked();
+  }
+} /* poll() */
+
+void buffered_sink::flush_locked(void) {
+  if (!m_buf.empty()) {
+    sink_write(m_buf.data(), m_buf.size());
+    m_buf.clear();
+  }
+} /* flush_locked() */
+
+bool buffered_sink::expired(void) const {
+  return !m_buf.empty() && m_interval.count() > 0 &&
+         clock_type::now() - m_oldest >= m_interval;
+} /* expired() */
+
+NS_END(er, rcppsw);
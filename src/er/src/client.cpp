@@ -42,14 +42,41 @@ client::~client(void) = default;
  * Member Functions
  ******************************************************************************/
 status_t client::attmod(const std::string& mod_name) {
+  /* our module may have changed, so force gate refresh */
+  m_gate_gen = 0;
   return server_handle()->findmod(mod_name, m_er_id);
 } /* attmod() */
 
 void client::deferred_init(std::shared_ptr<server> server_handle) {
   m_server_handle = std::move(server_handle);
   m_er_id = m_server_handle->idgen();
+  m_gate_gen = 0;
 } /* deferred_init() */
 
+void client::gate_refresh(void) const {
+  m_gate_gen = m_server_handle->generation();
+  m_handle = m_server_handle->mod_lookup(m_er_id);
+  m_gate = m_server_handle->mod_gate(m_handle);
+  m_limiter = m_server_handle->limiter(m_handle);
+  m_recorder = m_server_handle->recorder();
+} /* gate_refresh() */
+
+bool client::limit_admit(const er_lvl::value& lvl) const {
+  if (!m_limiter->admit(lvl)) {
+    return false;
+  }
+  if (m_limiter->summary_due(timestamp::now())) {
+    uint64_t n = m_limiter->suppressed_take();
+    if (n > 0) {
+      m_server_handle->report(m_er_id,
+                              m_limiter->cfg().lvl,
+                              mod_limiter::summary(n),
+                              m_handle);
+    }
+  }
+  return true;
+} /* limit_admit() */
+
 status_t client::insmod(const std::string& mod_name,
                         const er_lvl::value& loglvl,
                         const er_lvl::value& dbglvl) {
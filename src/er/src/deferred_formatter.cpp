@@ -0,0 +1,287 @@
+/**
+ * @file deferred_formatter.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/deferred_formatter.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "rcppsw/er/deferred_encoder.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+namespace {
+/**
+ * @brief A single decoded argument.
+ */
+struct decoded_arg {
+  deferred_encoder::arg_type type;
+  std::size_t size;
+  int64_t sint;
+  uint64_t uint;
+  double dbl;
+  const void* ptr;
+  std::string str;
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+int64_t read_sint(const char* const p, std::size_t size) {
+  int8_t v8;
+  int16_t v16;
+  int32_t v32;
+  int64_t v64 = 0;
+  switch (size) {
+    case 1:
+      std::memcpy(&v8, p, size);
+      return v8;
+    case 2:
+      std::memcpy(&v16, p, size);
+      return v16;
+    case 4:
+      std::memcpy(&v32, p, size);
+      return v32;
+    default:
+      std::memcpy(&v64, p, std::min(size, sizeof(v64)));
+      return v64;
+  } /* switch() */
+} /* read_sint() */
+
+uint64_t read_uint(const char* const p, std::size_t size) {
+  uint64_t v = 0;
+  /* little endian: the low order bytes come first */
+  std::memcpy(&v, p, std::min(size, sizeof(v)));
+  return v;
+} /* read_uint() */
+
+/**
+ * @brief Decode the next argument.
+ *
+ * @return \c FALSE if there are no more arguments.
+ */
+bool next_arg(const std::string& args, std::size_t* pos, decoded_arg* arg) {
+  if (*pos >= args.size()) {
+    return false;
+  }
+  auto tag = static_cast<uint8_t>(args[(*pos)++]);
+  std::size_t size = deferred_encoder::tag_size(tag);
+  const char* p = args.data() + *pos;
+  if (*pos + size > args.size()) {
+    return false;
+  }
+  *pos += size;
+  arg->type = deferred_encoder::tag_type(tag);
+  arg->size = size;
+
+  switch (arg->type) {
+    case deferred_encoder::SINT:
+      arg->sint = read_sint(p, size);
+      break;
+    case deferred_encoder::UINT:
+      arg->uint = read_uint(p, size);
+      break;
+    case deferred_encoder::DOUBLE:
+      std::memcpy(&arg->dbl, p, sizeof(double));
+      break;
+    case deferred_encoder::PTR:
+      std::memcpy(&arg->ptr, p, sizeof(void*));
+      break;
+    case deferred_encoder::STR: {
+      uint16_t n;
+      std::memcpy(&n, p, sizeof(n));
+      n = static_cast<uint16_t>(std::min<std::size_t>(n, args.size() - *pos));
+      arg->str.assign(args.data() + *pos, n);
+      *pos += n;
+      break;
+    }
+    default:
+      return false;
+  } /* switch() */
+  return true;
+} /* next_arg() */
+
+template <typename T>
+void append(std::string* const out, const std::string& spec, T val) {
+  int n = std::snprintf(nullptr, 0, spec.c_str(), val);
+  if (n <= 0) {
+    return;
+  }
+  std::size_t start = out->size();
+  out->resize(start + static_cast<std::size_t>(n) + 1);
+  std::snprintf(&(*out)[start], static_cast<std::size_t>(n) + 1, spec.c_str(),
+                val);
+  out->resize(start + static_cast<std::size_t>(n));
+} /* append() */
+
+bool is_int_conv(char conv) { return nullptr != std::strchr("diuoxXc", conv); }
+bool is_float_conv(char conv) {
+  return nullptr != std::strchr("fFeEgGaA", conv);
+}
+
+/**
+ * @brief Format a single conversion \a spec (everything but the length
+ * modifier and conversion character) ending in \a conv with \a arg, converting
+ * between the recorded type and what the format string asked for if they
+ * differ.
+ */
+void format_one(std::string* const out,
+                std::string spec,
+                char conv,
+                const decoded_arg& arg) {
+  bool is_signed = (deferred_encoder::SINT == arg.type);
+  uint64_t as_uint = is_signed ? static_cast<uint64_t>(arg.sint) : arg.uint;
+
+  /*
+   * A negative signed argument must not be sign extended past the width it
+   * would have had as a vararg (at least an int), or %x/%u/%o print e.g. -1 as
+   * 64 bits of ones.
+   */
+  std::size_t width = std::max(arg.size, sizeof(int));
+  if (is_signed && width < sizeof(uint64_t)) {
+    as_uint &= (UINT64_C(1) << (width * 8)) - 1;
+  }
+  if (deferred_encoder::PTR == arg.type) {
+    as_uint = reinterpret_cast<uintptr_t>(arg.ptr);
+  }
+
+  if (deferred_encoder::STR == arg.type) {
+    append(out, spec + "s", arg.str.c_str());
+  } else if (deferred_encoder::DOUBLE == arg.type) {
+    if (is_int_conv(conv)) {
+      append(out, spec + "lld", static_cast<long long>(arg.dbl));
+    } else {
+      append(out, spec + (is_float_conv(conv) ? conv : 'g'), arg.dbl);
+    }
+  } else if ('p' == conv) {
+    append(out, spec + "p", reinterpret_cast<void*>(as_uint));
+  } else if ('c' == conv) {
+    append(out, spec + "c", static_cast<int>(as_uint));
+  } else if (is_float_conv(conv)) {
+    double d = is_signed ? static_cast<double>(arg.sint)
+                         : static_cast<double>(as_uint);
+    append(out, spec + conv, d);
+  } else if (('d' == conv || 'i' == conv) && is_signed) {
+    append(out, spec + "lld", static_cast<long long>(arg.sint));
+  } else if (is_int_conv(conv)) {
+    char c = ('d' == conv || 'i' == conv) ? 'u' : conv;
+    append(out, spec + "ll" + c, static_cast<unsigned long long>(as_uint));
+  } else {
+    /* %s with a non-string, etc. */
+    append(out, spec + "llu", static_cast<unsigned long long>(as_uint));
+  }
+} /* format_one() */
+
+/**
+ * @brief Parse a '*' width or precision, consuming an argument for it.
+ */
+void star_arg(std::string* const spec,
+              const std::string& args,
+              std::size_t* const pos) {
+  decoded_arg arg;
+  long long val = 0;
+  if (next_arg(args, pos, &arg)) {
+    val = (deferred_encoder::SINT == arg.type)
+              ? arg.sint
+              : static_cast<long long>(arg.uint);
+  }
+  *spec += std::to_string(val);
+} /* star_arg() */
+} // namespace
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+std::string deferred_formatter::format(const char* fmt,
+                                       const std::string& args) {
+  std::string out;
+  std::size_t pos = 0;
+  const char* p = fmt;
+
+  while ('\0' != *p) {
+    if ('%' != *p) {
+      out.push_back(*p++);
+      continue;
+    } else if ('%' == p[1]) {
+      out.push_back('%');
+      p += 2;
+      continue;
+    }
+
+    /* flags, width, precision; length modifiers are dropped */
+    std::string spec(1, *p++);
+    while ('\0' != *p && nullptr != std::strchr("-+ #0'", *p)) {
+      spec.push_back(*p++);
+    } /* while() */
+    if ('*' == *p) {
+      star_arg(&spec, args, &pos);
+      ++p;
+    }
+    while (*p >= '0' && *p <= '9') {
+      spec.push_back(*p++);
+    } /* while() */
+    if ('.' == *p) {
+      spec.push_back(*p++);
+      if ('*' == *p) {
+        star_arg(&spec, args, &pos);
+        ++p;
+      }
+      while (*p >= '0' && *p <= '9') {
+        spec.push_back(*p++);
+      } /* while() */
+    }
+    while ('\0' != *p && nullptr != std::strchr("hlLqjzt", *p)) {
+      ++p;
+    } /* while() */
+    if ('\0' == *p) {
+      break;
+    }
+    char conv = *p++;
+
+    decoded_arg arg;
+    if ('n' == conv) {
+      continue;
+    } else if (next_arg(args, &pos, &arg)) {
+      format_one(&out, spec, conv, arg);
+    } else {
+      out += "<?>";
+    }
+  } /* while() */
+  return out;
+} /* format() */
+
+std::string deferred_formatter::format(const fmt_descriptor& desc,
+                                       const std::string& args) {
+  std::string out(desc.file);
+  out += ":" + std::to_string(desc.line) + ":" + desc.func + ": ";
+  out += format(desc.fmt, args);
+  out += "\n";
+  return out;
+} /* format() */
+
+NS_END(er, rcppsw);
@@ -0,0 +1,493 @@
+/**
+ * @file er_metrics.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/er_metrics.hpp"
+#include <algorithm>
+#include <boost/thread/lock_guard.hpp>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+namespace {
+std::atomic<uint64_t> g_next_id{0};
+} // namespace
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+constexpr std::size_t er_metrics::kN_LEVELS;
+constexpr std::size_t er_metrics::kN_BUCKETS;
+constexpr std::size_t er_metrics::kMAX_HANDLES;
+constexpr std::size_t er_metrics::kCHUNK_SIZE;
+constexpr std::size_t er_metrics::kMAX_CHUNKS;
+
+er_metrics::er_metrics(void)
+    : mc_id(g_next_id.fetch_add(1, std::memory_order_relaxed)) {
+  for (auto& chunk : m_chunks) {
+    chunk.store(nullptr, std::memory_order_relaxed);
+  } /* for(&chunk..) */
+  counters_zero(&m_unattributed);
+  for (auto& b : m_hist) {
+    b.store(0, std::memory_order_relaxed);
+  } /* for(&b..) */
+}
+
+er_metrics::~er_metrics(void) {
+  {
+    /* so threads drop their counters for us from their caches */
+    boost::lock_guard<boost::mutex> lock(m_tls_mtx);
+    for (auto& t : m_tls) {
+      t->dead.store(true, std::memory_order_release);
+    } /* for(&t..) */
+  }
+  for (auto& chunk : m_chunks) {
+    delete[] chunk.load(std::memory_order_acquire);
+  } /* for(&chunk..) */
+}
+
+er_metrics::tls_counters::tls_counters(void) {
+  for (auto& chunk : chunks) {
+    chunk.store(nullptr, std::memory_order_relaxed);
+  } /* for(&chunk..) */
+}
+
+er_metrics::tls_counters::~tls_counters(void) {
+  for (auto& chunk : chunks) {
+    delete[] chunk.load(std::memory_order_acquire);
+  } /* for(&chunk..) */
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+er_metrics::counts& er_metrics::counts::operator+=(const counts& rhs) {
+  for (std::size_t i = 0; i < kN_LEVELS; ++i) {
+    emitted[i] += rhs.emitted[i];
+    filtered[i] += rhs.filtered[i];
+    dropped[i] += rhs.dropped[i];
+  } /* for(i..) */
+  bytes += rhs.bytes;
+  return *this;
+} /* operator+=() */
+
+uint64_t er_metrics::counts::n_emitted(void) const {
+  uint64_t n = 0;
+  for (auto v : emitted) {
+    n += v;
+  } /* for(v..) */
+  return n;
+} /* n_emitted() */
+
+uint64_t er_metrics::counts::n_filtered(void) const {
+  uint64_t n = 0;
+  for (auto v : filtered) {
+    n += v;
+  } /* for(v..) */
+  return n;
+} /* n_filtered() */
+
+uint64_t er_metrics::counts::n_dropped(void) const {
+  uint64_t n = 0;
+  for (auto v : dropped) {
+    n += v;
+  } /* for(v..) */
+  return n;
+} /* n_dropped() */
+
+std::size_t er_metrics::lvl_idx(er_lvl::value lvl) {
+  return std::min(static_cast<std::size_t>(lvl), kN_LEVELS - 1);
+} /* lvl_idx() */
+
+void er_metrics::counters_zero(mod_counters* const c) {
+  for (std::size_t i = 0; i < kN_LEVELS; ++i) {
+    c->emitted[i].store(0, std::memory_order_relaxed);
+    c->filtered[i].store(0, std::memory_order_relaxed);
+    c->dropped[i].store(0, std::memory_order_relaxed);
+  } /* for(i..) */
+  c->bytes.store(0, std::memory_order_relaxed);
+} /* counters_zero() */
+
+er_metrics::counts er_metrics::counters_read(const mod_counters& c) {
+  counts ret;
+  for (std::size_t i = 0; i < kN_LEVELS; ++i) {
+    ret.emitted[i] = c.emitted[i].load(std::memory_order_relaxed);
+    ret.filtered[i] = c.filtered[i].load(std::memory_order_relaxed);
+    ret.dropped[i] = c.dropped[i].load(std::memory_order_relaxed);
+  } /* for(i..) */
+  ret.bytes = c.bytes.load(std::memory_order_relaxed);
+  return ret;
+} /* counters_read() */
+
+er_metrics::mod_counters* er_metrics::slot(mod_handle handle) {
+  std::size_t chunk = handle / kCHUNK_SIZE;
+  if (chunk >= kMAX_CHUNKS) {
+    return &m_unattributed;
+  }
+  mod_counters* c = m_chunks[chunk].load(std::memory_order_acquire);
+  if (nullptr == c) {
+    /* first use of a handle in this chunk; losing the race is harmless */
+    auto* fresh = new mod_counters[kCHUNK_SIZE];
+    for (std::size_t i = 0; i < kCHUNK_SIZE; ++i) {
+      counters_zero(&fresh[i]);
+    } /* for(i..) */
+    if (m_chunks[chunk].compare_exchange_strong(c,
+                                                fresh,
+                                                std::memory_order_acq_rel)) {
+      c = fresh;
+    } else {
+      delete[] fresh;
+    }
+  }
+  return &c[handle % kCHUNK_SIZE];
+} /* slot() */
+
+const er_metrics::mod_counters* er_metrics::slot_find(
+    mod_handle handle) const {
+  std::size_t chunk = handle / kCHUNK_SIZE;
+  if (chunk >= kMAX_CHUNKS) {
+    return nullptr;
+  }
+  const mod_counters* c = m_chunks[chunk].load(std::memory_order_acquire);
+  return (nullptr != c) ? &c[handle % kCHUNK_SIZE] : nullptr;
+} /* slot_find() */
+
+er_metrics::tls_slot* er_metrics::tls_counters::slot(mod_handle handle) {
+  std::size_t chunk = handle / kCHUNK_SIZE;
+  if (chunk >= kMAX_CHUNKS) {
+    return &unattributed;
+  }
+  tls_slot* c = chunks[chunk].load(std::memory_order_relaxed);
+  if (nullptr == c) {
+    c = new tls_slot[kCHUNK_SIZE]();
+    chunks[chunk].store(c, std::memory_order_release);
+  }
+  return &c[handle % kCHUNK_SIZE];
+} /* slot() */
+
+const er_metrics::tls_slot* er_metrics::tls_counters::slot_find(
+    mod_handle handle) const {
+  std::size_t chunk = handle / kCHUNK_SIZE;
+  if (chunk >= kMAX_CHUNKS) {
+    return nullptr;
+  }
+  const tls_slot* c = chunks[chunk].load(std::memory_order_acquire);
+  return (nullptr != c) ? &c[handle % kCHUNK_SIZE] : nullptr;
+} /* slot_find() */
+
+er_metrics::tls_counters* er_metrics::tls_get(void) {
+  /*
+   * The counters a thread keeps, keyed by metrics id. When the thread exits
+   * they are marked as orphaned, so the next thread to register folds them
+   * into the shared counters; the shared_ptr keeps them alive until both sides
+   * are done with them. When the metrics are destroyed the counters are marked
+   * as dead, and are dropped from the cache the next time it is searched, so
+   * that long-lived threads do not accumulate counters for every short-lived
+   * server they have reported through.
+   */
+  struct tls_cache {
+    ~tls_cache(void) {
+      for (auto& pair : counters) {
+        pair.second->orphaned.store(true, std::memory_order_release);
+      } /* for(&pair..) */
+    }
+    std::unordered_map<uint64_t, std::shared_ptr<tls_counters>> counters{};
+    uint64_t last_id{std::numeric_limits<uint64_t>::max()};
+    tls_counters* last{nullptr};
+  };
+  static thread_local tls_cache tls;
+
+  if (mc_id == tls.last_id) {
+    return tls.last;
+  }
+  auto it = tls.counters.find(mc_id);
+  if (it == tls.counters.end()) {
+    for (auto dit = tls.counters.begin(); dit != tls.counters.end();) {
+      if (dit->second->dead.load(std::memory_order_acquire)) {
+        dit = tls.counters.erase(dit);
+      } else {
+        ++dit;
+      }
+    } /* for(dit..) */
+    auto c = std::make_shared<tls_counters>();
+    {
+      boost::lock_guard<boost::mutex> lock(m_tls_mtx);
+      auto orphaned = [&](const std::shared_ptr<tls_counters>& t) {
+        if (!t->orphaned.load(std::memory_order_acquire)) {
+          return false;
+        }
+        tls_fold(*t, 1);
+        return true;
+      };
+      m_tls.erase(std::remove_if(m_tls.begin(), m_tls.end(), orphaned),
+                  m_tls.end());
+      m_tls.push_back(c);
+    }
+    it = tls.counters.insert(std::make_pair(mc_id, std::move(c))).first;
+  }
+  tls.last_id = mc_id;
+  tls.last = it->second.get();
+  return tls.last;
+} /* tls_get() */
+
+void er_metrics::tls_fold(const tls_counters& tls, int sign) {
+  auto fold = [sign](const tls_slot& from, mod_counters* to) {
+    for (std::size_t i = 0; i < kN_LEVELS; ++i) {
+      uint64_t v = from.filtered[i].load(std::memory_order_relaxed);
+      if (sign > 0) {
+        to->filtered[i].fetch_add(v, std::memory_order_relaxed);
+      } else {
+        to->filtered[i].fetch_sub(v, std::memory_order_relaxed);
+      }
+    } /* for(i..) */
+  };
+  fold(tls.unattributed, &m_unattributed);
+  for (std::size_t chunk = 0; chunk < kMAX_CHUNKS; ++chunk) {
+    const tls_slot* c = tls.chunks[chunk].load(std::memory_order_acquire);
+    for (std::size_t i = 0; nullptr != c && i < kCHUNK_SIZE; ++i) {
+      fold(c[i], slot(chunk * kCHUNK_SIZE + i));
+    } /* for(i..) */
+  } /* for(chunk..) */
+} /* tls_fold() */
+
+void er_metrics::tls_slot_add(const tls_slot& slot, counts* const c) {
+  for (std::size_t i = 0; i < kN_LEVELS; ++i) {
+    c->filtered[i] += slot.filtered[i].load(std::memory_order_relaxed);
+  } /* for(i..) */
+} /* tls_slot_add() */
+
+void er_metrics::emitted(mod_handle handle,
+                         er_lvl::value lvl,
+                         std::size_t bytes) {
+  if (!enabled()) {
+    return;
+  }
+  mod_counters* c = slot(handle);
+  c->emitted[lvl_idx(lvl)].fetch_add(1, std::memory_order_relaxed);
+  c->bytes.fetch_add(bytes, std::memory_order_relaxed);
+} /* emitted() */
+
+void er_metrics::filtered(mod_handle handle, er_lvl::value lvl) {
+  if (!enabled()) {
+    return;
+  }
+  /* only this thread writes its counters, so no read-modify-write needed */
+  auto& n = tls_get()->slot(handle)->filtered[lvl_idx(lvl)];
+  n.store(n.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+} /* filtered() */
+
+void er_metrics::dropped(mod_handle handle, er_lvl::value lvl) {
+  if (!enabled()) {
+    return;
+  }
+  slot(handle)->dropped[lvl_idx(lvl)].fetch_add(1, std::memory_order_relaxed);
+} /* dropped() */
+
+void er_metrics::latency(uint64_t ns) {
+  if (!enabled()) {
+    return;
+  }
+  std::size_t bucket = 0;
+  for (uint64_t v = ns; v > 0; v >>= 1) {
+    ++bucket;
+  } /* for(v..) */
+  bucket = std::min(bucket, kN_BUCKETS - 1);
+  m_hist[bucket].fetch_add(1, std::memory_order_relaxed);
+  m_lat_sum.fetch_add(ns, std::memory_order_relaxed);
+
+  uint64_t max = m_lat_max.load(std::memory_order_relaxed);
+  while (ns > max && !m_lat_max.compare_exchange_weak(
+                         max, ns, std::memory_order_relaxed)) {
+  } /* while() */
+} /* latency() */
+
+void er_metrics::mod_reset(mod_handle handle) {
+  if (handle / kCHUNK_SIZE >= kMAX_CHUNKS) {
+    return;
+  }
+  mod_counters* c = slot(handle);
+  counters_zero(c);
+
+  /* offset the per-thread counts, so that the sum read back starts at 0 */
+  boost::lock_guard<boost::mutex> lock(m_tls_mtx);
+  for (auto& t : m_tls) {
+    const tls_slot* s = t->slot_find(handle);
+    for (std::size_t i = 0; nullptr != s && i < kN_LEVELS; ++i) {
+      c->filtered[i].fetch_sub(s->filtered[i].load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+    } /* for(i..) */
+  } /* for(&t..) */
+} /* mod_reset() */
+
+er_metrics::counts er_metrics::mod_counts(mod_handle handle) const {
+  const mod_counters* c = slot_find(handle);
+  counts ret = (nullptr != c) ? counters_read(*c) : counts();
+  boost::lock_guard<boost::mutex> lock(m_tls_mtx);
+  for (auto& t : m_tls) {
+    const tls_slot* s = t->slot_find(handle);
+    if (nullptr != s) {
+      tls_slot_add(*s, &ret);
+    }
+  } /* for(&t..) */
+  return ret;
+} /* mod_counts() */
+
+er_metrics::counts er_metrics::unattributed(void) const {
+  counts ret = counters_read(m_unattributed);
+  boost::lock_guard<boost::mutex> lock(m_tls_mtx);
+  for (auto& t : m_tls) {
+    tls_slot_add(t->unattributed, &ret);
+  } /* for(&t..) */
+  return ret;
+} /* unattributed() */
+
+er_metrics::counts er_metrics::totals(void) const {
+  counts ret = counters_read(m_unattributed);
+  for (auto& chunk : m_chunks) {
+    const mod_counters* c = chunk.load(std::memory_order_acquire);
+    for (std::size_t i = 0; nullptr != c && i < kCHUNK_SIZE; ++i) {
+      ret += counters_read(c[i]);
+    } /* for(i..) */
+  } /* for(&chunk..) */
+
+  boost::lock_guard<boost::mutex> lock(m_tls_mtx);
+  for (auto& t : m_tls) {
+    tls_slot_add(t->unattributed, &ret);
+    for (auto& chunk : t->chunks) {
+      const tls_slot* c = chunk.load(std::memory_order_acquire);
+      for (std::size_t i = 0; nullptr != c && i < kCHUNK_SIZE; ++i) {
+        tls_slot_add(c[i], &ret);
+      } /* for(i..) */
+    } /* for(&chunk..) */
+  } /* for(&t..) */
+  return ret;
+} /* totals() */
+
+std::vector<uint64_t> er_metrics::latency_hist(void) const {
+  std::vector<uint64_t> ret;
+  for (auto& b : m_hist) {
+    ret.push_back(b.load(std::memory_order_relaxed));
+  } /* for(&b..) */
+  return ret;
+} /* latency_hist() */
+
+uint64_t er_metrics::latency_count(void) const {
+  uint64_t n = 0;
+  for (auto& b : m_hist) {
+    n += b.load(std::memory_order_relaxed);
+  } /* for(&b..) */
+  return n;
+} /* latency_count() */
+
+uint64_t er_metrics::latency_max_ns(void) const {
+  return m_lat_max.load(std::memory_order_relaxed);
+} /* latency_max_ns() */
+
+double er_metrics::latency_mean_ns(void) const {
+  uint64_t n = latency_count();
+  return (0 == n) ? 0.0
+                  : static_cast<double>(m_lat_sum.load(
+                        std::memory_order_relaxed)) / n;
+} /* latency_mean_ns() */
+
+uint64_t er_metrics::bucket_bound(std::size_t i) {
+  return (0 == i) ? 0 : (UINT64_C(1) << std::min<std::size_t>(i, 63)) - 1;
+} /* bucket_bound() */
+
+uint64_t er_metrics::latency_percentile(double p) const {
+  std::vector<uint64_t> hist = latency_hist();
+  uint64_t n = 0;
+  for (auto v : hist) {
+    n += v;
+  } /* for(v..) */
+  if (0 == n) {
+    return 0;
+  }
+  auto target = static_cast<uint64_t>(std::max(1.0, p / 100.0 * n + 0.5));
+  uint64_t seen = 0;
+  for (std::size_t i = 0; i < hist.size(); ++i) {
+    seen += hist[i];
+    if (seen >= target) {
+      return bucket_bound(i);
+    }
+  } /* for(i..) */
+  return bucket_bound(hist.size() - 1);
+} /* latency_percentile() */
+
+void er_metrics::reset(void) {
+  counters_zero(&m_unattributed);
+  for (auto& chunk : m_chunks) {
+    mod_counters* c = chunk.load(std::memory_order_acquire);
+    for (std::size_t i = 0; nullptr != c && i < kCHUNK_SIZE; ++i) {
+      counters_zero(&c[i]);
+    } /* for(i..) */
+  } /* for(&chunk..) */
+  {
+    boost::lock_guard<boost::mutex> lock(m_tls_mtx);
+    for (auto& t : m_tls) {
+      tls_fold(*t, -1);
+    } /* for(&t..) */
+  }
+  for (auto& b : m_hist) {
+    b.store(0, std::memory_order_relaxed);
+  } /* for(&b..) */
+  m_lat_sum.store(0, std::memory_order_relaxed);
+  m_lat_max.store(0, std::memory_order_relaxed);
+} /* reset() */
+
+void er_metrics::dump_counts(std::ostream& os,
+                             const std::string& name,
+                             const counts& c) {
+  static const char* const kLVL_NAMES[kN_LEVELS] = {"OFF", "ERR", "WARN",
+                                                    "NOM", "DIAG", "VER"};
+  os << name << ": emitted=" << c.n_emitted() << " filtered=" << c.n_filtered()
+     << " dropped=" << c.n_dropped() << " bytes=" << c.bytes;
+  for (std::size_t i = er_lvl::ERR; i < kN_LEVELS; ++i) {
+    if (0 != c.emitted[i] || 0 != c.filtered[i] || 0 != c.dropped[i]) {
+      os << " " << kLVL_NAMES[i] << "=" << c.emitted[i] << "/" << c.filtered[i]
+         << "/" << c.dropped[i];
+    }
+  } /* for(i..) */
+  os << "\n";
+} /* dump_counts() */
+
+void er_metrics::dump_latency(std::ostream& os) const {
+  os << "latency: n=" << latency_count() << " mean=" << latency_mean_ns()
+     << "ns p50<=" << latency_percentile(50) << "ns p99<="
+     << latency_percentile(99) << "ns max=" << latency_max_ns() << "ns\n";
+  std::vector<uint64_t> hist = latency_hist();
+  for (std::size_t i = 0; i < hist.size(); ++i) {
+    if (0 != hist[i]) {
+      os << "  <=" << bucket_bound(i) << "ns: " << hist[i] << "\n";
+    }
+  } /* for(i..) */
+} /* dump_latency() */
+
+NS_END(er, rcppsw);
@@ -0,0 +1,79 @@
+/**
+ * @file file_sink.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/file_sink.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+file_sink::file_sink(const std::string& fname,
+                     bool sync_on_err,
+                     std::size_t capacity,
+                     uint32_t interval_ms)
+    : buffered_sink(capacity, interval_ms, sync_on_err),
+      m_fname(fname),
+      m_fd(::open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  0644)) {}
+
+file_sink::~file_sink(void) {
+  flush();
+  if (is_open()) {
+    ::close(m_fd);
+  }
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void file_sink::sink_write(const char* data, std::size_t len) {
+  if (!is_open()) {
+    return;
+  }
+  while (len > 0) {
+    ssize_t n = ::write(m_fd, data, len);
+    if (n < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      return;
+    }
+    data += n;
+    len -= static_cast<std::size_t>(n);
+  } /* while() */
+} /* sink_write() */
+
+void file_sink::sink_sync(void) {
+  if (is_open()) {
+    ::fsync(m_fd);
+  }
+} /* sink_sync() */
+
+NS_END(er, rcppsw);
@@ -0,0 +1,392 @@
+/**
+ * @file flight_recorder.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/flight_recorder.hpp"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include "rcppsw/er/binlog_format.hpp"
+#include "rcppsw/er/timestamp.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Structure Definitions
+ ******************************************************************************/
+/**
+ * @brief A single recorded message. \c seq is 2 * (ring position) + 1 while
+ * the slot is being written, and 2 * (ring position) + 2 once it is complete.
+ */
+struct flight_recorder::slot {
+  std::atomic<uint64_t> seq{0};
+  uint64_t ts{0};
+  const fmt_descriptor* fmt{nullptr};
+  uint32_t handle{0};
+  uint16_t len{0};
+  uint8_t lvl{0};
+  char payload[kPAYLOAD_SIZE];
+};
+
+namespace {
+/*
+ * The handlers can run on any thread, but an alternate stack can only be set up
+ * for the thread calling install(). It is never freed, since the thread may
+ * still be using it after the recorder is gone.
+ */
+constexpr std::size_t kALTSTACK_SIZE = 64 * 1024;
+constexpr std::size_t kSCRATCH_SIZE = 8192;
+char g_altstack[kALTSTACK_SIZE];
+struct sigaction g_old_segv;
+struct sigaction g_old_abrt;
+
+/**
+ * @brief Output buffered in a fixed area, for writing from a signal handler.
+ */
+struct out_buf {
+  int fd;
+  char* buf;
+  std::size_t len;
+  bool ok;
+};
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+bool write_all(int fd, const char* p, std::size_t len) {
+  while (len > 0) {
+    ssize_t n = ::write(fd, p, len);
+    if (n < 0 && EINTR == errno) {
+      continue;
+    } else if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= static_cast<std::size_t>(n);
+  } /* while() */
+  return true;
+} /* write_all() */
+
+void out_flush(out_buf* const out) {
+  out->ok = out->ok && write_all(out->fd, out->buf, out->len);
+  out->len = 0;
+} /* out_flush() */
+
+void out_put(out_buf* const out, const void* data, std::size_t len) {
+  const char* p = static_cast<const char*>(data);
+  while (len > 0) {
+    if (kSCRATCH_SIZE == out->len) {
+      out_flush(out);
+    }
+    std::size_t n = std::min(len, kSCRATCH_SIZE - out->len);
+    std::memcpy(out->buf + out->len, p, n);
+    out->len += n;
+    p += n;
+    len -= n;
+  } /* while() */
+} /* out_put() */
+
+template <typename T>
+void out_put(out_buf* const out, T val) {
+  out_put(out, &val, sizeof(T));
+} /* out_put() */
+
+std::size_t round_pow2(std::size_t n) {
+  std::size_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  } /* while() */
+  return p;
+} /* round_pow2() */
+} // namespace
+
+/*******************************************************************************
+ * Class Constants
+ ******************************************************************************/
+constexpr std::size_t flight_recorder::kDEFAULT_CAPACITY;
+constexpr std::size_t flight_recorder::kPAYLOAD_SIZE;
+constexpr std::size_t flight_recorder::kMAX_MODULES;
+constexpr std::size_t flight_recorder::kMOD_NAME_LEN;
+constexpr std::size_t flight_recorder::kBLOCK_RECORDS;
+std::atomic<flight_recorder*> flight_recorder::ms_installed{nullptr};
+std::atomic<bool> flight_recorder::ms_dumped{false};
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+flight_recorder::flight_recorder(std::size_t capacity)
+    : mc_mask(round_pow2(std::max<std::size_t>(capacity, 1)) - 1),
+      m_slots(new slot[mc_mask + 1]),
+      m_snap(new slot[kBLOCK_RECORDS]),
+      m_names(new char[kMAX_MODULES * kMOD_NAME_LEN]()),
+      m_scratch(new char[kSCRATCH_SIZE]) {}
+
+flight_recorder::~flight_recorder(void) { uninstall(); }
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void flight_recorder::record(mod_handle handle,
+                             er_lvl::value lvl,
+                             const fmt_descriptor* fmt,
+                             const char* data,
+                             std::size_t len) {
+  uint64_t pos = m_next.fetch_add(1, std::memory_order_relaxed);
+  slot& s = m_slots[pos & mc_mask];
+
+  /*
+   * If a writer from a lap before/after this one is still in the slot, drop
+   * this message rather than interleave the two. Acquire, so that our writes
+   * to the slot come after those of the writer from the lap before.
+   */
+  uint64_t seq = s.seq.load(std::memory_order_relaxed);
+  if (0 != (seq & 1) || seq > 2 * pos ||
+      !s.seq.compare_exchange_strong(seq,
+                                     2 * pos + 1,
+                                     std::memory_order_acquire,
+                                     std::memory_order_relaxed)) {
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  s.ts = timestamp::now();
+  s.fmt = fmt;
+  s.handle = handle;
+  s.lvl = static_cast<uint8_t>(lvl);
+  s.len = static_cast<uint16_t>(std::min(len, kPAYLOAD_SIZE));
+  std::memcpy(s.payload, data, s.len);
+  s.seq.store(2 * pos + 2, std::memory_order_release);
+} /* record() */
+
+void flight_recorder::mod_name(mod_handle handle, const std::string& name) {
+  if (handle >= kMAX_MODULES) {
+    return;
+  }
+  char* dest = m_names.get() + handle * kMOD_NAME_LEN;
+  std::size_t n = std::min(name.size(), kMOD_NAME_LEN - 1);
+  std::memcpy(dest, name.data(), n);
+  dest[n] = '\0';
+} /* mod_name() */
+
+std::size_t flight_recorder::name_len(mod_handle handle) const {
+  return (handle < kMAX_MODULES)
+             ? ::strnlen(m_names.get() + handle * kMOD_NAME_LEN, kMOD_NAME_LEN)
+             : 0;
+} /* name_len() */
+
+status_t flight_recorder::dump(const char* path) {
+  struct timespec real;
+  int64_t wall_offset;
+  uint64_t end = m_next.load(std::memory_order_acquire);
+  uint64_t pos = (end > capacity()) ? end - capacity() : 0;
+  char hdr[binlog_format::kFILE_HEADER_SIZE];
+
+  int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  CHECK(fd >= 0);
+
+  binlog_format::put(binlog_format::put(hdr, binlog_format::kFILE_MAGIC),
+                     binlog_format::kVERSION);
+  CHECK(write_all(fd, hdr, sizeof(hdr)));
+
+  /* same conversion as ts_formatter, but without touching the heap */
+  clock_gettime(CLOCK_REALTIME_COARSE, &real);
+  wall_offset = static_cast<int64_t>(static_cast<uint64_t>(real.tv_sec) *
+                                         timestamp::kNS_PER_SEC +
+                                     static_cast<uint64_t>(real.tv_nsec)) -
+                static_cast<int64_t>(timestamp::now());
+
+  while (pos < end) {
+    std::size_t n = snapshot(&pos, end);
+    CHECK(0 == n || block_write(fd, n, wall_offset));
+  } /* while() */
+  ::close(fd);
+  return OK;
+
+error:
+  if (fd >= 0) {
+    ::close(fd);
+  }
+  return ERROR;
+} /* dump() */
+
+std::size_t flight_recorder::snapshot(uint64_t* const pos, uint64_t end) {
+  std::size_t n = 0;
+  while (*pos < end && n < kBLOCK_RECORDS) {
+    const slot& s = m_slots[*pos & mc_mask];
+    slot& snap = m_snap[n];
+    uint64_t want = 2 * (*pos)++ + 2;
+
+    /* skip slots that have been overwritten or are still being written */
+    if (s.seq.load(std::memory_order_acquire) != want) {
+      continue;
+    }
+    snap.ts = s.ts;
+    snap.fmt = s.fmt;
+    snap.handle = s.handle;
+    snap.lvl = s.lvl;
+    snap.len = std::min<uint16_t>(s.len, kPAYLOAD_SIZE);
+    std::memcpy(snap.payload, s.payload, snap.len);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s.seq.load(std::memory_order_relaxed) == want) {
+      ++n;
+    }
+  } /* while() */
+  return n;
+} /* snapshot() */
+
+bool flight_recorder::block_write(int fd,
+                                  std::size_t n,
+                                  int64_t wall_offset) const {
+  uint32_t mods[kBLOCK_RECORDS];
+  const fmt_descriptor* fmts[kBLOCK_RECORDS];
+  uint16_t fmt_ids[kBLOCK_RECORDS];
+  binlog_format::block_header hdr;
+  std::size_t records_size = 0;
+  char hdr_buf[binlog_format::kBLOCK_HEADER_SIZE];
+  out_buf out = {fd, m_scratch.get(), 0, true};
+
+  /* first pass: build the (tiny) dictionaries and size everything up */
+  for (std::size_t i = 0; i < n; ++i) {
+    const slot& s = m_snap[i];
+    uint64_t ts = static_cast<uint64_t>(static_cast<int64_t>(s.ts) + wall_offset);
+    if (std::find(mods, mods + hdr.n_modules, s.handle) ==
+        mods + hdr.n_modules) {
+      mods[hdr.n_modules++] = s.handle;
+      hdr.dict_size += static_cast<uint32_t>(
+          sizeof(uint32_t) + sizeof(uint16_t) + name_len(s.handle));
+    }
+    if (nullptr != s.fmt) {
+      auto it = std::find(fmts, fmts + hdr.n_formats, s.fmt);
+      fmt_ids[i] = static_cast<uint16_t>(it - fmts);
+      if (it == fmts + hdr.n_formats) {
+        fmts[hdr.n_formats++] = s.fmt;
+        hdr.dict_size += static_cast<uint32_t>(
+            sizeof(uint16_t) + sizeof(uint32_t) + 3 * sizeof(uint16_t) +
+            std::strlen(s.fmt->file) + std::strlen(s.fmt->func) +
+            std::strlen(s.fmt->fmt));
+      }
+    }
+    records_size += binlog_format::kRECORD_HEADER_SIZE + s.len;
+    hdr.ts_min = std::min(hdr.ts_min, ts);
+    hdr.ts_max = std::max(hdr.ts_max, ts);
+    hdr.module_mask |= binlog_format::module_bit(s.handle);
+    hdr.lvl_mask |= binlog_format::lvl_bit(s.lvl);
+  } /* for(i..) */
+  hdr.n_records = static_cast<uint32_t>(n);
+  hdr.body_size = static_cast<uint32_t>(hdr.dict_size + records_size);
+
+  /* second pass: write it all out in the same layout as binlog_writer */
+  binlog_format::header_encode(hdr, hdr_buf);
+  out_put(&out, hdr_buf, sizeof(hdr_buf));
+  for (std::size_t i = 0; i < hdr.n_modules; ++i) {
+    std::size_t len = name_len(mods[i]);
+    out_put(&out, mods[i]);
+    out_put(&out, static_cast<uint16_t>(len));
+    if (len > 0) {
+      out_put(&out, m_names.get() + mods[i] * kMOD_NAME_LEN, len);
+    }
+  } /* for(i..) */
+  for (std::size_t i = 0; i < hdr.n_formats; ++i) {
+    std::size_t file_len = std::strlen(fmts[i]->file);
+    std::size_t func_len = std::strlen(fmts[i]->func);
+    std::size_t fmt_len = std::strlen(fmts[i]->fmt);
+    out_put(&out, static_cast<uint16_t>(i));
+    out_put(&out, static_cast<uint32_t>(fmts[i]->line));
+    out_put(&out, static_cast<uint16_t>(file_len));
+    out_put(&out, static_cast<uint16_t>(func_len));
+    out_put(&out, static_cast<uint16_t>(fmt_len));
+    out_put(&out, fmts[i]->file, file_len);
+    out_put(&out, fmts[i]->func, func_len);
+    out_put(&out, fmts[i]->fmt, fmt_len);
+  } /* for(i..) */
+  for (std::size_t i = 0; i < n; ++i) {
+    const slot& s = m_snap[i];
+    bool deferred = (nullptr != s.fmt);
+    out_put(&out,
+            static_cast<uint64_t>(static_cast<int64_t>(s.ts) + wall_offset));
+    out_put(&out, s.handle);
+    out_put(&out, s.lvl);
+    out_put(&out,
+            static_cast<uint8_t>(deferred ? binlog_format::DEFERRED
+                                          : binlog_format::TEXT));
+    out_put(&out, static_cast<uint16_t>(deferred ? fmt_ids[i] : 0));
+    out_put(&out, static_cast<uint32_t>(s.len));
+    out_put(&out, s.payload, s.len);
+  } /* for(i..) */
+  out_flush(&out);
+  return out.ok;
+} /* block_write() */
+
+void flight_recorder::install(const std::string& path) {
+  struct sigaction sa;
+  stack_t ss;
+
+  std::size_t n = std::min(path.size(), sizeof(m_crash_path) - 1);
+  std::memcpy(m_crash_path, path.data(), n);
+  m_crash_path[n] = '\0';
+  ms_dumped.store(false);
+  ms_installed.store(this);
+
+  ss.ss_sp = g_altstack;
+  ss.ss_size = kALTSTACK_SIZE;
+  ss.ss_flags = 0;
+  sigaltstack(&ss, nullptr);
+
+  std::memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = signal_handler;
+  sa.sa_flags = SA_ONSTACK | SA_RESETHAND;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGSEGV, &sa, &g_old_segv);
+  sigaction(SIGABRT, &sa, &g_old_abrt);
+} /* install() */
+
+void flight_recorder::uninstall(void) {
+  flight_recorder* self = this;
+  if (ms_installed.compare_exchange_strong(self, nullptr)) {
+    sigaction(SIGSEGV, &g_old_segv, nullptr);
+    sigaction(SIGABRT, &g_old_abrt, nullptr);
+  }
+} /* uninstall() */
+
+void flight_recorder::crash_dump(void) {
+  flight_recorder* rec = ms_installed.load();
+  if (nullptr != rec && !ms_dumped.exchange(true)) {
+    rec->dump(rec->m_crash_path);
+  }
+} /* crash_dump() */
+
+void flight_recorder::signal_handler(int sig) {
+  int saved = errno;
+  crash_dump();
+  errno = saved;
+
+  /* the handler was reset on entry, so this gets the default action */
+  raise(sig);
+} /* signal_handler() */
+
+NS_END(er, rcppsw);
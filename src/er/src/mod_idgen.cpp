@@ -0,0 +1,95 @@
+/**
+ * @file mod_idgen.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/mod_idgen.hpp"
+#include <time.h>
+#include <unistd.h>
+#include <boost/thread/lock_guard.hpp>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+namespace {
+/**
+ * @brief The splitmix64 finalizer; a cheap, well mixing bijection on 64 bit
+ * integers.
+ */
+uint64_t mix(uint64_t x) {
+  x += UINT64_C(0x9E3779B97F4A7C15);
+  x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+  x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+  return x ^ (x >> 31);
+} /* mix() */
+
+/**
+ * @brief Make a seed for \ref mod_idgen::HASHED that differs between
+ * generators in the same process, and between processes.
+ */
+uint64_t seed_make(const void* salt) {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  return mix((static_cast<uint64_t>(getpid()) << 32) ^
+             (static_cast<uint64_t>(ts.tv_sec) * 1000000000) ^
+             static_cast<uint64_t>(ts.tv_nsec) ^
+             reinterpret_cast<uintptr_t>(salt));
+} /* seed_make() */
+} // namespace
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+mod_idgen::mod_idgen(mode m) : mc_seed(seed_make(this)), m_mode(m) {}
+
+mod_idgen::~mod_idgen(void) = default;
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+boost::uuids::uuid mod_idgen::operator()(void) {
+  switch (get_mode()) {
+    case RANDOM: {
+      boost::lock_guard<boost::mutex> lock(m_random_mtx);
+      if (nullptr == m_random) {
+        m_random.reset(new boost::uuids::random_generator());
+      }
+      return (*m_random)();
+    }
+    case HASHED: {
+      boost::uuids::uuid id;
+      uint64_t halves[2];
+      halves[0] = mix(mc_seed + m_next.fetch_add(1, std::memory_order_relaxed));
+      halves[1] = mix(halves[0] ^ mc_seed);
+      std::memcpy(id.data, halves, sizeof(halves));
+      return id;
+    }
+    default:
+      return from_key(m_next.fetch_add(1, std::memory_order_relaxed));
+  } /* switch() */
+} /* operator()() */
+
+NS_END(er, rcppsw);
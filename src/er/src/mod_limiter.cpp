@@ -0,0 +1,95 @@
+/**
+ * @file mod_limiter.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/mod_limiter.hpp"
+#include <algorithm>
+#include "rcppsw/er/timestamp.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+mod_limiter::mod_limiter(const config& cfg)
+    : mc_cfg(cfg),
+      mc_interval((cfg.rate > 0.0)
+                      ? static_cast<uint64_t>(timestamp::kNS_PER_SEC / cfg.rate)
+                      : 0),
+      mc_tolerance(mc_interval * (std::max(cfg.burst, 1U) - 1)),
+      m_last_summary(timestamp::now()) {}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool mod_limiter::admit(const er_lvl::value& lvl) {
+  if (lvl < mc_cfg.lvl) {
+    return true;
+  }
+  if (mc_cfg.sample > 1 &&
+      0 != m_count.fetch_add(1, std::memory_order_relaxed) % mc_cfg.sample) {
+    suppress();
+    return false;
+  }
+  if (0 == mc_interval) {
+    return true;
+  }
+
+  /*
+   * Each message pushes the theoretical arrival time of the next one forward
+   * by the interval; a message is admitted as long as that time is no more
+   * than the burst ahead of now.
+   */
+  uint64_t now = timestamp::precise();
+  uint64_t tat = m_tat.load(std::memory_order_relaxed);
+  do {
+    if (tat > now + mc_tolerance) {
+      suppress();
+      return false;
+    }
+  } while (!m_tat.compare_exchange_weak(tat,
+                                        std::max(tat, now) + mc_interval,
+                                        std::memory_order_relaxed));
+  return true;
+} /* admit() */
+
+bool mod_limiter::summary_due(uint64_t now) {
+  if (0 == m_suppressed.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  uint64_t last = m_last_summary.load(std::memory_order_relaxed);
+  if (now - last < mc_cfg.summary_ms * (timestamp::kNS_PER_SEC / 1000)) {
+    return false;
+  }
+  return m_last_summary.compare_exchange_strong(last,
+                                                now,
+                                                std::memory_order_relaxed);
+} /* summary_due() */
+
+std::string mod_limiter::summary(uint64_t n) {
+  return std::to_string(n) + " messages suppressed (rate limit/sampling)\n";
+} /* summary() */
+
+NS_END(er, rcppsw);
@@ -22,6 +22,7 @@
  * Includes
  ******************************************************************************/
 #include "rcppsw/er/mt_server.hpp"
+#include <boost/thread/lock_guard.hpp>
 #include <algorithm>
 
 /*******************************************************************************
@@ -32,35 +33,44 @@ NS_START(rcppsw, er);
 /*******************************************************************************
  * Constructors/Destructors
  ******************************************************************************/
+constexpr std::size_t mt_server::kDEFAULT_QUEUE_SIZE;
+constexpr std::size_t mt_server::kWAIT_TIMEOUT_MS;
+
 mt_server::mt_server(const std::string& logfile_fname,
                      const er_lvl::value& dbglvl,
-                     const er_lvl::value& loglvl)
-    : server(logfile_fname, dbglvl, loglvl), m_queue() {}
+                     const er_lvl::value& loglvl,
+                     std::size_t queue_size,
+                     multithread::overflow_policy::value policy)
+    : server(logfile_fname, dbglvl, loglvl), m_queue(queue_size, policy) {}
 
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
 void mt_server::flush(void) {
-  while (m_queue.size() > 0) {
-    msg_int next = m_queue.dequeue();
-    server::msg_report(next);
-  } /* while() */
+  boost::lock_guard<boost::mutex> lock(m_report_mtx);
+  drain();
+  server::flush();
 } /* flush() */
 
+void mt_server::drain(void) {
+  msg_int msg;
+  while (m_queue.try_dequeue(&msg)) {
+    msg_report(msg);
+  } /* while() */
+} /* drain() */
+
 void* mt_server::thread_main(__unused void* arg) {
   while (!terminated()) {
-    while (0 == m_queue.size()) {
-      sleep(1);
-    }
-    msg_int msg = m_queue.dequeue();
-    msg_report(msg);
+    m_queue.wait(kWAIT_TIMEOUT_MS);
+    boost::lock_guard<boost::mutex> lock(m_report_mtx);
+    drain();
+    sinks_poll();
   } /* while() */
 
   /* make sure all events remaining in queue are reported */
-  while (m_queue.size() > 0) {
-    msg_int msg = m_queue.dequeue();
-    msg_report(msg);
-  } /* while() */
+  boost::lock_guard<boost::mutex> lock(m_report_mtx);
+  drain();
+  server::flush();
   return nullptr;
 } /* thread_main() */
 
@@ -22,10 +22,13 @@
  * Includes
  ******************************************************************************/
 #include "rcppsw/er/server.hpp"
-#include <algorithm>
-#include <boost/filesystem.hpp>
-#include <fstream>
-#include <iostream>
+#include <cstdio>
+#include "rcppsw/er/async_file_sink.hpp"
+#include "rcppsw/er/binlog_writer.hpp"
+#include "rcppsw/er/deferred_formatter.hpp"
+#include "rcppsw/er/file_sink.hpp"
+#include "rcppsw/er/null_sink.hpp"
+#include "rcppsw/er/stdout_sink.hpp"
 
 /*******************************************************************************
  * Namespaces
@@ -56,6 +59,28 @@ NS_START(rcppsw, er);
  ******************************************************************************/
 std::shared_ptr<global_server> g_server(std::make_shared<global_server>());
 
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+namespace {
+/**
+ * @brief Write a single "header module: text" record to a sink.
+ *
+ * @return The # of bytes written.
+ */
+std::size_t record_write(const std::string& header,
+                         const std::string& mod_name,
+                         const std::string& text,
+                         er_lvl::value lvl,
+                         sink* const target) {
+  std::string rec;
+  rec.reserve(header.size() + mod_name.size() + text.size() + 3);
+  rec.append(header).append(" ").append(mod_name).append(": ").append(text);
+  target->write(rec.data(), rec.size(), lvl);
+  return rec.size();
+} /* record_write() */
+} // namespace
+
 /*******************************************************************************
  * Constructors/Destructors
  ******************************************************************************/
@@ -63,20 +88,27 @@ server::server(std::string logfile_fname,
                const er_lvl::value& dbglvl,
                const er_lvl::value& loglvl)
     : m_modules(),
+      m_free_handles(),
+      m_index(),
       m_logfile_fname(std::move(logfile_fname)),
-      m_logfile(new std::ofstream()),
+      m_log_sink(new null_sink()),
+      m_dbg_sink(new stdout_sink()),
+      m_log_buf(m_log_sink.get()),
+      m_dbg_buf(m_dbg_sink.get()),
+      m_log_stream(&m_log_buf),
+      m_dbg_stream(&m_dbg_buf),
+      m_binlog(),
       m_loglvl_dflt(loglvl),
       m_dbglvl_dflt(dbglvl),
       m_dbg_ts_calculator(nullptr),
       m_log_ts_calculator(nullptr),
-      m_generator(),
       m_er_id(idgen()) {
   gethostname(reinterpret_cast<char*>(m_hostname), 32);
 
   change_logfile(m_logfile_fname);
 }
 
-server::~server(void) { m_logfile->close(); }
+server::~server(void) = default;
 
 global_server::~global_server(void) = default;
 
@@ -104,149 +136,369 @@ void server::self_er_en(void) {
   mod_dbglvl(m_er_id, er_lvl::NOM);
 } /* self_er_en() */
 
-status_t server::insmod(const boost::uuids::uuid& mod_id,
-                        const er_lvl::value& loglvl,
-                        const er_lvl::value& dbglvl,
-                        const std::string& mod_name) {
-  server_mod mod(mod_id, loglvl, dbglvl, mod_name);
+mod_handle server::insmod_handle(const boost::uuids::uuid& mod_id,
+                                const er_lvl::value& loglvl,
+                                const er_lvl::value& dbglvl,
+                                const std::string& mod_name) {
+  mod_handle handle = kINVALID_MOD_HANDLE;
 
   /* make sure module not already present */
-  CHECK(m_modules.end() == std::find(m_modules.begin(), m_modules.end(), mod));
-  m_modules.push_back(mod);
-  return OK;
+  CHECK(m_index.end() == m_index.find(mod_idgen::key(mod_id)));
+
+  /* reuse a free slot if there is one, so the table stays dense */
+  if (!m_free_handles.empty()) {
+    handle = m_free_handles.back();
+    m_free_handles.pop_back();
+  } else {
+    handle = static_cast<mod_handle>(m_modules.size());
+    m_modules.emplace_back();
+  }
+  m_modules[handle].reset(new server_mod(mod_id, loglvl, dbglvl, mod_name));
+  m_modules[handle]->set_limits(m_limits_dflt);
+  m_index[mod_idgen::key(mod_id)] = handle;
+  m_metrics.mod_reset(handle);
+  if (nullptr != m_recorder) {
+    m_recorder->mod_name(handle, mod_name);
+  }
+  m_generation.fetch_add(1, std::memory_order_acq_rel);
+  return handle;
 
 error:
   REPORT_INTERNAL(er_lvl::ERR,
                   "Failed to install module %s: module exists",
                   mod_name.c_str());
-  return ERROR;
-} /* insmod() */
+  return kINVALID_MOD_HANDLE;
+} /* insmod_handle() */
+
+mod_handle server::mod_lookup(const boost::uuids::uuid& id) const {
+  auto it = m_index.find(mod_idgen::key(id));
+  return (it != m_index.end()) ? it->second : kINVALID_MOD_HANDLE;
+} /* mod_lookup() */
 
 status_t server::findmod(const std::string& mod_name,
                          boost::uuids::uuid& mod_id) {
   for (auto& mod : m_modules) {
-    if (mod.name() == mod_name) {
-      mod_id = mod.id();
+    if (nullptr != mod && mod->name() == mod_name) {
+      mod_id = mod->id();
       return OK;
     }
   } /* for(mod..) */
   return ERROR;
 } /* findmod() */
 
-status_t server::rmmod(const boost::uuids::uuid& id) {
-  server_mod tmp(id, er_lvl::NOM, er_lvl::NOM, "tmp");
-  auto iter = std::find(m_modules.begin(), m_modules.end(), tmp);
-  m_modules.erase(iter);
+status_t server::rmmod(mod_handle handle) {
+  server_mod* mod = mod_get(handle);
+  CHECK(nullptr != mod);
+  m_index.erase(mod->key());
+  m_modules[handle].reset();
+  m_free_handles.push_back(handle);
+  m_generation.fetch_add(1, std::memory_order_acq_rel);
   return OK;
+
+error:
+  return ERROR;
 } /* rmmod() */
 
+std::shared_ptr<const std::atomic<int>> server::mod_gate(mod_handle handle) {
+  server_mod* mod = mod_get(handle);
+  return (nullptr != mod) ? mod->gate() : nullptr;
+} /* mod_gate() */
+
+mod_handle server::msg_handle(const msg_int& msg) const {
+  /*
+   * The handle is only a hint: the module may have been removed and its slot
+   * reused since the message was reported.
+   */
+  server_mod* mod = mod_get(msg.handle);
+  if (nullptr != mod && mod->key() == mod_idgen::key(msg.id)) {
+    return msg.handle;
+  }
+  return mod_lookup(msg.id);
+} /* msg_handle() */
+
+server_mod* server::msg_route(const msg_int& msg,
+                             mod_handle* const handle,
+                             bool* const to_log,
+                             bool* const to_dbg) const {
+  *handle = msg_handle(msg);
+  server_mod* mod = mod_get(*handle);
+  if (nullptr == mod) {
+    return nullptr;
+  }
+  *to_log = msg.lvl <= mod->loglvl();
+/* If NDEBUG is defined, debug printing is disabled. */
+#ifndef NDEBUG
+  *to_dbg = msg.lvl <= mod->dbglvl();
+#else
+  *to_dbg = false;
+#endif
+  return mod;
+} /* msg_route() */
+
 void server::msg_report(const msg_int& msg) {
-  server_mod tmp(msg.id, er_lvl::NOM, er_lvl::NOM, "tmp");
-  auto iter = std::find(m_modules.begin(), m_modules.end(), tmp);
+  mod_handle handle;
+  bool to_log = false;
+  bool to_dbg = false;
+  server_mod* mod = msg_route(msg, &handle, &to_log, &to_dbg);
+  if (nullptr == mod) {
+    m_metrics.filtered(kINVALID_MOD_HANDLE, msg.lvl);
+    return;
+  }
+  msg_write(handle, mod->name(), msg, to_log, to_dbg);
+} /* msg_report() */
+
+void server::msg_write(mod_handle handle,
+                       const std::string& mod_name,
+                       const msg_int& msg,
+                       bool to_log,
+                       bool to_dbg) {
+  /* Logged messages go to the binary log instead of the logfile, if open */
+  std::size_t bytes = 0;
+  if (to_log && nullptr != m_binlog) {
+    m_binlog->record(m_ts_fmt.wall_ns(msg.ts), handle, mod_name, msg);
+    bytes += binlog_format::kRECORD_HEADER_SIZE + msg.str.size();
+    to_log = false;
+  }
+  if (!to_log && !to_dbg) {
+    msg_count(handle, msg, bytes);
+    return;
+  }
+
+  /* Deferred messages are only formatted if someone is going to see them */
+  std::string formatted;
+  if (nullptr != msg.fmt) {
+    formatted = deferred_formatter::format(*msg.fmt, msg.str);
+  }
+  const std::string& text = (nullptr != msg.fmt) ? formatted : msg.str;
+
+  std::string builtin;
+  if ((to_log && m_log_ts_builtin) || (to_dbg && m_dbg_ts_builtin)) {
+    builtin = m_ts_fmt.format(msg.ts);
+  }
 
   std::string header;
-  if (iter != m_modules.end()) {
+  if (to_log) {
     if (m_log_ts_calculator) {
       header = m_log_ts_calculator();
+    } else if (m_log_ts_builtin) {
+      header = builtin;
     }
-    iter->msg_report(header, msg.str, msg.lvl, iter->loglvl(), *m_logfile);
-
-/* If NDEBUG is defined, debug printing is disabled. */
-#ifndef NDEBUG
+    bytes += record_write(header, mod_name, text, msg.lvl, m_log_sink.get());
+  }
+  if (to_dbg) {
     header = "";
     if (m_dbg_ts_calculator) {
       header = m_dbg_ts_calculator();
+    } else if (m_dbg_ts_builtin) {
+      header = builtin;
     }
-    iter->msg_report(header, msg.str, msg.lvl, iter->dbglvl(), std::cout);
-#endif
+    bytes += record_write(header, mod_name, text, msg.lvl, m_dbg_sink.get());
   }
-} /* msg_report() */
+  msg_count(handle, msg, bytes);
+} /* msg_write() */
+
+void server::msg_count(mod_handle handle,
+                       const msg_int& msg,
+                       std::size_t bytes) {
+  if (0 == bytes) {
+    m_metrics.filtered(handle, msg.lvl);
+    return;
+  }
+  m_metrics.emitted(handle, msg.lvl, bytes);
+  if (0 != msg.t_report) {
+    m_metrics.latency(timestamp::precise() - msg.t_report);
+  }
+} /* msg_count() */
+
+void server::metrics_dump(std::ostream& os) const {
+  metrics_dump_mods(os);
+  er_metrics::dump_counts(os, "<unattributed>", m_metrics.unattributed());
+  er_metrics::dump_counts(os, "<total>", m_metrics.totals());
+  m_metrics.dump_latency(os);
+} /* metrics_dump() */
+
+void server::metrics_dump_mods(std::ostream& os) const {
+  for (std::size_t i = 0; i < m_modules.size(); ++i) {
+    if (nullptr != m_modules[i]) {
+      er_metrics::dump_counts(os, m_modules[i]->name(),
+                              m_metrics.mod_counts(static_cast<mod_handle>(i)));
+    }
+  } /* for(i..) */
+} /* metrics_dump_mods() */
 
 void server::flush(void) {
+  limits_flush();
+  if (nullptr != m_binlog) {
+    m_binlog->flush();
+  }
+  m_log_sink->flush();
+  m_dbg_sink->flush();
   std::fflush(nullptr);
-  m_logfile->flush();
 } /* flush() */
 
-status_t server::mod_dbglvl(const boost::uuids::uuid& id,
-                            const er_lvl::value& lvl) {
-  server_mod mod(id, er_lvl::NOM, er_lvl::NOM, "tmp");
+void server::sinks_poll(void) {
+  if (nullptr != m_binlog) {
+    m_binlog->poll();
+  }
+  m_log_sink->poll();
+  m_dbg_sink->poll();
+} /* sinks_poll() */
+
+void server::log_sink(std::unique_ptr<sink> s) {
+  m_log_sink->flush();
+  m_log_buf.target(s.get());
+  m_log_sink = std::move(s);
+} /* log_sink() */
+
+void server::dbg_sink(std::unique_ptr<sink> s) {
+  m_dbg_sink->flush();
+  m_dbg_buf.target(s.get());
+  m_dbg_sink = std::move(s);
+} /* dbg_sink() */
+
+void server::binlog(std::unique_ptr<binlog_writer> writer) {
+  m_binlog = std::move(writer);
+} /* binlog() */
+
+void server::recorder(std::shared_ptr<flight_recorder> rec) {
+  m_recorder = std::move(rec);
+  if (nullptr != m_recorder) {
+    for (std::size_t i = 0; i < m_modules.size(); ++i) {
+      if (nullptr != m_modules[i]) {
+        m_recorder->mod_name(static_cast<mod_handle>(i), m_modules[i]->name());
+      }
+    } /* for(i..) */
+  }
+  /* clients need to pick up the new recorder */
+  m_generation.fetch_add(1, std::memory_order_acq_rel);
+} /* recorder() */
+
+void server::change_binlog(const std::string& new_fname) {
+  if (new_fname == "__no_file__") {
+    binlog(nullptr);
+    return;
+  }
+#ifdef RCPPSW_WITH_IO_URING
+  std::unique_ptr<sink> out(new async_file_sink(new_fname));
+#else
+  std::unique_ptr<sink> out(new file_sink(new_fname));
+#endif
+  binlog(std::unique_ptr<binlog_writer>(new binlog_writer(std::move(out))));
+} /* change_binlog() */
 
+status_t server::mod_dbglvl(mod_handle handle, const er_lvl::value& lvl) {
   /* make sure module is already present */
-  auto iter = std::find(m_modules.begin(), m_modules.end(), mod);
-  CHECK(iter != m_modules.end());
-  iter->set_dbglvl(lvl);
+  server_mod* mod = mod_get(handle);
+  CHECK(nullptr != mod);
+  mod->set_dbglvl(lvl);
 
   REPORT_INTERNAL(er_lvl::VER,
                   "Successfully updated dbglvl for module %s",
-                  iter->name().c_str());
+                  mod->name().c_str());
   return OK;
 
 error:
   REPORT_INTERNAL(er_lvl::ERR,
-                  "Failed to update dbglvl for module %s: no such module",
-                  iter->name().c_str());
+                  "Failed to update dbglvl for module %u: no such module",
+                  handle);
   return ERROR;
 } /* mod_dbglvl() */
 
 er_lvl::value server::mod_dbglvl(const boost::uuids::uuid& id) {
-  server_mod mod(id, er_lvl::NOM, er_lvl::NOM, "tmp");
-
   /* make sure module is already present */
-  auto iter = std::find(m_modules.begin(), m_modules.end(), mod);
-  CHECK(iter != m_modules.end());
-  return iter->dbglvl();
+  server_mod* mod = mod_get(mod_lookup(id));
+  CHECK(nullptr != mod);
+  return mod->dbglvl();
 
 error:
   return static_cast<er_lvl::value>(-1);
 } /* dbglvl() */
 
 er_lvl::value server::mod_loglvl(const boost::uuids::uuid& id) {
-  server_mod mod(id, er_lvl::NOM, er_lvl::NOM, "tmp");
-
   /* make sure module is already present */
-  auto iter = std::find(m_modules.begin(), m_modules.end(), mod);
-  CHECK(iter != m_modules.end());
-  return iter->loglvl();
+  server_mod* mod = mod_get(mod_lookup(id));
+  CHECK(nullptr != mod);
+  return mod->loglvl();
 
 error:
   return static_cast<er_lvl::value>(-1);
 } /* loglvl() */
 
 void server::change_logfile(const std::string& new_fname) {
-  m_logfile->close();
-  if (boost::filesystem::exists(new_fname)) {
-    boost::filesystem::remove(new_fname);
-  }
   m_logfile_fname = new_fname;
   if (m_logfile_fname != "__no_file__") {
-    m_logfile->open(m_logfile_fname.c_str());
+#ifdef RCPPSW_WITH_IO_URING
+    log_sink(std::unique_ptr<sink>(new async_file_sink(m_logfile_fname)));
+#else
+    log_sink(std::unique_ptr<sink>(new file_sink(m_logfile_fname)));
+#endif
+  } else {
+    log_sink(std::unique_ptr<sink>(new null_sink()));
   }
 } /* change_logfile() */
 
-status_t server::mod_loglvl(const boost::uuids::uuid& id,
-                            const er_lvl::value& lvl) {
-  server_mod mod(id, er_lvl::NOM, er_lvl::NOM, "tmp");
-
+status_t server::mod_loglvl(mod_handle handle, const er_lvl::value& lvl) {
   /* make sure module is already present */
-  auto iter = std::find(m_modules.begin(), m_modules.end(), mod);
-  CHECK(iter != m_modules.end());
-  iter->set_loglvl(lvl);
+  server_mod* mod = mod_get(handle);
+  CHECK(nullptr != mod);
+  mod->set_loglvl(lvl);
 
   REPORT_INTERNAL(er_lvl::VER,
                   "Successfully updated loglvl for module %s",
-                  iter->name().c_str());
+                  mod->name().c_str());
   return OK;
 
 error:
   REPORT_INTERNAL(er_lvl::ERR,
-                  "Failed to update loglvl for module %s: no such module",
-                  iter->name().c_str());
+                  "Failed to update loglvl for module %u: no such module",
+                  handle);
   return ERROR;
 } /* mod_loglvl() */
 
-boost::uuids::uuid server::idgen(void) { return m_generator(); } /* idgen() */
+status_t server::mod_limits(mod_handle handle,
+                            const mod_limiter::config& cfg) {
+  server_mod* mod = mod_get(handle);
+  CHECK(nullptr != mod);
+  mod->set_limits(cfg);
+
+  /* clients need to pick up the new limiter */
+  m_generation.fetch_add(1, std::memory_order_acq_rel);
+  return OK;
 
-std::ostream& server::dbg_stream(void) { return std::cout; }
-std::ofstream& server::log_stream(void) { return *m_logfile; }
+error:
+  REPORT_INTERNAL(er_lvl::ERR,
+                  "Failed to update limits for module %u: no such module",
+                  handle);
+  return ERROR;
+} /* mod_limits() */
+
+std::shared_ptr<mod_limiter> server::limiter(mod_handle handle) const {
+  server_mod* mod = mod_get(handle);
+  return (nullptr != mod) ? mod->limiter() : nullptr;
+} /* limiter() */
+
+void server::limits_flush(void) {
+  for (std::size_t i = 0; i < m_modules.size(); ++i) {
+    server_mod* mod = m_modules[i].get();
+    if (nullptr == mod || nullptr == mod->limiter()) {
+      continue;
+    }
+    uint64_t n = mod->limiter()->suppressed_take();
+    if (0 == n) {
+      continue;
+    }
+    auto handle = static_cast<mod_handle>(i);
+    msg_int msg(mod->id(),
+                handle,
+                mod->limiter()->cfg().lvl,
+                nullptr,
+                mod_limiter::summary(n));
+    bool to_log = false;
+    bool to_dbg = false;
+    if (nullptr != msg_route(msg, &handle, &to_log, &to_dbg)) {
+      msg_write(handle, mod->name(), msg, to_log, to_dbg);
+    }
+  } /* for(i..) */
+} /* limits_flush() */
 
 NS_END(er, rcpppsw);
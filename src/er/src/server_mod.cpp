@@ -22,8 +22,9 @@
  * Includes
  ******************************************************************************/
 #include "rcppsw/er/server_mod.hpp"
+#include <algorithm>
 #include <boost/uuid/uuid_io.hpp>
-#include <fstream>
+#include <ostream>
 
 /*******************************************************************************
  * Namespaces
@@ -37,38 +38,50 @@ server_mod::server_mod(boost::uuids::uuid id,
                        er_lvl::value loglvl,
                        er_lvl::value dbglvl,
                        std::string name)
-    : m_id(id), m_name(std::move(name)), m_loglvl(loglvl), m_dbglvl(dbglvl) {}
+    : m_key(mod_idgen::key(id)),
+      m_name(std::move(name)),
+      m_loglvl(loglvl),
+      m_dbglvl(dbglvl),
+      m_gate(std::make_shared<std::atomic<int>>(er_lvl::OFF)) {
+  gate_update();
+}
 
 server_mod::server_mod(boost::uuids::uuid id, std::string name)
-    : m_id(id),
-      m_name(std::move(name)),
-      m_loglvl(er_lvl::NOM),
-      m_dbglvl(er_lvl::NOM) {}
+    : server_mod(id, er_lvl::NOM, er_lvl::NOM, std::move(name)) {}
 
 /*******************************************************************************
  * Member Functions
  ******************************************************************************/
 void server_mod::set_dbglvl(const er_lvl::value& lvl) {
   m_dbglvl = lvl;
+  gate_update();
 } /* set_dbglvl() */
 
 void server_mod::set_loglvl(const er_lvl::value& lvl) {
   m_loglvl = lvl;
+  gate_update();
 } /* set_loglvl() */
 
-void server_mod::msg_report(const std::string& header,
-                            const std::string& msg,
-                            er_lvl::value msg_lvl,
-                            er_lvl::value log_lvl,
-                            std::ostream& stream) const {
-  if (msg_lvl <= log_lvl) {
-    stream << header << " " << name() << ": " << msg;
-    stream.flush();
+void server_mod::set_limits(const mod_limiter::config& cfg) {
+  std::shared_ptr<mod_limiter> old = m_limiter;
+  m_limiter = cfg.active() ? std::make_shared<mod_limiter>(cfg) : nullptr;
+  if (nullptr != old && nullptr != m_limiter) {
+    m_limiter->suppressed_add(old->suppressed_take());
   }
-} /* server_mod::msg_report() */
+} /* set_limits() */
+
+void server_mod::gate_update(void) {
+/* If NDEBUG is defined, debug printing is disabled (see server::msg_route()) */
+#ifndef NDEBUG
+  int lvl = std::max(static_cast<int>(m_loglvl), static_cast<int>(m_dbglvl));
+#else
+  int lvl = m_loglvl;
+#endif
+  m_gate->store(lvl, std::memory_order_relaxed);
+} /* gate_update() */
 
 bool server_mod::operator==(const server_mod& rhs) {
-  return (this->m_id == rhs.m_id);
+  return (this->m_key == rhs.m_key);
 } /* operator==() */
 
 std::ostream& operator<<(std::ostream& os, const server_mod& mod) {
@@ -0,0 +1,298 @@
+/**
+ * @file sharded_server.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/sharded_server.hpp"
+#include <algorithm>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/thread.hpp>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+namespace {
+std::atomic<uint64_t> g_next_id{0};
+} // namespace
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+constexpr std::size_t sharded_server::kDEFAULT_SHARD_SIZE;
+constexpr uint64_t sharded_server::kIDLE;
+constexpr std::size_t sharded_server::kWAIT_TIMEOUT_MS;
+
+sharded_server::sharded_server(const std::string& logfile_fname,
+                               const er_lvl::value& dbglvl,
+                               const er_lvl::value& loglvl,
+                               std::size_t shard_size,
+                               multithread::overflow_policy::value policy)
+    : server(logfile_fname, dbglvl, loglvl),
+      mc_id(g_next_id.fetch_add(1, std::memory_order_relaxed)),
+      mc_shard_size(shard_size),
+      mc_policy(policy) {}
+
+sharded_server::~sharded_server(void) {
+  join();
+
+  /* so threads drop our shards from their caches */
+  boost::lock_guard<boost::mutex> lock(m_registry_mtx);
+  for (auto& s : m_registry) {
+    s->dead.store(true, std::memory_order_release);
+  } /* for(&s..) */
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+std::size_t sharded_server::n_shards(void) const {
+  boost::lock_guard<boost::mutex> lock(m_registry_mtx);
+  return m_registry.size();
+} /* n_shards() */
+
+uint64_t sharded_server::n_dropped(void) const {
+  boost::lock_guard<boost::mutex> lock(m_registry_mtx);
+  uint64_t n = 0;
+  for (auto& s : m_registry) {
+    n += s->ring.n_dropped();
+  } /* for(&s..) */
+  return n;
+} /* n_dropped() */
+
+sharded_server::shard* sharded_server::shard_get(void) {
+  /*
+   * The shards a thread has registered, keyed by server id. When the thread
+   * exits its shards are marked as orphaned, so the merger can retire them once
+   * they are empty; the shared_ptr keeps them alive until both sides are done
+   * with them. Shards of servers that have been destroyed are marked as dead,
+   * and dropped from the cache the next time it is searched.
+   */
+  struct tls_shards {
+    ~tls_shards(void) {
+      for (auto& pair : shards) {
+        pair.second->orphaned.store(true, std::memory_order_release);
+      } /* for(&pair..) */
+    }
+    std::unordered_map<uint64_t, std::shared_ptr<shard>> shards{};
+    uint64_t last_id{kIDLE};
+    shard* last{nullptr};
+  };
+  static thread_local tls_shards tls;
+
+  if (mc_id == tls.last_id) {
+    return tls.last;
+  }
+  auto it = tls.shards.find(mc_id);
+  if (it == tls.shards.end()) {
+    for (auto dit = tls.shards.begin(); dit != tls.shards.end();) {
+      if (dit->second->dead.load(std::memory_order_acquire)) {
+        dit = tls.shards.erase(dit);
+      } else {
+        ++dit;
+      }
+    } /* for(dit..) */
+    auto s = std::make_shared<shard>(mc_shard_size, mc_policy);
+    {
+      boost::lock_guard<boost::mutex> lock(m_registry_mtx);
+      m_registry.push_back(s);
+    }
+    m_registry_gen.fetch_add(1, std::memory_order_release);
+    it = tls.shards.insert(std::make_pair(mc_id, std::move(s))).first;
+  }
+  tls.last_id = mc_id;
+  tls.last = it->second.get();
+  return tls.last;
+} /* shard_get() */
+
+void sharded_server::dispatch(msg_int msg) {
+  shard* s = shard_get();
+
+  /*
+   * Publish before stamping, so that the merger either sees a timestamp no
+   * later than the one on the message, or started looking before the message
+   * was stamped.
+   */
+  s->inflight.store(timestamp::precise(), std::memory_order_seq_cst);
+  msg.ts = timestamp::precise();
+  s->ring.enqueue(std::move(msg), [this](const msg_int& dropped) {
+    metrics().dropped(dropped.handle, dropped.lvl);
+  });
+  s->inflight.store(kIDLE, std::memory_order_seq_cst);
+
+  /*
+   * Pairs with the fence in sleep(): either the merger sees the message when
+   * it checks the shards before sleeping, or we see that it is asleep and
+   * wake it. Only a read of shared memory unless the merger is asleep.
+   */
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_sleeping.load(std::memory_order_relaxed)) {
+    wake();
+  }
+} /* dispatch() */
+
+uint64_t sharded_server::horizon(void) const {
+  uint64_t ret = timestamp::precise();
+  for (auto& s : m_shards) {
+    ret = std::min(ret, s->inflight.load(std::memory_order_seq_cst));
+  } /* for(&s..) */
+  return ret;
+} /* horizon() */
+
+bool sharded_server::shards_idle(void) const {
+  if (m_registry_gen.load(std::memory_order_relaxed) != m_shards_gen) {
+    return false;
+  }
+  for (auto& s : m_shards) {
+    if (!s->staged.empty() || !s->ring.empty()) {
+      return false;
+    }
+  } /* for(&s..) */
+  return true;
+} /* shards_idle() */
+
+void sharded_server::sleep(uint32_t epoch) {
+  m_sleeping.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  bool idle = false;
+  {
+    boost::lock_guard<boost::mutex> lock(m_merge_mtx);
+    idle = shards_idle();
+  }
+  if (idle && !terminated()) {
+    multithread::futex::wait_for(&m_wake, epoch, kWAIT_TIMEOUT_MS);
+  }
+  m_sleeping.store(false, std::memory_order_relaxed);
+} /* sleep() */
+
+void sharded_server::shards_refresh(void) {
+  uint64_t gen = m_registry_gen.load(std::memory_order_acquire);
+  bool orphans = false;
+  for (auto& s : m_shards) {
+    orphans |= s->orphaned.load(std::memory_order_acquire) &&
+               s->staged.empty() && s->ring.empty();
+  } /* for(&s..) */
+  if (gen == m_shards_gen && !orphans) {
+    return;
+  }
+
+  boost::lock_guard<boost::mutex> lock(m_registry_mtx);
+  auto retired = [](const std::shared_ptr<shard>& s) {
+    return s->orphaned.load(std::memory_order_acquire) && s->staged.empty() &&
+           s->ring.empty();
+  };
+  m_registry.erase(std::remove_if(m_registry.begin(), m_registry.end(),
+                                  retired),
+                   m_registry.end());
+  m_shards = m_registry;
+  m_shards_gen = gen;
+} /* shards_refresh() */
+
+std::size_t sharded_server::merge(bool drain_all) {
+  shards_refresh();
+
+  /*
+   * The horizon must be computed before draining: anything stamped before it
+   * is guaranteed to already be in its shard.
+   */
+  uint64_t limit = drain_all ? kIDLE : horizon();
+  for (auto& s : m_shards) {
+    msg_int msg;
+    while (s->ring.try_dequeue(&msg)) {
+      s->staged.push_back(std::move(msg));
+    } /* while() */
+  } /* for(&s..) */
+
+  /*
+   * Each shard is already in timestamp order, so a k-way merge on the shard
+   * fronts gives the global order. Ties (messages stamped in the same
+   * nanosecond) are broken by shard index.
+   */
+  typedef std::pair<uint64_t, std::size_t> front_type;
+  std::priority_queue<front_type, std::vector<front_type>,
+                      std::greater<front_type>> fronts;
+  for (std::size_t i = 0; i < m_shards.size(); ++i) {
+    if (!m_shards[i]->staged.empty()) {
+      fronts.push(std::make_pair(m_shards[i]->staged.front().ts, i));
+    }
+  } /* for(i..) */
+
+  std::size_t n = 0;
+  while (!fronts.empty() && (drain_all || fronts.top().first < limit)) {
+    std::size_t i = fronts.top().second;
+    fronts.pop();
+    auto& staged = m_shards[i]->staged;
+    msg_report(staged.front());
+    staged.pop_front();
+    ++n;
+    if (!staged.empty()) {
+      fronts.push(std::make_pair(staged.front().ts, i));
+    }
+  } /* while() */
+  return n;
+} /* merge() */
+
+void sharded_server::flush(void) {
+  boost::lock_guard<boost::mutex> lock(m_merge_mtx);
+  merge(false);
+  server::flush();
+} /* flush() */
+
+void* sharded_server::thread_main(__unused void* arg) {
+  while (!terminated()) {
+    uint32_t epoch = m_wake.load(std::memory_order_acquire);
+    bool idle = false;
+    {
+      boost::lock_guard<boost::mutex> lock(m_merge_mtx);
+      merge(false);
+      idle = shards_idle();
+    }
+    sinks_poll();
+
+    /*
+     * Anything still staged is waiting on a thread in the middle of
+     * enqueueing, which will be done shortly, so there is no point sleeping.
+     */
+    if (idle) {
+      sleep(epoch);
+    } else {
+      boost::this_thread::yield();
+    }
+  } /* while() */
+
+  /* make sure all events remaining in the shards are reported */
+  {
+    boost::lock_guard<boost::mutex> lock(m_merge_mtx);
+    merge(true);
+  }
+  server::flush();
+  return nullptr;
+} /* thread_main() */
+
+NS_END(er, rcppsw);
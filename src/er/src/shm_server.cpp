@@ -0,0 +1,199 @@
+/**
+ * @file shm_server.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/shm_server.hpp"
+#include <boost/thread/lock_guard.hpp>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include "rcppsw/er/deferred_formatter.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+constexpr std::size_t shm_record::kMOD_NAME_LEN;
+constexpr std::size_t shm_record::kTEXT_LEN;
+constexpr std::size_t shm_server::kDEFAULT_N_RECORDS;
+constexpr multithread::overflow_policy::value shm_server::kPOLICY;
+constexpr std::size_t shm_server::kWAIT_TIMEOUT_MS;
+constexpr mod_handle shm_server::kREMOTE_HANDLE_BASE;
+
+shm_server::shm_server(const std::string& logfile_fname,
+                       const er_lvl::value& dbglvl,
+                       const er_lvl::value& loglvl,
+                       const std::string& shm_name,
+                       std::size_t n_records)
+    : server(logfile_fname, dbglvl, loglvl),
+      mc_owner(getpid()),
+      m_shm_name(shm_name.empty() ? "rcppsw-er-" + std::to_string(mc_owner)
+                                  : shm_name) {
+  namespace bip = multiprocess::bip;
+
+  /* room for the slots, plus the ring itself and the segment bookkeeping */
+  std::size_t size = (n_records + 1) * (sizeof(shm_record) + 64) + 65536;
+  bip::shared_memory_object::remove(m_shm_name.c_str());
+  m_segment.reset(new bip::managed_shared_memory(bip::create_only,
+                                                 m_shm_name.c_str(),
+                                                 size));
+  multiprocess::ipc_allocator<shm_record> alloc(
+      m_segment->get_segment_manager());
+  m_ring = m_segment->construct<ring_type>("ring")(n_records, kPOLICY, alloc);
+}
+
+shm_server::~shm_server(void) {
+  if (!collector()) {
+    return;
+  }
+  join();
+  m_segment->destroy<ring_type>("ring");
+  m_segment.reset();
+  multiprocess::bip::shared_memory_object::remove(m_shm_name.c_str());
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void shm_server::dispatch(msg_int msg) {
+  mod_handle handle;
+  bool to_log = false;
+  bool to_dbg = false;
+  server_mod* mod = msg_route(msg, &handle, &to_log, &to_dbg);
+  if (nullptr == mod) {
+    metrics().filtered(kINVALID_MOD_HANDLE, msg.lvl);
+    return;
+  } else if (!to_log && !to_dbg) {
+    metrics().filtered(handle, msg.lvl);
+    return;
+  }
+
+  shm_record rec;
+  rec.ts = msg.ts;
+  rec.pid = getpid();
+  rec.lvl = static_cast<uint8_t>(msg.lvl);
+  rec.to_log = to_log;
+  rec.to_dbg = to_dbg;
+
+  std::size_t n = std::min(mod->name().size(), shm_record::kMOD_NAME_LEN - 1);
+  std::memcpy(rec.mod_name, mod->name().data(), n);
+  rec.mod_name[n] = '\0';
+
+  std::string formatted;
+  if (nullptr != msg.fmt) {
+    formatted = deferred_formatter::format(*msg.fmt, msg.str);
+  }
+  const std::string& text = (nullptr != msg.fmt) ? formatted : msg.str;
+  rec.len = static_cast<uint16_t>(std::min(text.size(), shm_record::kTEXT_LEN));
+  std::memcpy(rec.text, text.data(), rec.len);
+  if (rec.len < text.size()) {
+    /* keep truncated messages on a line of their own */
+    rec.text[rec.len - 1] = '\n';
+  }
+
+  if (!m_ring->enqueue(rec)) {
+    metrics().dropped(handle, msg.lvl);
+  }
+} /* dispatch() */
+
+mod_handle shm_server::remote_handle(const std::string& mod_name) {
+  auto it = m_remote.find(mod_name);
+  if (it != m_remote.end()) {
+    return it->second;
+  }
+  boost::uuids::uuid id;
+  mod_handle handle = kINVALID_MOD_HANDLE;
+  if (OK == findmod(mod_name, id)) {
+    handle = mod_lookup(id);
+  } else {
+    handle = kREMOTE_HANDLE_BASE + static_cast<mod_handle>(m_remote.size());
+  }
+  m_remote[mod_name] = handle;
+  return handle;
+} /* remote_handle() */
+
+std::size_t shm_server::drain(void) {
+  shm_record rec;
+  std::size_t n = 0;
+  while (m_ring->try_dequeue(&rec)) {
+    msg_int msg(boost::uuids::uuid(),
+                kINVALID_MOD_HANDLE,
+                static_cast<er_lvl::value>(rec.lvl),
+                nullptr,
+                std::string(rec.text, rec.len));
+    msg.ts = rec.ts;
+    std::string mod_name(rec.mod_name);
+    msg_write(remote_handle(mod_name), mod_name, msg, rec.to_log, rec.to_dbg);
+    ++n;
+  } /* while() */
+  return n;
+} /* drain() */
+
+void shm_server::flush(void) {
+  if (!collector()) {
+    return;
+  }
+  boost::lock_guard<boost::mutex> lock(m_drain_mtx);
+  drain();
+  server::flush();
+} /* flush() */
+
+void shm_server::metrics_dump_mods(std::ostream& os) const {
+  server::metrics_dump_mods(os);
+
+  /* m_remote is updated by the collector thread while draining */
+  boost::lock_guard<boost::mutex> lock(m_drain_mtx);
+  std::vector<std::pair<mod_handle, std::string>> remote;
+  for (auto& r : m_remote) {
+    if (r.second >= kREMOTE_HANDLE_BASE) {
+      remote.emplace_back(r.second, r.first);
+    }
+  } /* for(r..) */
+  std::sort(remote.begin(), remote.end());
+  for (auto& r : remote) {
+    er_metrics::dump_counts(os, r.second, metrics().mod_counts(r.first));
+  } /* for(r..) */
+} /* metrics_dump_mods() */
+
+void* shm_server::thread_main(__unused void* arg) {
+  while (!terminated()) {
+    {
+      boost::lock_guard<boost::mutex> lock(m_drain_mtx);
+      drain();
+    }
+    sinks_poll();
+    m_ring->wait(kWAIT_TIMEOUT_MS);
+  } /* while() */
+
+  /* make sure all events remaining in the ring are reported */
+  boost::lock_guard<boost::mutex> lock(m_drain_mtx);
+  drain();
+  server::flush();
+  return nullptr;
+} /* thread_main() */
+
+NS_END(er, rcppsw);
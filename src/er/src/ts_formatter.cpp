@@ -0,0 +1,78 @@
+/**
+ * @file ts_formatter.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/er/ts_formatter.hpp"
+#include <time.h>
+#include <cstdio>
+#include "rcppsw/er/timestamp.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, er);
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+ts_formatter::ts_formatter(void) { offset_update(); }
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+uint64_t ts_formatter::wall_ns(uint64_t raw) const {
+  return static_cast<uint64_t>(static_cast<int64_t>(raw) + m_offset);
+} /* wall_ns() */
+
+std::string ts_formatter::format_wall(uint64_t wall_ns) {
+  uint64_t sec = wall_ns / timestamp::kNS_PER_SEC;
+  if (sec != m_cached_sec) {
+    auto t = static_cast<time_t>(sec);
+    struct tm tm;
+    char buf[32];
+    localtime_r(&t, &tm);
+    strftime(buf, sizeof(buf), "[%Y-%m-%d %H:%M:%S", &tm);
+    m_cached_prefix = buf;
+    m_cached_sec = sec;
+    offset_update();
+  }
+  char ms[8];
+  std::snprintf(ms,
+                sizeof(ms),
+                ".%03u]",
+                static_cast<unsigned>(wall_ns % timestamp::kNS_PER_SEC /
+                                      1000000));
+  return m_cached_prefix + ms;
+} /* format_wall() */
+
+void ts_formatter::offset_update(void) {
+  /* coarse, so both clocks advance on the same kernel tick */
+  struct timespec real;
+  clock_gettime(CLOCK_REALTIME_COARSE, &real);
+  uint64_t raw = timestamp::now();
+  m_offset = static_cast<int64_t>(static_cast<uint64_t>(real.tv_sec) *
+                                      timestamp::kNS_PER_SEC +
+                                  static_cast<uint64_t>(real.tv_nsec)) -
+             static_cast<int64_t>(raw);
+} /* offset_update() */
+
+NS_END(er, rcppsw);
@@ -0,0 +1,121 @@
+/**
+ * @file async_file_sink-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/er/async_file_sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::async_file_sink;
+using rcppsw::er::er_lvl;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static const char* kFNAME = "async_file_sink-test.log";
+
+static std::string slurp(const char* fname) {
+  std::ifstream in(fname);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Everything written reaches the file", "[async_file_sink]") {
+  std::string expected;
+  {
+    /* small buffer, so many batches are in flight at once */
+    async_file_sink s(kFNAME, false, 256, 0);
+    CATCH_REQUIRE(s.is_open());
+#ifndef RCPPSW_WITH_IO_URING
+    /* without liburing every batch goes through the blocking fallback */
+    CATCH_REQUIRE(!s.is_async());
+#endif
+    for (int i = 0; i < 5000; ++i) {
+      std::string rec = "record " + std::to_string(i) + "\n";
+      s.write(rec.data(), rec.size(), er_lvl::NOM);
+      expected += rec;
+    } /* for(i..) */
+    s.flush();
+    CATCH_REQUIRE(0 == s.queue_depth());
+    CATCH_REQUIRE(s.max_queue_depth() <= async_file_sink::kQUEUE_DEPTH);
+    CATCH_REQUIRE(s.n_writes() > 0);
+    CATCH_REQUIRE(0 == s.n_errors());
+    CATCH_REQUIRE(s.max_latency_us() >= s.mean_latency_us());
+    CATCH_REQUIRE(expected == slurp(kFNAME));
+
+    /* flushing again writes nothing new */
+    uint64_t n = s.n_writes();
+    s.flush();
+    CATCH_REQUIRE(n == s.n_writes());
+  }
+  std::remove(kFNAME);
+}
+
+CATCH_TEST_CASE("Concurrent writers", "[async_file_sink]") {
+  {
+    async_file_sink s(kFNAME, true, 1024, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&s, t]() {
+        for (int i = 0; i < 1000; ++i) {
+          std::string rec(10, static_cast<char>('a' + t));
+          rec.back() = '\n';
+          s.write(rec.data(), rec.size(), (0 == i % 100) ? er_lvl::ERR
+                                                          : er_lvl::NOM);
+        } /* for(i..) */
+      });
+    } /* for(t..) */
+    for (auto& t : threads) {
+      t.join();
+    } /* for(&t..) */
+  }
+  /* the destructor flushes; records are never interleaved */
+  std::string contents = slurp(kFNAME);
+  CATCH_REQUIRE(4 * 1000 * 10 == contents.size());
+  for (std::size_t i = 0; i < contents.size(); i += 10) {
+    CATCH_REQUIRE(std::string(9, contents[i]) == contents.substr(i, 9));
+  } /* for(i..) */
+  std::remove(kFNAME);
+}
+
+CATCH_TEST_CASE("Unopenable file", "[async_file_sink]") {
+  async_file_sink s("/nonexistent-dir/x.log");
+  CATCH_REQUIRE(!s.is_open());
+  CATCH_REQUIRE(!s.is_async());
+  s.write("lost\n", 5, er_lvl::ERR);
+  s.flush();
+  CATCH_REQUIRE(0 == s.n_writes());
+}
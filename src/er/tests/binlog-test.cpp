@@ -0,0 +1,115 @@
+/**
+ * @file binlog-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <string>
+#include "rcppsw/er/binlog_reader.hpp"
+#include "rcppsw/er/binlog_writer.hpp"
+#include "rcppsw/er/deferred_encoder.hpp"
+#include "rcppsw/er/file_sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::binlog_reader;
+using rcppsw::er::binlog_writer;
+using rcppsw::er::deferred_encoder;
+using rcppsw::er::er_lvl;
+using rcppsw::er::file_sink;
+using rcppsw::er::fmt_descriptor;
+using rcppsw::er::server;
+using rcppsw::er::sink;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static const fmt_descriptor kDESC = {"foo.cpp", 17, "bar", "x=%d y=%s"};
+static const char* kFNAME = "binlog-test.bin";
+
+/*
+ * 3 blocks: module 0 at NOM, module 1 at WARN (which reuses handle 0 after
+ * module 0 is removed), then module 0 again with deferred records.
+ */
+static void binlog_write(void) {
+  binlog_writer w(std::unique_ptr<sink>(new file_sink(kFNAME)), 256, 0);
+  server::msg_int msg;
+  msg.lvl = er_lvl::NOM;
+  msg.str = "text message\n";
+  for (uint64_t ts = 0; ts < 10; ++ts) {
+    w.record(ts, 0, "mod0", msg);
+  } /* for(ts..) */
+  msg.lvl = er_lvl::WARN;
+  w.record(100, 0, "mod1", msg);
+  w.flush();
+
+  server::msg_int deferred(boost::uuids::uuid(), 0, er_lvl::DIAG, &kDESC,
+                           deferred_encoder::encode(4, "four"));
+  w.record(200, 0, "mod0", deferred);
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Round trip", "[binlog]") {
+  binlog_write();
+  binlog_reader r(kFNAME);
+  binlog_reader::record rec;
+  CATCH_REQUIRE(r.is_valid());
+  for (uint64_t ts = 0; ts < 10; ++ts) {
+    CATCH_REQUIRE(r.next(&rec));
+    CATCH_REQUIRE(ts == rec.ts);
+    CATCH_REQUIRE("mod0" == rec.module);
+    CATCH_REQUIRE("text message\n" == rec.text);
+  } /* for(ts..) */
+  CATCH_REQUIRE(r.next(&rec));
+  CATCH_REQUIRE("mod1" == rec.module);
+  CATCH_REQUIRE(r.next(&rec));
+  CATCH_REQUIRE("foo.cpp:17:bar: x=4 y=four\n" == rec.text);
+  CATCH_REQUIRE(!r.next(&rec));
+}
+
+CATCH_TEST_CASE("Filtering", "[binlog]") {
+  binlog_write();
+  binlog_reader::filter f;
+  f.lvl = er_lvl::WARN;
+  binlog_reader r(kFNAME, f);
+  binlog_reader::record rec;
+  CATCH_REQUIRE(r.next(&rec));
+  CATCH_REQUIRE(er_lvl::WARN == rec.lvl);
+  CATCH_REQUIRE(!r.next(&rec));
+  CATCH_REQUIRE(r.n_blocks_skipped() > 0);
+
+  f = binlog_reader::filter();
+  f.module = "mod0";
+  f.ts_min = 5;
+  binlog_reader r2(kFNAME, f);
+  std::size_t n = 0;
+  while (r2.next(&rec)) {
+    CATCH_REQUIRE("mod0" == rec.module);
+    CATCH_REQUIRE(rec.ts >= 5);
+    ++n;
+  } /* while() */
+  CATCH_REQUIRE(6 == n);
+}
@@ -0,0 +1,123 @@
+/**
+ * @file buffered_sink-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/er/buffered_sink.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::buffered_sink;
+using rcppsw::er::er_lvl;
+
+/*******************************************************************************
+ * Test Classes
+ ******************************************************************************/
+/* records each batch handed to the device */
+class batch_sink : public buffered_sink {
+ public:
+  batch_sink(std::size_t capacity, uint32_t interval_ms, bool sync_on_err)
+      : buffered_sink(capacity, interval_ms, sync_on_err) {}
+  ~batch_sink(void) override { flush(); }
+
+  std::vector<std::string> batches{};
+  int n_syncs{0};
+
+ protected:
+  void sink_write(const char* data, std::size_t len) override {
+    batches.emplace_back(data, len);
+  }
+  void sink_sync(void) override { ++n_syncs; }
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Records are batched up to capacity", "[buffered_sink]") {
+  batch_sink s(16, 0, false);
+  s.write("aaaa", 4, er_lvl::NOM);
+  s.write("bbbb", 4, er_lvl::NOM);
+  s.write("cccc", 4, er_lvl::NOM);
+  CATCH_REQUIRE(s.batches.empty());
+  CATCH_REQUIRE(12 == s.buffered());
+
+  /* would not fit: the buffer goes out first */
+  s.write("dddddd", 6, er_lvl::NOM);
+  CATCH_REQUIRE(1 == s.batches.size());
+  CATCH_REQUIRE("aaaabbbbcccc" == s.batches[0]);
+  CATCH_REQUIRE(6 == s.buffered());
+
+  /* too big to ever fit: written straight through, after what is buffered */
+  std::string big(40, 'x');
+  s.write(big.data(), big.size(), er_lvl::NOM);
+  CATCH_REQUIRE(3 == s.batches.size());
+  CATCH_REQUIRE("dddddd" == s.batches[1]);
+  CATCH_REQUIRE(big == s.batches[2]);
+  CATCH_REQUIRE(0 == s.buffered());
+
+  s.write("e", 1, er_lvl::NOM);
+  s.flush();
+  CATCH_REQUIRE(4 == s.batches.size());
+  CATCH_REQUIRE("e" == s.batches[3]);
+  s.flush();
+  CATCH_REQUIRE(4 == s.batches.size());
+}
+
+CATCH_TEST_CASE("Errors are written out immediately", "[buffered_sink]") {
+  batch_sink plain(1024, 0, false);
+  plain.write("nom ", 4, er_lvl::NOM);
+  plain.write("err", 3, er_lvl::ERR);
+  CATCH_REQUIRE(1 == plain.batches.size());
+  CATCH_REQUIRE("nom err" == plain.batches[0]);
+  CATCH_REQUIRE(0 == plain.n_syncs);
+
+  batch_sink synced(1024, 0, true);
+  synced.write("nom ", 4, er_lvl::NOM);
+  CATCH_REQUIRE(0 == synced.n_syncs);
+  synced.write("err", 3, er_lvl::ERR);
+  CATCH_REQUIRE(1 == synced.batches.size());
+  CATCH_REQUIRE(1 == synced.n_syncs);
+}
+
+CATCH_TEST_CASE("Old records are flushed by poll", "[buffered_sink]") {
+  batch_sink s(1024, 10, false);
+  s.write("old", 3, er_lvl::NOM);
+  s.poll();
+  CATCH_REQUIRE(s.batches.empty());
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  s.poll();
+  CATCH_REQUIRE(1 == s.batches.size());
+
+  /* a write after the interval also flushes */
+  s.write("a", 1, er_lvl::NOM);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  s.write("b", 1, er_lvl::NOM);
+  CATCH_REQUIRE(2 == s.batches.size());
+  CATCH_REQUIRE("ab" == s.batches[1]);
+}
@@ -0,0 +1,147 @@
+/**
+ * @file deferred_fmt-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#define RCPPSW_ER_DEFERRED_FMT
+#include <catch.hpp>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "rcppsw/er/client.hpp"
+#include "rcppsw/er/deferred_encoder.hpp"
+#include "rcppsw/er/deferred_formatter.hpp"
+#include "rcppsw/er/server.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::client;
+using rcppsw::er::deferred_encoder;
+using rcppsw::er::deferred_formatter;
+using rcppsw::er::er_lvl;
+using rcppsw::er::server;
+using rcppsw::er::sink;
+
+/*******************************************************************************
+ * Test Classes
+ ******************************************************************************/
+class capture_sink : public sink {
+ public:
+  explicit capture_sink(std::vector<std::string>* out) : m_out(out) {}
+  void write(const char* data, std::size_t len, er_lvl::value) override {
+    m_out->emplace_back(data, len);
+  }
+  void flush(void) override {}
+
+ private:
+  std::vector<std::string>* m_out;
+};
+
+class test_client : public client {
+ public:
+  explicit test_client(std::shared_ptr<server> handle) : client(handle) {
+    insmod("test_module", er_lvl::NOM, er_lvl::OFF);
+  }
+  void run(void) {
+    ER_NOM("x=%d y=%s", 4, "four");
+    ER_NOM("no args");
+    ER_DIAG("filtered %d", 5);
+  }
+};
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/*
+ * Deferred formatting must produce exactly what snprintf() would have.
+ */
+#define CHECK_SAME(fmt, ...)                                               \
+  {                                                                        \
+    char _buf[1000];                                                       \
+    snprintf(_buf, sizeof(_buf), fmt, __VA_ARGS__);                        \
+    CATCH_REQUIRE(std::string(_buf) ==                                     \
+                  deferred_formatter::format(                              \
+                      fmt, deferred_encoder::encode(__VA_ARGS__)));        \
+  }
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Integers", "[deferred_fmt]") {
+  CHECK_SAME("%d %i %u", -17, 42, 7u);
+  CHECK_SAME("%lu items, %ld offset", 123456789012UL, -5L);
+  CHECK_SAME("[%5d] [%-5d] [%05d]", 3, 3, 3);
+  CHECK_SAME("%x %X %#o %c", 255, 255u, 8, 'z');
+  CHECK_SAME("%zu %hhd", sizeof(int), static_cast<char>(-3));
+}
+
+CATCH_TEST_CASE("Negative integers as unsigned", "[deferred_fmt]") {
+  CHECK_SAME("%x %X %u %o", -1, -255, -17, -8);
+  CHECK_SAME("%lx %lu", -1L, -2L);
+  CHECK_SAME("%x %u", static_cast<short>(-3), static_cast<char>(-4));
+}
+
+CATCH_TEST_CASE("Floating point", "[deferred_fmt]") {
+  CHECK_SAME("%f %.3f %e %g", 1.5, 2.0 / 3.0, 12345.678, 0.0001);
+  CHECK_SAME("%8.2f|%-8.2f|", 3.14159f, -2.5);
+}
+
+CATCH_TEST_CASE("Strings and pointers", "[deferred_fmt]") {
+  const char* name = "task";
+  char buf[] = "mutable";
+  int x = 0;
+  CHECK_SAME("Task '%s' aborted, %s", name, buf);
+  CHECK_SAME("[%10s] [%-10s] [%.2s]", name, name, name);
+  CHECK_SAME("data=%p", static_cast<void*>(&x));
+}
+
+CATCH_TEST_CASE("Star width/precision", "[deferred_fmt]") {
+  CHECK_SAME("[%*d] [%.*f]", 6, 42, 2, 3.14159);
+}
+
+CATCH_TEST_CASE("No arguments", "[deferred_fmt]") {
+  CATCH_REQUIRE("100% done" ==
+                deferred_formatter::format("100%% done",
+                                           deferred_encoder::encode()));
+}
+
+CATCH_TEST_CASE("Missing arguments", "[deferred_fmt]") {
+  CATCH_REQUIRE("a=1 b=<?>" ==
+                deferred_formatter::format("a=%d b=%d",
+                                           deferred_encoder::encode(1)));
+}
+
+CATCH_TEST_CASE("Reporting through a client", "[deferred_fmt]") {
+  std::vector<std::string> out;
+  auto handle = std::make_shared<server>("__no_file__", er_lvl::OFF,
+                                         er_lvl::NOM);
+  handle->log_sink(std::unique_ptr<sink>(new capture_sink(&out)));
+  test_client c(handle);
+  c.run();
+  handle->flush();
+  CATCH_REQUIRE(2 == out.size());
+  CATCH_REQUIRE(std::string::npos != out[0].find("test_module"));
+  CATCH_REQUIRE(std::string::npos != out[0].find("x=4 y=four\n"));
+  CATCH_REQUIRE(std::string::npos != out[1].find("no args\n"));
+}
@@ -0,0 +1,182 @@
+/**
+ * @file er_metrics-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "rcppsw/er/er_metrics.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::er_lvl;
+using rcppsw::er::er_metrics;
+using rcppsw::er::kINVALID_MOD_HANDLE;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Counts by module and level", "[er_metrics]") {
+  er_metrics m;
+  m.emitted(0, er_lvl::NOM, 10);
+  m.emitted(0, er_lvl::NOM, 5);
+  m.emitted(0, er_lvl::ERR, 1);
+  m.filtered(0, er_lvl::DIAG);
+  m.dropped(0, er_lvl::NOM);
+  m.emitted(100, er_lvl::WARN, 7);
+  m.filtered(kINVALID_MOD_HANDLE, er_lvl::VER);
+
+  auto c0 = m.mod_counts(0);
+  CATCH_REQUIRE(2 == c0.emitted[er_lvl::NOM]);
+  CATCH_REQUIRE(1 == c0.emitted[er_lvl::ERR]);
+  CATCH_REQUIRE(1 == c0.filtered[er_lvl::DIAG]);
+  CATCH_REQUIRE(1 == c0.dropped[er_lvl::NOM]);
+  CATCH_REQUIRE(16 == c0.bytes);
+  CATCH_REQUIRE(3 == c0.n_emitted());
+
+  CATCH_REQUIRE(1 == m.mod_counts(100).emitted[er_lvl::WARN]);
+  CATCH_REQUIRE(0 == m.mod_counts(5).n_emitted());
+  CATCH_REQUIRE(1 == m.unattributed().filtered[er_lvl::VER]);
+
+  auto tot = m.totals();
+  CATCH_REQUIRE(4 == tot.n_emitted());
+  CATCH_REQUIRE(2 == tot.n_filtered());
+  CATCH_REQUIRE(1 == tot.n_dropped());
+  CATCH_REQUIRE(23 == tot.bytes);
+}
+
+CATCH_TEST_CASE("Disabled counting", "[er_metrics]") {
+  er_metrics m;
+  m.enable(false);
+  m.emitted(0, er_lvl::NOM, 10);
+  m.filtered(0, er_lvl::NOM);
+  m.dropped(0, er_lvl::NOM);
+  m.latency(100);
+  CATCH_REQUIRE(0 == m.totals().n_emitted());
+  CATCH_REQUIRE(0 == m.totals().n_filtered());
+  CATCH_REQUIRE(0 == m.totals().n_dropped());
+  CATCH_REQUIRE(0 == m.latency_count());
+}
+
+CATCH_TEST_CASE("Filtered counts from several threads", "[er_metrics]") {
+  constexpr int kTHREADS = 4;
+  constexpr int kMSGS = 10000;
+  er_metrics m;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kTHREADS; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < kMSGS; ++i) {
+        m.filtered(1, er_lvl::DIAG);
+      } /* for(i..) */
+    });
+  } /* for(t..) */
+
+  /* queries while the threads are counting see a consistent subtotal */
+  uint64_t last = 0;
+  for (int i = 0; i < 100; ++i) {
+    uint64_t n = m.mod_counts(1).filtered[er_lvl::DIAG];
+    CATCH_REQUIRE(n >= last);
+    CATCH_REQUIRE(n <= static_cast<uint64_t>(kTHREADS) * kMSGS);
+    last = n;
+  } /* for(i..) */
+  for (auto& t : threads) {
+    t.join();
+  } /* for(&t..) */
+  CATCH_REQUIRE(kTHREADS * kMSGS == m.mod_counts(1).filtered[er_lvl::DIAG]);
+
+  /* the exited threads' counts are folded in when a new thread registers */
+  std::thread([&]() { m.filtered(1, er_lvl::DIAG); }).join();
+  CATCH_REQUIRE(kTHREADS * kMSGS + 1 ==
+                m.mod_counts(1).filtered[er_lvl::DIAG]);
+  CATCH_REQUIRE(kTHREADS * kMSGS + 1 == m.totals().n_filtered());
+}
+
+CATCH_TEST_CASE("Short-lived instances on one thread", "[er_metrics]") {
+  /* counters of destroyed instances are dropped from the thread's cache */
+  for (int i = 0; i < 200; ++i) {
+    er_metrics m;
+    m.filtered(1, er_lvl::DIAG);
+    m.filtered(1, er_lvl::DIAG);
+    CATCH_REQUIRE(2 == m.mod_counts(1).n_filtered());
+  } /* for(i..) */
+}
+
+CATCH_TEST_CASE("Reset", "[er_metrics]") {
+  er_metrics m;
+  m.emitted(0, er_lvl::NOM, 1);
+  m.filtered(0, er_lvl::DIAG);
+  m.filtered(1, er_lvl::DIAG);
+  std::thread([&]() { m.filtered(1, er_lvl::DIAG); }).join();
+
+  m.mod_reset(1);
+  CATCH_REQUIRE(0 == m.mod_counts(1).n_filtered());
+  CATCH_REQUIRE(1 == m.mod_counts(0).n_filtered());
+
+  /* counting resumes from 0 after a reset, in this thread's counters too */
+  m.filtered(1, er_lvl::DIAG);
+  CATCH_REQUIRE(1 == m.mod_counts(1).n_filtered());
+
+  m.latency(1000);
+  m.reset();
+  CATCH_REQUIRE(0 == m.totals().n_emitted());
+  CATCH_REQUIRE(0 == m.totals().n_filtered());
+  CATCH_REQUIRE(0 == m.latency_count());
+  m.filtered(0, er_lvl::DIAG);
+  CATCH_REQUIRE(1 == m.mod_counts(0).n_filtered());
+  CATCH_REQUIRE(1 == m.totals().n_filtered());
+}
+
+CATCH_TEST_CASE("Latency histogram", "[er_metrics]") {
+  er_metrics m;
+  CATCH_REQUIRE(0 == m.latency_percentile(50));
+  CATCH_REQUIRE(0 == er_metrics::bucket_bound(0));
+  CATCH_REQUIRE(1 == er_metrics::bucket_bound(1));
+  CATCH_REQUIRE(1023 == er_metrics::bucket_bound(10));
+
+  for (int i = 0; i < 99; ++i) {
+    m.latency(100); /* bucket 7: [64, 128) */
+  } /* for(i..) */
+  m.latency(5000); /* bucket 13: [4096, 8192) */
+
+  CATCH_REQUIRE(100 == m.latency_count());
+  CATCH_REQUIRE(5000 == m.latency_max_ns());
+  CATCH_REQUIRE(149.0 == m.latency_mean_ns());
+  CATCH_REQUIRE(99 == m.latency_hist()[7]);
+  CATCH_REQUIRE(1 == m.latency_hist()[13]);
+  CATCH_REQUIRE(127 == m.latency_percentile(50));
+  CATCH_REQUIRE(127 == m.latency_percentile(99));
+  CATCH_REQUIRE(8191 == m.latency_percentile(100));
+}
+
+CATCH_TEST_CASE("Dump", "[er_metrics]") {
+  er_metrics m;
+  m.emitted(0, er_lvl::NOM, 12);
+  m.filtered(0, er_lvl::DIAG);
+  std::ostringstream os;
+  er_metrics::dump_counts(os, "mod", m.mod_counts(0));
+  CATCH_REQUIRE("mod: emitted=1 filtered=1 dropped=0 bytes=12 NOM=1/0/0 "
+                "DIAG=0/1/0\n" == os.str());
+}
@@ -0,0 +1,203 @@
+/**
+ * @file flight_recorder-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <unistd.h>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/er/binlog_reader.hpp"
+#include "rcppsw/er/client.hpp"
+#include "rcppsw/er/deferred_encoder.hpp"
+#include "rcppsw/er/flight_recorder.hpp"
+#include "rcppsw/er/server.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::binlog_reader;
+using rcppsw::er::client;
+using rcppsw::er::deferred_encoder;
+using rcppsw::er::er_lvl;
+using rcppsw::er::flight_recorder;
+using rcppsw::er::fmt_descriptor;
+using rcppsw::er::server;
+
+/*******************************************************************************
+ * Test Classes
+ ******************************************************************************/
+class test_client : public client {
+ public:
+  explicit test_client(std::shared_ptr<server> handle) : client(handle) {}
+
+  void diag(int x) { ER_DIAG("x=%d", x); }
+  void warn(int y) { ER_WARN("y=%d", y); }
+};
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static const fmt_descriptor kDESC = {"foo.cpp", 17, "bar", "x=%d y=%s"};
+static const char* kFNAME = "flight_recorder-test.bin";
+
+static std::vector<binlog_reader::record> dump_read(void) {
+  std::vector<binlog_reader::record> ret;
+  binlog_reader r(kFNAME);
+  binlog_reader::record rec;
+  while (r.next(&rec)) {
+    ret.push_back(rec);
+  } /* while() */
+  std::remove(kFNAME);
+  return ret;
+}
+
+static void text_record(flight_recorder* rec,
+                        rcppsw::er::mod_handle handle,
+                        er_lvl::value lvl,
+                        const std::string& text) {
+  rec->record(handle, lvl, nullptr, text.data(), text.size());
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Record and dump", "[flight_recorder]") {
+  flight_recorder rec(16);
+  CATCH_REQUIRE(16 == rec.capacity());
+  rec.mod_name(0, "mod0");
+  rec.mod_name(3, "mod3");
+
+  text_record(&rec, 0, er_lvl::NOM, "first\n");
+  text_record(&rec, 3, er_lvl::VER, "second\n");
+  std::string args = deferred_encoder::encode(4, "four");
+  rec.record(0, er_lvl::DIAG, &kDESC, args.data(), args.size());
+  CATCH_REQUIRE(OK == rec.dump(kFNAME));
+
+  auto recs = dump_read();
+  CATCH_REQUIRE(3 == recs.size());
+  CATCH_REQUIRE("mod0" == recs[0].module);
+  CATCH_REQUIRE(er_lvl::NOM == recs[0].lvl);
+  CATCH_REQUIRE("first\n" == recs[0].text);
+  CATCH_REQUIRE("mod3" == recs[1].module);
+  CATCH_REQUIRE(er_lvl::VER == recs[1].lvl);
+  CATCH_REQUIRE("second\n" == recs[1].text);
+  CATCH_REQUIRE(er_lvl::DIAG == recs[2].lvl);
+  CATCH_REQUIRE("foo.cpp:17:bar: x=4 y=four\n" == recs[2].text);
+  CATCH_REQUIRE(recs[0].ts <= recs[1].ts);
+  CATCH_REQUIRE(recs[1].ts <= recs[2].ts);
+}
+
+CATCH_TEST_CASE("Oldest messages are overwritten", "[flight_recorder]") {
+  flight_recorder rec(5); /* rounded up to 8 */
+  CATCH_REQUIRE(8 == rec.capacity());
+  rec.mod_name(0, "mod");
+  for (int i = 0; i < 20; ++i) {
+    text_record(&rec, 0, er_lvl::NOM, std::to_string(i) + "\n");
+  } /* for(i..) */
+  CATCH_REQUIRE(OK == rec.dump(kFNAME));
+
+  auto recs = dump_read();
+  CATCH_REQUIRE(8 == recs.size());
+  for (std::size_t i = 0; i < recs.size(); ++i) {
+    CATCH_REQUIRE(std::to_string(12 + i) + "\n" == recs[i].text);
+  } /* for(i..) */
+}
+
+CATCH_TEST_CASE("Long messages are truncated", "[flight_recorder]") {
+  flight_recorder rec(4);
+  std::string text(flight_recorder::kPAYLOAD_SIZE * 2, 'x');
+  text_record(&rec, 0, er_lvl::NOM, text);
+  CATCH_REQUIRE(OK == rec.dump(kFNAME));
+
+  auto recs = dump_read();
+  CATCH_REQUIRE(1 == recs.size());
+  CATCH_REQUIRE(flight_recorder::kPAYLOAD_SIZE == recs[0].text.size());
+}
+
+CATCH_TEST_CASE("Record from several threads", "[flight_recorder]") {
+  constexpr int kTHREADS = 4;
+  flight_recorder rec(64);
+  rec.mod_name(0, "mod");
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kTHREADS; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        text_record(&rec, 0, er_lvl::NOM,
+                    "t" + std::to_string(t) + " " + std::to_string(i) + "\n");
+      } /* for(i..) */
+    });
+  } /* for(t..) */
+  for (auto& t : threads) {
+    t.join();
+  } /* for(&t..) */
+  CATCH_REQUIRE(OK == rec.dump(kFNAME));
+
+  /* the ring is full of intact messages */
+  auto recs = dump_read();
+  CATCH_REQUIRE(64 == recs.size());
+  for (auto& r : recs) {
+    int t = -1;
+    int i = -1;
+    CATCH_REQUIRE(2 == std::sscanf(r.text.c_str(), "t%d %d", &t, &i));
+    CATCH_REQUIRE(t < kTHREADS);
+    CATCH_REQUIRE(i < 1000);
+  } /* for(&r..) */
+}
+
+CATCH_TEST_CASE("Gated out messages are recorded", "[flight_recorder]") {
+  auto s = std::make_shared<server>("__no_file__", er_lvl::OFF, er_lvl::OFF);
+  auto rec = std::make_shared<flight_recorder>(16);
+  s->recorder(rec);
+  test_client c(s);
+  CATCH_REQUIRE(OK == c.insmod("mod", er_lvl::WARN, er_lvl::OFF));
+
+  c.diag(5);
+  c.warn(7);
+  CATCH_REQUIRE(OK == rec->dump(kFNAME));
+
+  auto recs = dump_read();
+  CATCH_REQUIRE(2 == recs.size());
+  CATCH_REQUIRE("mod" == recs[0].module);
+  CATCH_REQUIRE(er_lvl::DIAG == recs[0].lvl);
+  CATCH_REQUIRE(std::string::npos != recs[0].text.find(": x=5\n"));
+  CATCH_REQUIRE("mod" == recs[1].module);
+  CATCH_REQUIRE(er_lvl::WARN == recs[1].lvl);
+  CATCH_REQUIRE(std::string::npos != recs[1].text.find(": y=7\n"));
+}
+
+CATCH_TEST_CASE("Crash dumps happen once", "[flight_recorder]") {
+  flight_recorder rec(4);
+  text_record(&rec, 0, er_lvl::ERR, "boom\n");
+  rec.install(kFNAME);
+  flight_recorder::crash_dump();
+  CATCH_REQUIRE(1 == dump_read().size());
+
+  /* dump_read() removed the file; a second crash must not recreate it */
+  flight_recorder::crash_dump();
+  CATCH_REQUIRE(0 != access(kFNAME, F_OK));
+  rec.uninstall();
+}
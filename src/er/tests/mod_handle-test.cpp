@@ -0,0 +1,132 @@
+/**
+ * @file mod_handle-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "rcppsw/er/client.hpp"
+#include "rcppsw/er/server.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::client;
+using rcppsw::er::er_lvl;
+using rcppsw::er::kINVALID_MOD_HANDLE;
+using rcppsw::er::mod_handle;
+using rcppsw::er::server;
+
+/*******************************************************************************
+ * Test Classes
+ ******************************************************************************/
+class test_client : public client {
+ public:
+  explicit test_client(std::shared_ptr<server> handle) : client(handle) {}
+  using client::er_id;
+};
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Handles are dense and reused", "[mod_handle]") {
+  server s;
+  auto a = s.idgen();
+  auto b = s.idgen();
+  auto c = s.idgen();
+  uint64_t gen = s.generation();
+
+  CATCH_REQUIRE(0 == s.insmod_handle(a, er_lvl::NOM, er_lvl::NOM, "a"));
+  CATCH_REQUIRE(1 == s.insmod_handle(b, er_lvl::NOM, er_lvl::NOM, "b"));
+  CATCH_REQUIRE(kINVALID_MOD_HANDLE ==
+                s.insmod_handle(a, er_lvl::NOM, er_lvl::NOM, "a2"));
+  CATCH_REQUIRE(gen + 2 == s.generation());
+  CATCH_REQUIRE(1 == s.mod_lookup(b));
+
+  CATCH_REQUIRE(OK == s.rmmod(a));
+  CATCH_REQUIRE(ERROR == s.rmmod(a));
+  CATCH_REQUIRE(kINVALID_MOD_HANDLE == s.mod_lookup(a));
+  CATCH_REQUIRE(gen + 3 == s.generation());
+
+  /* the freed slot is handed out again */
+  CATCH_REQUIRE(0 == s.insmod_handle(c, er_lvl::NOM, er_lvl::NOM, "c"));
+  CATCH_REQUIRE(0 == s.mod_lookup(c));
+  CATCH_REQUIRE(nullptr == s.mod_gate(a));
+  CATCH_REQUIRE(nullptr != s.mod_gate(c));
+}
+
+CATCH_TEST_CASE("Stale handles are resolved by UUID", "[mod_handle]") {
+  const std::string kFNAME = "mod_handle-test.log";
+  server s(kFNAME, er_lvl::OFF, er_lvl::NOM);
+  auto a = s.idgen();
+  auto b = s.idgen();
+  mod_handle ha = s.insmod_handle(a, er_lvl::NOM, er_lvl::OFF, "mod_a");
+  CATCH_REQUIRE(OK == s.rmmod(ha));
+  mod_handle hb = s.insmod_handle(b, er_lvl::NOM, er_lvl::OFF, "mod_b");
+  CATCH_REQUIRE(ha == hb);
+
+  /* a message from the removed module carrying its old handle is dropped */
+  s.report(a, er_lvl::NOM, "from a\n", ha);
+  s.report(b, er_lvl::NOM, "from b\n", hb);
+  /* a bad hint is looked up by UUID */
+  s.report(b, er_lvl::NOM, "from b again\n", kINVALID_MOD_HANDLE);
+  s.flush();
+
+  std::vector<std::string> out;
+  std::ifstream in(kFNAME);
+  for (std::string line; std::getline(in, line);) {
+    out.push_back(line + "\n");
+  } /* for(line..) */
+  std::remove(kFNAME.c_str());
+  CATCH_REQUIRE(2 == out.size());
+  CATCH_REQUIRE(std::string::npos != out[0].find("mod_b: from b\n"));
+  CATCH_REQUIRE(std::string::npos != out[1].find("mod_b: from b again\n"));
+}
+
+CATCH_TEST_CASE("Clients follow level and module changes", "[mod_handle]") {
+  auto s = std::make_shared<server>("__no_file__", er_lvl::OFF, er_lvl::OFF);
+  test_client c(s);
+
+  /* not installed: nothing passes */
+  CATCH_REQUIRE(!c.er_enabled(er_lvl::ERR));
+
+  CATCH_REQUIRE(OK == c.insmod("mod", er_lvl::WARN, er_lvl::OFF));
+  CATCH_REQUIRE(c.er_enabled(er_lvl::ERR));
+  CATCH_REQUIRE(c.er_enabled(er_lvl::WARN));
+  CATCH_REQUIRE(!c.er_enabled(er_lvl::NOM));
+
+  /* level changes go through the shared gate, without a refresh */
+  CATCH_REQUIRE(OK == s->mod_dbglvl(c.er_id(), er_lvl::DIAG));
+  CATCH_REQUIRE(c.er_enabled(er_lvl::DIAG));
+  CATCH_REQUIRE(!c.er_enabled(er_lvl::VER));
+
+  /* removal bumps the generation, so the client drops its cached gate */
+  CATCH_REQUIRE(OK == c.rmmod());
+  CATCH_REQUIRE(!c.er_enabled(er_lvl::ERR));
+  CATCH_REQUIRE(OK == c.insmod("mod", er_lvl::ERR, er_lvl::OFF));
+  CATCH_REQUIRE(c.er_enabled(er_lvl::ERR));
+  CATCH_REQUIRE(!c.er_enabled(er_lvl::WARN));
+}
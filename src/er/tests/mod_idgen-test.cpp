@@ -0,0 +1,156 @@
+/**
+ * @file mod_idgen-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include "rcppsw/er/mod_idgen.hpp"
+#include "rcppsw/er/server.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::er_lvl;
+using rcppsw::er::mod_idgen;
+using rcppsw::er::mod_key;
+using rcppsw::er::server;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+/*
+ * Generate \a n IDs and return the # of distinct keys among them.
+ */
+static std::size_t distinct_keys(mod_idgen* gen, std::size_t n) {
+  std::set<mod_key> keys;
+  for (std::size_t i = 0; i < n; ++i) {
+    keys.insert(mod_idgen::key((*gen)()));
+  } /* for(i..) */
+  return keys.size();
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Sequential IDs", "[mod_idgen]") {
+  mod_idgen a;
+  mod_idgen b;
+  CATCH_REQUIRE(mod_idgen::SEQUENTIAL == a.get_mode());
+
+  /* a counter starting at 1, the same in every generator */
+  for (mod_key k = 1; k <= 100; ++k) {
+    auto id = a();
+    CATCH_REQUIRE(k == mod_idgen::key(id));
+    CATCH_REQUIRE(id == mod_idgen::from_key(k));
+    CATCH_REQUIRE(id == b());
+  } /* for(k..) */
+  CATCH_REQUIRE(!mod_idgen::from_key(1).is_nil());
+}
+
+CATCH_TEST_CASE("Hashed IDs", "[mod_idgen]") {
+  mod_idgen a(mod_idgen::HASHED);
+  mod_idgen b(mod_idgen::HASHED);
+  CATCH_REQUIRE(10000 == distinct_keys(&a, 10000));
+
+  /* seeded per generator, so two generators do not collide */
+  std::set<mod_key> keys;
+  for (int i = 0; i < 1000; ++i) {
+    keys.insert(mod_idgen::key(a()));
+    keys.insert(mod_idgen::key(b()));
+  } /* for(i..) */
+  CATCH_REQUIRE(2000 == keys.size());
+}
+
+CATCH_TEST_CASE("Random IDs", "[mod_idgen]") {
+  mod_idgen gen(mod_idgen::RANDOM);
+  auto id = gen();
+  CATCH_REQUIRE(boost::uuids::uuid::version_random_number_based ==
+                id.version());
+  CATCH_REQUIRE(1000 == distinct_keys(&gen, 1000));
+}
+
+CATCH_TEST_CASE("Changing modes", "[mod_idgen]") {
+  mod_idgen gen;
+  std::set<mod_key> keys;
+  keys.insert(mod_idgen::key(gen()));
+  gen.set_mode(mod_idgen::RANDOM);
+  CATCH_REQUIRE(mod_idgen::RANDOM == gen.get_mode());
+  keys.insert(mod_idgen::key(gen()));
+  gen.set_mode(mod_idgen::HASHED);
+  keys.insert(mod_idgen::key(gen()));
+
+  /* the counter is not reset, so sequential IDs are not handed out twice */
+  gen.set_mode(mod_idgen::SEQUENTIAL);
+  auto id = gen();
+  CATCH_REQUIRE(3 == mod_idgen::key(id));
+  keys.insert(mod_idgen::key(id));
+  CATCH_REQUIRE(4 == keys.size());
+}
+
+CATCH_TEST_CASE("IDs from several threads", "[mod_idgen]") {
+  constexpr std::size_t kTHREADS = 4;
+  constexpr std::size_t kIDS = 5000;
+  mod_idgen gen;
+  std::mutex mtx;
+  std::set<mod_key> keys;
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < kTHREADS; ++t) {
+    threads.emplace_back([&]() {
+      std::vector<mod_key> mine;
+      for (std::size_t i = 0; i < kIDS; ++i) {
+        mine.push_back(mod_idgen::key(gen()));
+      } /* for(i..) */
+      std::lock_guard<std::mutex> lock(mtx);
+      keys.insert(mine.begin(), mine.end());
+    });
+  } /* for(t..) */
+  for (auto& t : threads) {
+    t.join();
+  } /* for(&t..) */
+
+  /* every counter value handed out exactly once */
+  CATCH_REQUIRE(kTHREADS * kIDS == keys.size());
+  CATCH_REQUIRE(1 == *keys.begin());
+  CATCH_REQUIRE(kTHREADS * kIDS == *keys.rbegin());
+}
+
+CATCH_TEST_CASE("Server modules by generated ID", "[mod_idgen]") {
+  server s;
+  CATCH_REQUIRE(mod_idgen::SEQUENTIAL == s.idgen_mode());
+  auto a = s.idgen();
+  s.idgen_mode(mod_idgen::HASHED);
+  auto b = s.idgen();
+  s.idgen_mode(mod_idgen::RANDOM);
+  auto c = s.idgen();
+
+  CATCH_REQUIRE(OK == s.insmod(a, er_lvl::NOM, er_lvl::NOM, "a"));
+  CATCH_REQUIRE(OK == s.insmod(b, er_lvl::NOM, er_lvl::NOM, "b"));
+  CATCH_REQUIRE(OK == s.insmod(c, er_lvl::NOM, er_lvl::NOM, "c"));
+  CATCH_REQUIRE(0 == s.mod_lookup(a));
+  CATCH_REQUIRE(1 == s.mod_lookup(b));
+  CATCH_REQUIRE(2 == s.mod_lookup(c));
+}
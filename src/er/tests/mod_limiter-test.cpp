@@ -0,0 +1,202 @@
+/**
+ * @file mod_limiter-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/er/client.hpp"
+#include "rcppsw/er/mod_limiter.hpp"
+#include "rcppsw/er/server.hpp"
+#include "rcppsw/er/timestamp.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::client;
+using rcppsw::er::er_lvl;
+using rcppsw::er::mod_limiter;
+using rcppsw::er::server;
+using rcppsw::er::sink;
+using rcppsw::er::timestamp;
+
+/*******************************************************************************
+ * Test Classes
+ ******************************************************************************/
+class capture_sink : public sink {
+ public:
+  explicit capture_sink(std::vector<std::string>* out) : m_out(out) {}
+  void write(const char* data, std::size_t len, er_lvl::value) override {
+    m_out->emplace_back(data, len);
+  }
+  void flush(void) override {}
+
+ private:
+  std::vector<std::string>* m_out;
+};
+
+class test_client : public client {
+ public:
+  explicit test_client(std::shared_ptr<server> handle) : client(handle) {}
+  using client::er_id;
+};
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static int admit_n(mod_limiter* limiter, er_lvl::value lvl, int n) {
+  int admitted = 0;
+  for (int i = 0; i < n; ++i) {
+    admitted += limiter->admit(lvl) ? 1 : 0;
+  } /* for(i..) */
+  return admitted;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Sampling", "[mod_limiter]") {
+  mod_limiter::config cfg;
+  cfg.sample = 4;
+  CATCH_REQUIRE(cfg.active());
+  mod_limiter limiter(cfg);
+
+  CATCH_REQUIRE(25 == admit_n(&limiter, er_lvl::NOM, 100));
+  CATCH_REQUIRE(75 == limiter.suppressed_take());
+  CATCH_REQUIRE(0 == limiter.suppressed_take());
+
+  /* more severe than the configured level: never limited */
+  CATCH_REQUIRE(10 == admit_n(&limiter, er_lvl::WARN, 10));
+  CATCH_REQUIRE(0 == limiter.suppressed_take());
+}
+
+CATCH_TEST_CASE("Rate limiting", "[mod_limiter]") {
+  mod_limiter::config cfg;
+  CATCH_REQUIRE(!cfg.active());
+  cfg.rate = 100.0; /* 1 message every 10ms */
+  cfg.burst = 5;
+  mod_limiter limiter(cfg);
+
+  /* the whole burst is let through at once, then nothing */
+  CATCH_REQUIRE(5 == admit_n(&limiter, er_lvl::NOM, 100));
+  CATCH_REQUIRE(95 == limiter.suppressed_take());
+
+  /* and it refills at the configured rate */
+  std::this_thread::sleep_for(std::chrono::milliseconds(25));
+  int n = admit_n(&limiter, er_lvl::NOM, 100);
+  CATCH_REQUIRE(n >= 2);
+  CATCH_REQUIRE(n < 5);
+}
+
+CATCH_TEST_CASE("Rate limiting from several threads", "[mod_limiter]") {
+  mod_limiter::config cfg;
+  cfg.rate = 1.0;
+  cfg.burst = 10;
+  mod_limiter limiter(cfg);
+
+  std::atomic<int> admitted{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&]() {
+      admitted += admit_n(&limiter, er_lvl::DIAG, 1000);
+    });
+  } /* for(t..) */
+  for (auto& t : threads) {
+    t.join();
+  } /* for(&t..) */
+  CATCH_REQUIRE(10 == admitted.load());
+  CATCH_REQUIRE(3990 == limiter.suppressed_take());
+}
+
+CATCH_TEST_CASE("Summary timing", "[mod_limiter]") {
+  mod_limiter::config cfg;
+  cfg.sample = 2;
+  cfg.summary_ms = 1000;
+  mod_limiter limiter(cfg);
+  uint64_t now = timestamp::now();
+  uint64_t sec = timestamp::kNS_PER_SEC;
+
+  /* nothing suppressed, nothing to summarize */
+  CATCH_REQUIRE(!limiter.summary_due(now + 2 * sec));
+
+  admit_n(&limiter, er_lvl::NOM, 10);
+  CATCH_REQUIRE(!limiter.summary_due(now));
+  CATCH_REQUIRE(limiter.summary_due(now + 2 * sec));
+  /* only one caller gets to report it */
+  CATCH_REQUIRE(!limiter.summary_due(now + 2 * sec));
+  CATCH_REQUIRE(limiter.summary_due(now + 3 * sec));
+
+  CATCH_REQUIRE("5 messages suppressed (rate limit/sampling)\n" ==
+                mod_limiter::summary(limiter.suppressed_take()));
+}
+
+CATCH_TEST_CASE("Suppressed summary through a client", "[mod_limiter]") {
+  std::vector<std::string> out;
+  auto s = std::make_shared<server>("__no_file__", er_lvl::OFF, er_lvl::NOM);
+  s->log_sink(std::unique_ptr<sink>(new capture_sink(&out)));
+  test_client c(s);
+  CATCH_REQUIRE(OK == c.insmod("mod", er_lvl::NOM, er_lvl::OFF));
+
+  mod_limiter::config cfg;
+  cfg.sample = 10;
+  cfg.summary_ms = 0;
+  CATCH_REQUIRE(OK == s->mod_limits(c.er_id(), cfg));
+
+  /* the 1st and 11th messages pass; the 11th reports the 9 before it */
+  int n = 0;
+  for (int i = 0; i < 11; ++i) {
+    n += c.er_enabled(er_lvl::NOM) ? 1 : 0;
+  } /* for(i..) */
+  CATCH_REQUIRE(2 == n);
+  CATCH_REQUIRE(1 == out.size());
+  CATCH_REQUIRE(std::string::npos !=
+                out[0].find("mod: 9 messages suppressed"));
+  CATCH_REQUIRE(9 == s->metrics().mod_counts(s->mod_lookup(c.er_id()))
+                         .filtered[er_lvl::NOM]);
+
+  /* anything suppressed since is summarized on flush */
+  for (int i = 0; i < 5; ++i) {
+    c.er_enabled(er_lvl::NOM);
+  } /* for(i..) */
+  s->flush();
+  CATCH_REQUIRE(2 == out.size());
+  CATCH_REQUIRE(std::string::npos !=
+                out[1].find("mod: 5 messages suppressed"));
+
+  /* new limits keep the count of messages the old ones suppressed */
+  for (int i = 0; i < 4; ++i) {
+    c.er_enabled(er_lvl::NOM);
+  } /* for(i..) */
+  CATCH_REQUIRE(2 == out.size());
+  cfg.sample = 2;
+  CATCH_REQUIRE(OK == s->mod_limits(c.er_id(), cfg));
+  s->flush();
+  CATCH_REQUIRE(3 == out.size());
+  CATCH_REQUIRE(std::string::npos !=
+                out[2].find("mod: 4 messages suppressed"));
+}
@@ -0,0 +1,88 @@
+/**
+ * @file mt_server-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/er/mt_server.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::er_lvl;
+using rcppsw::er::mt_server;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Flush from other threads keeps queue order", "[mt_server]") {
+  constexpr int kTHREADS = 4;
+  constexpr int kMSGS = 2000;
+  const std::string kFNAME = "mt_server-test.log";
+  {
+    mt_server server(kFNAME, er_lvl::OFF, er_lvl::NOM, 64);
+    auto id = server.idgen();
+    CATCH_REQUIRE(OK == server.insmod(id, er_lvl::NOM, er_lvl::OFF, "mod"));
+    CATCH_REQUIRE(OK == server.start(nullptr));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kTHREADS; ++t) {
+      threads.emplace_back([&, t]() {
+        for (int i = 0; i < kMSGS; ++i) {
+          server.report(id, er_lvl::NOM,
+                        "t" + std::to_string(t) + " " + std::to_string(i) +
+                            "\n");
+          if (0 == i % 100) {
+            server.flush();
+          }
+        } /* for(i..) */
+      });
+    } /* for(t..) */
+    for (auto& t : threads) {
+      t.join();
+    } /* for(&t..) */
+    server.term();
+  }
+
+  /* each thread's messages come out in the order it reported them */
+  std::vector<int> next(kTHREADS, 0);
+  std::ifstream in(kFNAME);
+  std::string rec;
+  while (std::getline(in, rec)) {
+    int t = -1;
+    int i = -1;
+    const char* p = std::strstr(rec.c_str(), ": t");
+    CATCH_REQUIRE(nullptr != p);
+    CATCH_REQUIRE(2 == std::sscanf(p, ": t%d %d", &t, &i));
+    CATCH_REQUIRE(next[t] == i);
+    ++next[t];
+  } /* while() */
+  CATCH_REQUIRE(std::vector<int>(kTHREADS, kMSGS) == next);
+  std::remove(kFNAME.c_str());
+}
@@ -0,0 +1,187 @@
+/**
+ * @file sharded_server-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/er/binlog_reader.hpp"
+#include "rcppsw/er/binlog_writer.hpp"
+#include "rcppsw/er/file_sink.hpp"
+#include "rcppsw/er/sharded_server.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::binlog_reader;
+using rcppsw::er::binlog_writer;
+using rcppsw::er::er_lvl;
+using rcppsw::er::file_sink;
+using rcppsw::er::sharded_server;
+using rcppsw::er::sink;
+
+/*******************************************************************************
+ * Test Classes
+ ******************************************************************************/
+class count_sink : public sink {
+ public:
+  explicit count_sink(std::atomic<int>* n) : m_n(n) {}
+  void write(const char*, std::size_t, er_lvl::value) override { ++*m_n; }
+  void flush(void) override {}
+
+ private:
+  std::atomic<int>* m_n;
+};
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static const char* kFNAME = "sharded_server-test.bin";
+
+/*
+ * Have \a n_threads threads each report \a n_msgs messages through a sharded
+ * server, logging to a binary log (which keeps the nanosecond timestamps the
+ * merger ordered by). Every \a flush_every messages a thread also calls
+ * flush(), which merges from the reporting thread. The server is terminated as
+ * soon as the threads are done, so whatever is still in the shards has to be
+ * drained on the way out.
+ */
+static void sharded_report(int n_threads, int n_msgs, int flush_every) {
+  sharded_server server("__no_file__", er_lvl::OFF, er_lvl::NOM, 64);
+  server.binlog(std::unique_ptr<binlog_writer>(new binlog_writer(
+      std::unique_ptr<sink>(new file_sink(kFNAME)))));
+  auto id = server.idgen();
+  CATCH_REQUIRE(OK == server.insmod(id, er_lvl::NOM, er_lvl::OFF, "mod"));
+  CATCH_REQUIRE(OK == server.start(nullptr));
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < n_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < n_msgs; ++i) {
+        server.report(id, er_lvl::NOM,
+                      "t" + std::to_string(t) + " " + std::to_string(i) +
+                          "\n");
+        if (0 != flush_every && 0 == i % flush_every) {
+          server.flush();
+        }
+      } /* for(i..) */
+    });
+  } /* for(t..) */
+  for (auto& t : threads) {
+    t.join();
+  } /* for(&t..) */
+  server.term();
+}
+
+/*
+ * Check that the binary log is in timestamp order and has every message from
+ * every thread, in the order each thread reported them.
+ */
+static void sharded_check(int n_threads, int n_msgs) {
+  binlog_reader r(kFNAME);
+  binlog_reader::record rec;
+  CATCH_REQUIRE(r.is_valid());
+
+  uint64_t last_ts = 0;
+  std::vector<int> next(n_threads, 0);
+  while (r.next(&rec)) {
+    CATCH_REQUIRE(rec.ts >= last_ts);
+    last_ts = rec.ts;
+
+    int t = -1;
+    int i = -1;
+    CATCH_REQUIRE(2 == std::sscanf(rec.text.c_str(), "t%d %d", &t, &i));
+    CATCH_REQUIRE(next[t] == i);
+    ++next[t];
+  } /* while() */
+  CATCH_REQUIRE(std::vector<int>(n_threads, n_msgs) == next);
+  std::remove(kFNAME);
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Output is in timestamp order", "[sharded_server]") {
+  sharded_report(4, 2000, 0);
+  sharded_check(4, 2000);
+}
+
+CATCH_TEST_CASE("Flush from reporting threads", "[sharded_server]") {
+  sharded_report(4, 2000, 100);
+  sharded_check(4, 2000);
+}
+
+CATCH_TEST_CASE("Shards are drained on shutdown", "[sharded_server]") {
+  /* more than fits in a shard, so some threads block until the merger runs */
+  sharded_report(8, 200, 0);
+  sharded_check(8, 200);
+}
+
+CATCH_TEST_CASE("Merger wakes up for messages after idling",
+                "[sharded_server]") {
+  std::atomic<int> n{0};
+  sharded_server server("__no_file__", er_lvl::OFF, er_lvl::NOM);
+  server.log_sink(std::unique_ptr<sink>(new count_sink(&n)));
+  auto id = server.idgen();
+  CATCH_REQUIRE(OK == server.insmod(id, er_lvl::NOM, er_lvl::OFF, "mod"));
+  CATCH_REQUIRE(OK == server.start(nullptr));
+
+  /*
+   * Each message is given time for the merger to go to sleep first, and has
+   * to be written well before the merger would wake up on its own.
+   */
+  for (int i = 0; i < 3; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    server.report(id, er_lvl::NOM, "msg\n");
+    auto start = std::chrono::steady_clock::now();
+    while (n.load() <= i &&
+           std::chrono::steady_clock::now() - start <
+               std::chrono::milliseconds(50)) {
+      std::this_thread::yield();
+    } /* while() */
+    CATCH_REQUIRE(i + 1 == n.load());
+  } /* for(i..) */
+  server.term();
+}
+
+CATCH_TEST_CASE("Short-lived servers on one thread", "[sharded_server]") {
+  /* shards of destroyed servers are dropped from the thread's cache */
+  for (int i = 0; i < 50; ++i) {
+    std::atomic<int> n{0};
+    {
+      sharded_server server("__no_file__", er_lvl::OFF, er_lvl::NOM, 16);
+      server.log_sink(std::unique_ptr<sink>(new count_sink(&n)));
+      auto id = server.idgen();
+      CATCH_REQUIRE(OK == server.insmod(id, er_lvl::NOM, er_lvl::OFF, "mod"));
+      CATCH_REQUIRE(OK == server.start(nullptr));
+      server.report(id, er_lvl::NOM, "msg\n");
+      server.term();
+    }
+    CATCH_REQUIRE(1 == n.load());
+  } /* for(i..) */
+}
@@ -0,0 +1,196 @@
+/**
+ * @file shm_server-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/er/shm_server.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::er_lvl;
+using rcppsw::er::shm_server;
+using rcppsw::er::sink;
+
+/*******************************************************************************
+ * Test Classes
+ ******************************************************************************/
+/* Only the collector thread writes it */
+class capture_sink : public sink {
+ public:
+  explicit capture_sink(std::vector<std::string>* out) : m_out(out) {}
+  void write(const char* data, std::size_t len, er_lvl::value) override {
+    m_out->emplace_back(data, len);
+  }
+  void flush(void) override {}
+
+ private:
+  std::vector<std::string>* m_out;
+};
+
+class count_sink : public sink {
+ public:
+  explicit count_sink(std::atomic<int>* n) : m_n(n) {}
+  void write(const char*, std::size_t, er_lvl::value) override { ++*m_n; }
+  void flush(void) override {}
+
+ private:
+  std::atomic<int>* m_n;
+};
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+/*
+ * Fork a child that reports \a n_msgs messages tagged with \a tag through the
+ * server's ring, and wait for it to exit.
+ */
+static void child_report(shm_server* server,
+                         const boost::uuids::uuid& id,
+                         const std::string& tag,
+                         int n_msgs) {
+  pid_t pid = fork();
+  CATCH_REQUIRE(pid >= 0);
+  if (0 == pid) {
+    for (int i = 0; i < n_msgs; ++i) {
+      server->report(id, er_lvl::NOM, tag + " " + std::to_string(i) + "\n");
+    } /* for(i..) */
+    _exit(0);
+  }
+  int status = 0;
+  CATCH_REQUIRE(pid == waitpid(pid, &status, 0));
+  CATCH_REQUIRE(WIFEXITED(status));
+  CATCH_REQUIRE(0 == WEXITSTATUS(status));
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Messages from forked children are collected", "[shm_server]") {
+  constexpr int kCHILDREN = 3;
+  constexpr int kMSGS = 500;
+  std::vector<std::string> out;
+  {
+    shm_server server("__no_file__", er_lvl::OFF, er_lvl::NOM,
+                      "rcppsw-er-test-" + std::to_string(getpid()));
+    server.log_sink(std::unique_ptr<sink>(new capture_sink(&out)));
+    auto id = server.idgen();
+    CATCH_REQUIRE(OK == server.insmod(id, er_lvl::NOM, er_lvl::OFF, "mod"));
+    CATCH_REQUIRE(OK == server.start(nullptr));
+
+    server.report(id, er_lvl::NOM, "parent 0\n");
+    for (int c = 0; c < kCHILDREN; ++c) {
+      child_report(&server, id, "c" + std::to_string(c), kMSGS);
+    } /* for(c..) */
+    server.term();
+    server.join();
+    CATCH_REQUIRE(0 == server.n_dropped());
+  }
+
+  /* each child's messages arrive complete and in the order it sent them */
+  std::vector<int> next(kCHILDREN, 0);
+  int n_parent = 0;
+  for (auto& rec : out) {
+    int c = -1;
+    int i = -1;
+    const char* p = std::strstr(rec.c_str(), "mod: ");
+    CATCH_REQUIRE(nullptr != p);
+    if (0 == std::strcmp(p, "mod: parent 0\n")) {
+      ++n_parent;
+      continue;
+    }
+    CATCH_REQUIRE(2 == std::sscanf(p, "mod: c%d %d", &c, &i));
+    CATCH_REQUIRE(next[c] == i);
+    ++next[c];
+  } /* for(&rec..) */
+  CATCH_REQUIRE(1 == n_parent);
+  CATCH_REQUIRE(std::vector<int>(kCHILDREN, kMSGS) == next);
+}
+
+CATCH_TEST_CASE("Collector wakes up for messages after idling",
+                "[shm_server]") {
+  std::atomic<int> n{0};
+  shm_server server("__no_file__", er_lvl::OFF, er_lvl::NOM,
+                    "rcppsw-er-test-" + std::to_string(getpid()));
+  server.log_sink(std::unique_ptr<sink>(new count_sink(&n)));
+  auto id = server.idgen();
+  CATCH_REQUIRE(OK == server.insmod(id, er_lvl::NOM, er_lvl::OFF, "mod"));
+  CATCH_REQUIRE(OK == server.start(nullptr));
+
+  /*
+   * Give the collector time to go to sleep, and the message has to be written
+   * well before it would wake up on its own.
+   */
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  child_report(&server, id, "c0", 1);
+  auto start = std::chrono::steady_clock::now();
+  while (0 == n.load() && std::chrono::steady_clock::now() - start <
+                              std::chrono::milliseconds(50)) {
+    std::this_thread::yield();
+  } /* while() */
+  CATCH_REQUIRE(1 == n.load());
+  server.term();
+}
+
+CATCH_TEST_CASE("Modules installed in children are counted by name",
+                "[shm_server]") {
+  std::atomic<int> n{0};
+  shm_server server("__no_file__", er_lvl::OFF, er_lvl::NOM,
+                    "rcppsw-er-test-" + std::to_string(getpid()));
+  server.log_sink(std::unique_ptr<sink>(new count_sink(&n)));
+  CATCH_REQUIRE(OK == server.start(nullptr));
+
+  pid_t pid = fork();
+  CATCH_REQUIRE(pid >= 0);
+  if (0 == pid) {
+    auto id = server.idgen();
+    server.insmod(id, er_lvl::NOM, er_lvl::OFF, "child_mod");
+    for (int i = 0; i < 3; ++i) {
+      server.report(id, er_lvl::NOM, "msg\n");
+    } /* for(i..) */
+    _exit(0);
+  }
+  int status = 0;
+  CATCH_REQUIRE(pid == waitpid(pid, &status, 0));
+  server.term();
+  server.join();
+  CATCH_REQUIRE(3 == n.load());
+
+  std::ostringstream os;
+  server.metrics_dump(os);
+  CATCH_REQUIRE(std::string::npos !=
+                os.str().find("child_mod: emitted=3 filtered=0 dropped=0"));
+  CATCH_REQUIRE(std::string::npos !=
+                os.str().find("<unattributed>: emitted=0 filtered=0"));
+}
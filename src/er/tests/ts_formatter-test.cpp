@@ -0,0 +1,97 @@
+/**
+ * @file ts_formatter-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <time.h>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include "rcppsw/er/timestamp.hpp"
+#include "rcppsw/er/ts_formatter.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::timestamp;
+using rcppsw::er::ts_formatter;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static uint64_t wall(uint64_t sec, uint64_t ns) {
+  return sec * timestamp::kNS_PER_SEC + ns;
+}
+
+static void utc(void) {
+  setenv("TZ", "UTC", 1);
+  tzset();
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Wall clock formatting", "[ts_formatter]") {
+  utc();
+  ts_formatter fmt;
+  CATCH_REQUIRE("[2017-07-14 02:40:00.123]" ==
+                fmt.format_wall(wall(1500000000, 123456789)));
+
+  /* same second: only the milliseconds change (truncated, not rounded) */
+  CATCH_REQUIRE("[2017-07-14 02:40:00.999]" ==
+                fmt.format_wall(wall(1500000000, 999999999)));
+  CATCH_REQUIRE("[2017-07-14 02:40:00.000]" ==
+                fmt.format_wall(wall(1500000000, 0)));
+
+  /* the cached prefix is replaced when the second changes, either way */
+  CATCH_REQUIRE("[2017-07-14 02:40:01.007]" ==
+                fmt.format_wall(wall(1500000001, 7000000)));
+  CATCH_REQUIRE("[2017-07-14 02:39:59.500]" ==
+                fmt.format_wall(wall(1499999999, 500000000)));
+  CATCH_REQUIRE("[2018-01-01 00:00:00.000]" ==
+                fmt.format_wall(wall(1514764800, 0)));
+}
+
+CATCH_TEST_CASE("Raw timestamps map to the wall clock", "[ts_formatter]") {
+  utc();
+  ts_formatter fmt;
+  struct timespec real;
+  clock_gettime(CLOCK_REALTIME, &real);
+  uint64_t expected = wall(static_cast<uint64_t>(real.tv_sec),
+                           static_cast<uint64_t>(real.tv_nsec));
+  uint64_t got = fmt.wall_ns(timestamp::now());
+
+  /* both sides are coarse clocks: allow a few kernel ticks */
+  uint64_t diff = (got > expected) ? got - expected : expected - got;
+  CATCH_REQUIRE(diff < 50 * 1000000UL);
+  CATCH_REQUIRE(fmt.format(timestamp::now()).size() ==
+                std::string("[YYYY-MM-DD HH:MM:SS.mmm]").size());
+}
+
+CATCH_TEST_CASE("Coarse and precise clocks agree", "[timestamp]") {
+  uint64_t coarse = timestamp::now();
+  uint64_t precise = timestamp::precise();
+  uint64_t diff = (precise > coarse) ? precise - coarse : coarse - precise;
+  CATCH_REQUIRE(diff < 50 * 1000000UL);
+}
@@ -0,0 +1,110 @@
+/**
+ * @file er_decode.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <boost/program_options.hpp>
+#include <cinttypes>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include "rcppsw/er/binlog_reader.hpp"
+#include "rcppsw/er/ts_formatter.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace bpo = boost::program_options;
+using rcppsw::er::binlog_reader;
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/*
+ * Decode a binary ER log written by rcppsw::er::binlog_writer back into the
+ * text that would have been logged, optionally filtering by module, level and
+ * time range. Blocks that cannot contain matching records are not read.
+ */
+int main(int argc, char** argv) {
+  bpo::options_description desc("Options");
+  binlog_reader::filter filter;
+  int lvl = rcppsw::er::er_lvl::VER;
+  std::string fname;
+
+  desc.add_options()("help", "Produce this message")(
+      "file", bpo::value<std::string>(&fname)->required(), "The log to decode")(
+      "module", bpo::value<std::string>(&filter.module), "Only this module")(
+      "level",
+      bpo::value<int>(&lvl),
+      "Least severe level to output [1=ERR,...,5=VER]. Default=5.")(
+      "from", bpo::value<uint64_t>(&filter.ts_min), "Start time (ns)")(
+      "to", bpo::value<uint64_t>(&filter.ts_max), "End time (ns)")(
+      "timestamps",
+      "Prefix each message with the time it was reported, as "
+      "server::log_ts_builtin() does")(
+      "stats", "Report # of blocks read/skipped to stderr");
+
+  bpo::positional_options_description pos;
+  pos.add("file", 1);
+  bpo::variables_map vm;
+  try {
+    bpo::store(bpo::command_line_parser(argc, argv)
+                   .options(desc)
+                   .positional(pos)
+                   .run(),
+               vm);
+    if (vm.count("help") > 0) {
+      std::cout << "Usage: " << argv[0] << " [options] file\n\n" << desc;
+      return 0;
+    }
+    bpo::notify(vm);
+  } catch (bpo::error& e) {
+    std::cerr << "ERROR: " << e.what() << "\n\n" << desc;
+    return 1;
+  }
+  filter.lvl = static_cast<rcppsw::er::er_lvl::value>(lvl);
+
+  binlog_reader reader(fname, filter);
+  if (!reader.is_valid()) {
+    std::cerr << "ERROR: " << fname << " is not an ER binary log\n";
+    return 1;
+  }
+
+  binlog_reader::record rec;
+  rcppsw::er::ts_formatter ts_fmt;
+  bool timestamps = vm.count("timestamps") > 0;
+  while (reader.next(&rec)) {
+    /* same layout as server::msg_write() */
+    std::string header = timestamps ? ts_fmt.format_wall(rec.ts) : "";
+    std::printf("%s %s: %s",
+                header.c_str(),
+                rec.module.c_str(),
+                rec.text.c_str());
+  } /* while() */
+
+  if (vm.count("stats") > 0) {
+    std::fprintf(stderr,
+                 "%" PRIu64 " blocks read, %" PRIu64 " skipped\n",
+                 reader.n_blocks_read(),
+                 reader.n_blocks_skipped());
+  }
+  return 0;
+} /* main() */
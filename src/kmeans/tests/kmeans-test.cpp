@@ -0,0 +1,129 @@
+/**
+ * @file kmeans-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "rcppsw/er/server.hpp"
+#include "rcppsw/kmeans/cluster_pthread.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+using rcppsw::er::er_lvl;
+using rcppsw::er::server;
+using rcppsw::kmeans::cluster_pthread;
+using rcppsw::kmeans::multidim_point;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+/*
+ * Two well separated blobs, around (0, 0) and (100, 100). Points alternate
+ * between them, so the initial centers (the first two points) land one in
+ * each blob.
+ */
+static std::vector<multidim_point<double>> blobs_make(std::size_t n_points) {
+  std::vector<multidim_point<double>> points;
+  for (std::size_t i = 0; i < n_points; ++i) {
+    double base = (i % 2) ? 100.0 : 0.0;
+    double off = static_cast<double>(i % 5);
+    points.push_back({base + off, base - off});
+  } /* for(i..) */
+  return points;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Pthread Clustering", "[kmeans]") {
+  auto s = std::make_shared<server>("__no_file__", er_lvl::OFF, er_lvl::OFF);
+  for (std::size_t n_threads : {1, 2, 3, 4}) {
+    std::vector<multidim_point<double>> points = blobs_make(64);
+    cluster_pthread<double> alg(
+        10, 2, n_threads, 2, points.size(), "clusters.txt", "centroids.txt", s);
+    alg.initialize(&points);
+    alg.cluster();
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      CATCH_REQUIRE(alg.membership()[i] == i % 2);
+    } /* for(i..) */
+    for (auto* c : *alg.clusters()) {
+      CATCH_REQUIRE(c->convergence());
+    } /* for(c..) */
+  } /* for(n_threads..) */
+}
+
+CATCH_TEST_CASE("Pthread Report", "[kmeans]") {
+  auto s = std::make_shared<server>("__no_file__", er_lvl::OFF, er_lvl::OFF);
+  std::vector<multidim_point<double>> points = blobs_make(16);
+  {
+    /*
+     * Temporaries for the file names: the algorithm must not hold on to
+     * references to them.
+     */
+    cluster_pthread<double> alg(10,
+                                2,
+                                2,
+                                2,
+                                points.size(),
+                                std::string("kmeans-clusters.txt"),
+                                std::string("kmeans-centroids.txt"),
+                                s);
+    alg.initialize(&points);
+    alg.cluster();
+    alg.report();
+  }
+
+  std::ifstream clusters("kmeans-clusters.txt");
+  std::size_t membership;
+  std::size_t n_lines = 0;
+  while (clusters >> membership) {
+    CATCH_REQUIRE(membership == n_lines % 2);
+    ++n_lines;
+  } /* while() */
+  CATCH_REQUIRE(n_lines == points.size());
+
+  std::ifstream centroids("kmeans-centroids.txt");
+  std::size_t n_clusters = 0;
+  std::size_t dimension = 0;
+  centroids >> n_clusters >> dimension;
+  CATCH_REQUIRE(n_clusters == 2);
+  CATCH_REQUIRE(dimension == 2);
+  double x = 0.0;
+  double y = 0.0;
+  centroids >> x >> y;
+  CATCH_REQUIRE(x < 5.0);
+  CATCH_REQUIRE(y > -5.0);
+  centroids >> x >> y;
+  CATCH_REQUIRE(x > 95.0);
+  CATCH_REQUIRE(y < 105.0);
+
+  std::remove("kmeans-clusters.txt");
+  std::remove("kmeans-centroids.txt");
+}
@@ -0,0 +1,158 @@
+/**
+ * @file queue-bench.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/multithread/mpmc_ring.hpp"
+#include "rcppsw/multithread/mt_queue.hpp"
+#include "rcppsw/multithread/spsc_ring.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace bpo = boost::program_options;
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+/*
+ * Push n_items through the queue from n_producers threads to n_consumers
+ * threads, using only the non-blocking interface that all the queues share,
+ * and report the throughput.
+ */
+template <typename Q>
+static void run(const std::string& name,
+                Q* const queue,
+                std::size_t n_items,
+                std::size_t n_producers,
+                std::size_t n_consumers) {
+  std::atomic<std::size_t> n_consumed{0};
+  std::atomic<uint64_t> checksum{0};
+  std::vector<std::thread> threads;
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t p = 0; p < n_producers; ++p) {
+    threads.emplace_back([=]() {
+      for (std::size_t i = p; i < n_items; i += n_producers) {
+        while (!queue->try_enqueue(static_cast<uint64_t>(i))) {
+          std::this_thread::yield();
+        } /* while() */
+      } /* for(i..) */
+    });
+  } /* for(p..) */
+  for (std::size_t c = 0; c < n_consumers; ++c) {
+    threads.emplace_back([&]() {
+      uint64_t sum = 0;
+      uint64_t val = 0;
+      while (n_consumed.load(std::memory_order_relaxed) < n_items) {
+        if (queue->try_dequeue(&val)) {
+          sum += val;
+          n_consumed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      } /* while() */
+      checksum.fetch_add(sum);
+    });
+  } /* for(c..) */
+  for (auto& t : threads) {
+    t.join();
+  } /* for(t..) */
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  bool ok = checksum.load() ==
+            static_cast<uint64_t>(n_items) * (n_items - 1) / 2;
+  std::printf("%-10s %2zuP/%2zuC: %8.2f Mops/s%s\n",
+              name.c_str(),
+              n_producers,
+              n_consumers,
+              static_cast<double>(n_items) / elapsed.count() / 1e6,
+              ok ? "" : " (CHECKSUM MISMATCH)");
+} /* run() */
+
+/*
+ * Compare the lock-free queues against the mutex-based mt_queue, for the
+ * 1-to-1 case all of them support and the many-to-many case only mt_queue and
+ * mpmc_ring support.
+ */
+int main(int argc, char** argv) {
+  bpo::options_description desc("Options");
+  std::size_t n_items = 0;
+  std::size_t capacity = 0;
+  std::size_t n_threads = 0;
+
+  desc.add_options()("help", "Produce this message")(
+      "items",
+      bpo::value<std::size_t>(&n_items)->default_value(2000000),
+      "# of items to push through each queue")(
+      "capacity",
+      bpo::value<std::size_t>(&capacity)->default_value(1024),
+      "Capacity of each queue")(
+      "threads",
+      bpo::value<std::size_t>(&n_threads)->default_value(4),
+      "# of producers (and consumers) for the many-to-many runs");
+
+  bpo::variables_map vm;
+  try {
+    bpo::store(bpo::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help") > 0) {
+      std::cout << "Usage: " << argv[0] << " [options]\n\n" << desc;
+      return 0;
+    }
+    bpo::notify(vm);
+  } catch (bpo::error& e) {
+    std::cerr << "ERROR: " << e.what() << "\n\n" << desc;
+    return 1;
+  }
+
+  {
+    mt::mt_queue<uint64_t> queue(capacity);
+    run("mt_queue", &queue, n_items, 1, 1);
+  }
+  {
+    mt::spsc_ring<uint64_t> queue(capacity);
+    run("spsc_ring", &queue, n_items, 1, 1);
+  }
+  {
+    mt::mpmc_ring<uint64_t> queue(capacity);
+    run("mpmc_ring", &queue, n_items, 1, 1);
+  }
+  {
+    mt::mt_queue<uint64_t> queue(capacity);
+    run("mt_queue", &queue, n_items, n_threads, n_threads);
+  }
+  {
+    mt::mpmc_ring<uint64_t> queue(capacity);
+    run("mpmc_ring", &queue, n_items, n_threads, n_threads);
+  }
+  return 0;
+} /* main() */
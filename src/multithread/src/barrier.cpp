@@ -0,0 +1,65 @@
+/**
+ * @file barrier.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/multithread/barrier.hpp"
+#include "rcppsw/multithread/futex.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+barrier::barrier(std::size_t n_threads)
+    : mc_n_threads(static_cast<uint32_t>(n_threads)),
+      m_remaining(static_cast<uint32_t>(n_threads)) {}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+bool barrier::wait(void) {
+  uint32_t gen = m_generation.load(std::memory_order_acquire);
+  if (1 == m_remaining.fetch_sub(1, std::memory_order_acq_rel)) {
+    /* last one in: reset for the next phase, then release everyone */
+    m_remaining.store(mc_n_threads, std::memory_order_relaxed);
+    m_generation.fetch_add(1, std::memory_order_seq_cst);
+    if (m_n_sleeping.load(std::memory_order_seq_cst) > 0) {
+      futex::wake_all(&m_generation);
+    }
+    return true;
+  }
+
+  if (futex::spin_wait(&m_generation, gen)) {
+    return false;
+  }
+  m_n_sleeping.fetch_add(1, std::memory_order_seq_cst);
+  while (m_generation.load(std::memory_order_seq_cst) == gen) {
+    futex::wait(&m_generation, gen);
+  } /* while() */
+  m_n_sleeping.fetch_sub(1, std::memory_order_relaxed);
+  return false;
+} /* wait() */
+
+NS_END(multithread, rcppsw);
@@ -0,0 +1,183 @@
+/**
+ * @file cpu_topology.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/multithread/cpu_topology.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <thread>
+#include <utility>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+namespace {
+bool line_read(const std::string& path, std::string* const line) {
+  std::ifstream in(path);
+  return static_cast<bool>(std::getline(in, *line));
+} /* line_read() */
+
+int int_read(const std::string& path, int dflt) {
+  std::string line;
+  if (!line_read(path, &line) || line.empty()) {
+    return dflt;
+  }
+  return std::atoi(line.c_str());
+} /* int_read() */
+} // namespace
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+constexpr const char* cpu_topology::kSYSFS_ROOT;
+
+cpu_topology::cpu_topology(const std::string& sysfs_root) {
+  if (OK != discover(sysfs_root)) {
+    fallback();
+  }
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+const cpu_topology& cpu_topology::instance(void) {
+  static const cpu_topology topo;
+  return topo;
+} /* instance() */
+
+std::vector<int> cpu_topology::list_parse(const std::string& list) {
+  std::vector<int> ret;
+  std::size_t pos = 0;
+  while (pos < list.size() && '\n' != list[pos]) {
+    char* end = nullptr;
+    long first = std::strtol(list.c_str() + pos, &end, 10);
+    long last = first;
+    if (end == list.c_str() + pos) {
+      return std::vector<int>();
+    }
+    if ('-' == *end) {
+      const char* start = end + 1;
+      last = std::strtol(start, &end, 10);
+      if (end == start || last < first) {
+        return std::vector<int>();
+      }
+    }
+    for (long i = first; i <= last; ++i) {
+      ret.push_back(static_cast<int>(i));
+    } /* for(i..) */
+    pos = static_cast<std::size_t>(end - list.c_str());
+    if (',' == list[pos]) {
+      ++pos;
+    }
+  } /* while() */
+  return ret;
+} /* list_parse() */
+
+std::vector<cpu_topology::cpu> cpu_topology::node_cpus(int node) const {
+  std::vector<cpu> ret;
+  std::copy_if(m_cpus.begin(),
+               m_cpus.end(),
+               std::back_inserter(ret),
+               [&](const cpu& c) { return c.node == node; });
+  return ret;
+} /* node_cpus() */
+
+int cpu_topology::node_of(int cpu_id) const {
+  for (auto& c : m_cpus) {
+    if (c.id == cpu_id) {
+      return c.node;
+    }
+  } /* for(c..) */
+  return -1;
+} /* node_of() */
+
+status_t cpu_topology::discover(const std::string& sysfs_root) {
+  std::string line;
+  std::vector<int> ids;
+  std::set<int> packages;
+  std::set<int> nodes;
+  std::map<std::pair<int, int>, int> n_per_core;
+
+  CHECK(line_read(sysfs_root + "/cpu/online", &line));
+  ids = list_parse(line);
+  CHECK(!ids.empty());
+
+  for (int id : ids) {
+    std::string dir = sysfs_root + "/cpu/cpu" + std::to_string(id) + "/topology/";
+    cpu c{id, int_read(dir + "core_id", id),
+          int_read(dir + "physical_package_id", 0), 0, 0};
+    c.smt = n_per_core[std::make_pair(c.package, c.core)]++;
+    packages.insert(c.package);
+    m_cpus.push_back(c);
+  } /* for(id..) */
+
+  /* kernels built without NUMA support have no node directory */
+  if (line_read(sysfs_root + "/node/online", &line)) {
+    for (int node : list_parse(line)) {
+      std::string node_list;
+      if (!line_read(sysfs_root + "/node/node" + std::to_string(node) +
+                         "/cpulist",
+                     &node_list)) {
+        continue;
+      }
+      for (int id : list_parse(node_list)) {
+        for (auto& c : m_cpus) {
+          if (c.id == id) {
+            c.node = node;
+          }
+        } /* for(c..) */
+      } /* for(id..) */
+    } /* for(node..) */
+  }
+
+  for (auto& c : m_cpus) {
+    nodes.insert(c.node);
+  } /* for(c..) */
+  m_nodes.assign(nodes.begin(), nodes.end());
+  m_n_packages = packages.size();
+  m_discovered = true;
+  return OK;
+
+error:
+  m_cpus.clear();
+  return ERROR;
+} /* discover() */
+
+void cpu_topology::fallback(void) {
+  int n = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+  for (int i = 0; i < n; ++i) {
+    m_cpus.push_back(cpu{i, i, 0, 0, 0});
+  } /* for(i..) */
+  m_nodes.assign(1, 0);
+  m_n_packages = 1;
+  m_discovered = false;
+} /* fallback() */
+
+NS_END(multithread, rcppsw);
@@ -0,0 +1,81 @@
+/**
+ * @file numa_alloc.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/multithread/numa_alloc.hpp"
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <climits>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void* numa_alloc::alloc(std::size_t bytes, int node) {
+  void* ptr = mmap(nullptr,
+                   bytes,
+                   PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS,
+                   -1,
+                   0);
+  if (MAP_FAILED == ptr) {
+    return nullptr;
+  }
+  if (node >= 0 && node < static_cast<int>(sizeof(unsigned long) * CHAR_BIT)) {
+    /*
+     * Nothing has touched the pages yet, so they will all be allocated on the
+     * node when they are first touched. Failure (no NUMA support) is harmless.
+     */
+    unsigned long mask = 1UL << node;
+    syscall(SYS_mbind,
+            ptr,
+            bytes,
+            MPOL_PREFERRED,
+            &mask,
+            sizeof(mask) * CHAR_BIT,
+            0);
+  }
+  return ptr;
+} /* alloc() */
+
+void numa_alloc::free(void* ptr, std::size_t bytes) {
+  if (nullptr != ptr) {
+    munmap(ptr, bytes);
+  }
+} /* free() */
+
+int numa_alloc::current_node(void) {
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (0 != syscall(SYS_getcpu, &cpu, &node, nullptr)) {
+    return -1;
+  }
+  return static_cast<int>(node);
+} /* current_node() */
+
+NS_END(multithread, rcppsw);
@@ -0,0 +1,121 @@
+/**
+ * @file phaser.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/multithread/phaser.hpp"
+#include <cassert>
+#include "rcppsw/multithread/futex.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Non-Member Functions
+ ******************************************************************************/
+namespace {
+uint64_t state_make(uint32_t phase, uint64_t parties, uint64_t unarrived) {
+  return (static_cast<uint64_t>(phase) << 32) | (parties << 16) | unarrived;
+} /* state_make() */
+
+/*
+ * TRUE if \a completed phases being done means \a phase is over, allowing for
+ * wraparound.
+ */
+bool is_past(uint32_t completed, uint32_t phase) {
+  return static_cast<int32_t>(completed - phase) > 0;
+} /* is_past() */
+} // namespace
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+constexpr uint64_t phaser::kCOUNT_MASK;
+
+phaser::phaser(std::size_t n_parties)
+    : m_state(state_make(0, n_parties, n_parties)) {
+  assert(n_parties <= kCOUNT_MASK);
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+uint32_t phaser::register_party(void) {
+  uint64_t prev = m_state.fetch_add(state_make(0, 1, 1),
+                                    std::memory_order_acq_rel);
+  assert(((prev >> 16) & kCOUNT_MASK) < kCOUNT_MASK);
+  return static_cast<uint32_t>(prev >> 32);
+} /* register_party() */
+
+uint32_t phaser::arrive_impl(bool deregister) {
+  uint64_t state = m_state.load(std::memory_order_acquire);
+  uint64_t next = 0;
+  uint32_t phase = 0;
+  uint64_t unarrived = 0;
+  do {
+    phase = static_cast<uint32_t>(state >> 32);
+    uint64_t parties = ((state >> 16) & kCOUNT_MASK) - (deregister ? 1 : 0);
+    unarrived = state & kCOUNT_MASK;
+    assert(unarrived > 0);
+
+    /* the last party to arrive starts the next phase */
+    next = (1 == unarrived) ? state_make(phase + 1, parties, parties)
+                            : state_make(phase, parties, unarrived - 1);
+  } while (!m_state.compare_exchange_weak(state,
+                                          next,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_acquire));
+
+  if (1 == unarrived) {
+    m_completed.fetch_add(1, std::memory_order_seq_cst);
+    if (m_n_sleeping.load(std::memory_order_seq_cst) > 0) {
+      futex::wake_all(&m_completed);
+    }
+  }
+  return phase;
+} /* arrive_impl() */
+
+void phaser::await_advance(uint32_t phase) {
+  /*
+   * m_completed is one past the last completed phase, so phase p is over once
+   * it is > p.
+   */
+  uint32_t completed = m_completed.load(std::memory_order_acquire);
+  if (is_past(completed, phase)) {
+    return;
+  }
+  if (futex::spin_wait(&m_completed, completed) &&
+      is_past(m_completed.load(std::memory_order_acquire), phase)) {
+    return;
+  }
+
+  m_n_sleeping.fetch_add(1, std::memory_order_seq_cst);
+  for (completed = m_completed.load(std::memory_order_seq_cst);
+       !is_past(completed, phase);
+       completed = m_completed.load(std::memory_order_seq_cst)) {
+    futex::wait(&m_completed, completed);
+  } /* for(completed..) */
+  m_n_sleeping.fetch_sub(1, std::memory_order_relaxed);
+} /* await_advance() */
+
+NS_END(multithread, rcppsw);
@@ -0,0 +1,103 @@
+/**
+ * @file task_graph.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/multithread/task_graph.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+task_graph::node_id task_graph::vertex_add(std::function<void(void)> fn) {
+  m_vertices.emplace_back(std::move(fn));
+  return m_vertices.size() - 1;
+} /* vertex_add() */
+
+void task_graph::precede(node_id before, node_id after) {
+  m_vertices[before].succ.push_back(after);
+  ++m_vertices[after].n_preds;
+} /* precede() */
+
+status_t task_graph::run(void) {
+  CHECK(!m_started);
+  CHECK(is_acyclic());
+  m_started = true;
+
+  for (auto& v : m_vertices) {
+    v.n_waiting.store(v.n_preds, std::memory_order_relaxed);
+  } /* for(v..) */
+  for (node_id i = 0; i < m_vertices.size(); ++i) {
+    if (0 == m_vertices[i].n_preds) {
+      m_group.run([this, i]() { vertex_run(i); });
+    }
+  } /* for(i..) */
+  return OK;
+
+error:
+  return ERROR;
+} /* run() */
+
+void task_graph::vertex_run(node_id id) {
+  vertex& v = m_vertices[id];
+  v.fn();
+
+  /*
+   * Successors are queued before this task counts as done in the group, so
+   * the group cannot look finished in between.
+   */
+  for (node_id s : v.succ) {
+    if (1 == m_vertices[s].n_waiting.fetch_sub(1, std::memory_order_acq_rel)) {
+      m_group.run([this, s]() { vertex_run(s); });
+    }
+  } /* for(s..) */
+} /* vertex_run() */
+
+bool task_graph::is_acyclic(void) const {
+  /* Kahn's algorithm: every vertex is reached iff there is no cycle */
+  std::vector<std::size_t> n_preds(m_vertices.size());
+  std::vector<node_id> ready;
+  for (node_id i = 0; i < m_vertices.size(); ++i) {
+    n_preds[i] = m_vertices[i].n_preds;
+    if (0 == n_preds[i]) {
+      ready.push_back(i);
+    }
+  } /* for(i..) */
+
+  std::size_t n_reached = 0;
+  while (!ready.empty()) {
+    node_id id = ready.back();
+    ready.pop_back();
+    ++n_reached;
+    for (node_id s : m_vertices[id].succ) {
+      if (0 == --n_preds[s]) {
+        ready.push_back(s);
+      }
+    } /* for(s..) */
+  } /* while() */
+  return n_reached == m_vertices.size();
+} /* is_acyclic() */
+
+NS_END(multithread, rcppsw);
@@ -0,0 +1,57 @@
+/**
+ * @file task_group.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/multithread/task_group.hpp"
+#include <algorithm>
+#include <thread>
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+void task_group::run(thread_pool::task_type fn) {
+  m_n_pending.fetch_add(1, std::memory_order_relaxed);
+  m_pool.task_submit(new thread_pool::task{std::move(fn), this});
+} /* run() */
+
+void task_group::wait(void) {
+  std::size_t backoff_us = 0;
+  while (n_pending() > 0) {
+    if (m_pool.help()) {
+      backoff_us = 0;
+    } else if (backoff_us < 1) {
+      std::this_thread::yield();
+      ++backoff_us;
+    } else {
+      /* nothing to help with: the remaining tasks are running elsewhere */
+      std::this_thread::sleep_for(std::chrono::microseconds(backoff_us));
+      backoff_us = std::min<std::size_t>(backoff_us * 2, 1000);
+    }
+  } /* while() */
+} /* wait() */
+
+NS_END(multithread, rcppsw);
@@ -0,0 +1,153 @@
+/**
+ * @file thread_group.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/multithread/thread_group.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <tuple>
+#include "rcppsw/multithread/threadable.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A single thread of the group.
+ */
+class thread_group::runner : public threadable {
+ public:
+  runner(const member* self, const body_type* body)
+      : mc_self(self), mc_body(body) {}
+
+  void* thread_main(void*) override {
+    /*
+     * Pin ourselves, rather than having start() do it after the thread is
+     * created, so nothing the body does ever runs on the wrong node.
+     */
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(mc_self->cpu(), &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    (*mc_body)(*mc_self);
+    return nullptr;
+  }
+
+ private:
+  const member* const    mc_self;
+  const body_type* const mc_body;
+};
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+thread_group::thread_group(std::size_t n_threads,
+                           placement::value policy,
+                           const cpu_topology& topo) {
+  std::vector<int> cpus = cpus_assign(topo, n_threads, policy);
+  m_members.reserve(cpus.size());
+  for (std::size_t i = 0; i < cpus.size(); ++i) {
+    m_members.emplace_back(i, cpus[i], topo.node_of(cpus[i]));
+  } /* for(i..) */
+}
+
+thread_group::~thread_group(void) { join(); }
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+std::vector<int> thread_group::cpus_assign(const cpu_topology& topo,
+                                           std::size_t n_threads,
+                                           placement::value policy) {
+  /*
+   * Within each node: first hardware thread of every core, then the second,
+   * etc., so cores are not shared until they have to be.
+   */
+  std::vector<std::vector<int>> per_node;
+  for (int node : topo.nodes()) {
+    std::vector<cpu_topology::cpu> cpus = topo.node_cpus(node);
+    std::sort(cpus.begin(),
+              cpus.end(),
+              [](const cpu_topology::cpu& a, const cpu_topology::cpu& b) {
+                return std::tie(a.smt, a.package, a.core, a.id) <
+                       std::tie(b.smt, b.package, b.core, b.id);
+              });
+    per_node.emplace_back();
+    for (auto& c : cpus) {
+      per_node.back().push_back(c.id);
+    } /* for(c..) */
+  } /* for(node..) */
+
+  std::vector<int> order;
+  if (placement::COMPACT == policy) {
+    for (auto& cpus : per_node) {
+      order.insert(order.end(), cpus.begin(), cpus.end());
+    } /* for(cpus..) */
+  } else {
+    for (std::size_t round = 0; order.size() < topo.cpus().size(); ++round) {
+      for (auto& cpus : per_node) {
+        if (round < cpus.size()) {
+          order.push_back(cpus[round]);
+        }
+      } /* for(cpus..) */
+    } /* for(round..) */
+  }
+
+  if (0 == n_threads) {
+    n_threads = order.size();
+  }
+  std::vector<int> ret(n_threads);
+  for (std::size_t i = 0; i < n_threads; ++i) {
+    ret[i] = order[i % order.size()];
+  } /* for(i..) */
+  return ret;
+} /* cpus_assign() */
+
+status_t thread_group::start(const body_type& body) {
+  CHECK(m_runners.empty());
+  m_body = body;
+  for (auto& m : m_members) {
+    m_runners.emplace_back(new runner(&m, &m_body));
+  } /* for(m..) */
+  for (auto& r : m_runners) {
+    CHECK(OK == r->start(nullptr));
+    ++m_n_started;
+  } /* for(r..) */
+  return OK;
+
+error:
+  return ERROR;
+} /* start() */
+
+void thread_group::join(void) {
+  for (std::size_t i = 0; i < m_n_started; ++i) {
+    m_runners[i]->join();
+  } /* for(i..) */
+  m_n_started = 0;
+} /* join() */
+
+NS_END(multithread, rcppsw);
@@ -0,0 +1,243 @@
+/**
+ * @file thread_pool.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#include "rcppsw/multithread/thread_pool.hpp"
+#include <boost/thread/lock_guard.hpp>
+#include <thread>
+#include "rcppsw/multithread/task_group.hpp"
+#include "rcppsw/multithread/threadable.hpp"
+#include "rcppsw/multithread/ws_deque.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+NS_START(rcppsw, multithread);
+
+/*******************************************************************************
+ * Class Definitions
+ ******************************************************************************/
+/**
+ * @brief A worker thread, and the deque of tasks it owns.
+ */
+class thread_pool::worker : public threadable {
+ public:
+  worker(thread_pool* pool, std::size_t index)
+      : mc_pool(pool),
+        mc_index(index),
+        m_rng(UINT64_C(0x9E3779B97F4A7C15) * (index + 1)) {}
+
+  void* thread_main(void*) override {
+    mc_pool->worker_main(this);
+    return nullptr;
+  }
+
+  thread_pool* pool(void) const { return mc_pool; }
+  std::size_t index(void) const { return mc_index; }
+  ws_deque<task*>& deque(void) { return m_deque; }
+
+  /**
+   * @brief Pick a random victim to start stealing from (xorshift64).
+   */
+  std::size_t victim(std::size_t n) {
+    m_rng ^= m_rng << 13;
+    m_rng ^= m_rng >> 7;
+    m_rng ^= m_rng << 17;
+    return static_cast<std::size_t>(m_rng % n);
+  }
+
+ private:
+  thread_pool* const mc_pool;
+  const std::size_t  mc_index;
+  uint64_t           m_rng;
+  ws_deque<task*>    m_deque{};
+};
+
+/*******************************************************************************
+ * Constructors/Destructors
+ ******************************************************************************/
+constexpr std::size_t thread_pool::kSPIN_ROUNDS;
+
+thread_pool::thread_pool(std::size_t n_threads, bool pin) {
+  std::size_t n_cores = std::max(1U, std::thread::hardware_concurrency());
+  if (0 == n_threads) {
+    n_threads = n_cores;
+  }
+  for (std::size_t i = 0; i < n_threads; ++i) {
+    m_workers.emplace_back(new worker(this, i));
+  } /* for(i..) */
+
+  /* all deques must exist before any worker goes looking for work to steal */
+  for (auto& w : m_workers) {
+    w->start(nullptr, pin ? static_cast<int>(w->index() % n_cores) : -1);
+  } /* for(w..) */
+}
+
+thread_pool::~thread_pool(void) {
+  wait_all();
+  m_stop.store(true, std::memory_order_seq_cst);
+  {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    m_wake_cv.notify_all();
+  }
+  for (auto& w : m_workers) {
+    w->join();
+  } /* for(w..) */
+}
+
+/*******************************************************************************
+ * Member Functions
+ ******************************************************************************/
+thread_pool& thread_pool::instance(void) {
+  static thread_pool pool;
+  return pool;
+} /* instance() */
+
+thread_pool::worker*& thread_pool::current(void) {
+  static thread_local worker* tls_worker = nullptr;
+  return tls_worker;
+} /* current() */
+
+bool thread_pool::in_pool(void) const {
+  return nullptr != current() && current()->pool() == this;
+} /* in_pool() */
+
+void thread_pool::task_submit(task* t) {
+  m_n_pending.fetch_add(1, std::memory_order_relaxed);
+  if (in_pool()) {
+    current()->deque().push(t);
+  } else {
+    boost::lock_guard<boost::mutex> lock(m_inject_mtx);
+    m_inject.push_back(t);
+    m_n_injected.fetch_add(1, std::memory_order_release);
+  }
+
+  /*
+   * Pairs with idle_wait(): either a worker going to sleep sees the new epoch
+   * and does not sleep, or we see it sleeping and wake it.
+   */
+  m_epoch.fetch_add(1, std::memory_order_seq_cst);
+  if (m_n_sleeping.load(std::memory_order_seq_cst) > 0) {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    m_wake_cv.notify_one();
+  }
+} /* task_submit() */
+
+thread_pool::task* thread_pool::task_find(worker* const self) {
+  task* t = nullptr;
+  if (nullptr != self && self->deque().pop(&t)) {
+    return t;
+  }
+
+  if (m_n_injected.load(std::memory_order_acquire) > 0) {
+    boost::lock_guard<boost::mutex> lock(m_inject_mtx);
+    if (!m_inject.empty()) {
+      t = m_inject.front();
+      m_inject.pop_front();
+      m_n_injected.fetch_sub(1, std::memory_order_relaxed);
+      return t;
+    }
+  }
+
+  std::size_t n = m_workers.size();
+  std::size_t start = (nullptr != self) ? self->victim(n) : 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    worker* victim = m_workers[(start + i) % n].get();
+    if (victim != self && victim->deque().steal(&t)) {
+      return t;
+    }
+  } /* for(i..) */
+  return nullptr;
+} /* task_find() */
+
+void thread_pool::task_run(task* const t) {
+  t->fn();
+  task_group* group = t->group;
+  delete t;
+  if (nullptr != group) {
+    group->task_done();
+  }
+  if (1 == m_n_pending.fetch_sub(1, std::memory_order_acq_rel)) {
+    boost::lock_guard<boost::mutex> lock(m_mtx);
+    m_idle_cv.notify_all();
+  }
+} /* task_run() */
+
+bool thread_pool::help(void) {
+  task* t = task_find(in_pool() ? current() : nullptr);
+  if (nullptr == t) {
+    return false;
+  }
+  task_run(t);
+  return true;
+} /* help() */
+
+void thread_pool::wait_all(void) {
+  if (in_pool()) {
+    /* can't block a worker: the tasks we are waiting on may be in its deque */
+    while (m_n_pending.load(std::memory_order_acquire) > 0) {
+      if (!help()) {
+        std::this_thread::yield();
+      }
+    } /* while() */
+    return;
+  }
+  boost::unique_lock<boost::mutex> lock(m_mtx);
+  while (m_n_pending.load(std::memory_order_acquire) > 0) {
+    m_idle_cv.wait(lock);
+  } /* while() */
+} /* wait_all() */
+
+void thread_pool::worker_main(worker* const self) {
+  current() = self;
+  std::size_t idle = 0;
+  for (;;) {
+    uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+    task* t = task_find(self);
+    if (nullptr != t) {
+      task_run(t);
+      idle = 0;
+    } else if (m_stop.load(std::memory_order_acquire)) {
+      break;
+    } else if (++idle < kSPIN_ROUNDS) {
+      std::this_thread::yield();
+    } else {
+      idle_wait(epoch);
+      idle = 0;
+    }
+  } /* for(;;) */
+  current() = nullptr;
+} /* worker_main() */
+
+void thread_pool::idle_wait(uint64_t epoch) {
+  m_n_sleeping.fetch_add(1, std::memory_order_seq_cst);
+  {
+    boost::unique_lock<boost::mutex> lock(m_mtx);
+    if (epoch == m_epoch.load(std::memory_order_seq_cst) &&
+        !m_stop.load(std::memory_order_acquire)) {
+      m_wake_cv.wait(lock);
+    }
+  }
+  m_n_sleeping.fetch_sub(1, std::memory_order_seq_cst);
+} /* idle_wait() */
+
+NS_END(multithread, rcppsw);
@@ -22,6 +22,7 @@
  * Includes
  ******************************************************************************/
 #include "rcppsw/multithread/threadable.hpp"
+#include <boost/thread/lock_guard.hpp>
 #include "rcsw/multithread/threadm.h"
 
 /*******************************************************************************
@@ -35,9 +36,17 @@ NS_START(rcppsw, multithread);
 status_t threadable::start(void* arg, int core) {
   /* start main thread */
   m_thread_run = true;
+  {
+    boost::lock_guard<boost::mutex> lock(m_exit_mtx);
+    m_exited = false;
+  }
 
   m_arg = arg;
   CHECK(0 == pthread_create(&m_thread, nullptr, &threadable::entry_point, this));
+  {
+    boost::lock_guard<boost::mutex> lock(m_exit_mtx);
+    m_started = true;
+  }
   if (-1 != core) {
     CHECK(OK == threadm_core_lock(m_thread, static_cast<size_t>(core)));
   }
@@ -47,4 +56,37 @@ error:
   return ERROR;
 } /* start() */
 
+void threadable::on_exit(std::function<void(void)> cb) {
+  {
+    boost::lock_guard<boost::mutex> lock(m_exit_mtx);
+    if (!m_exited) {
+      m_exit_cbs.push_back(std::move(cb));
+      return;
+    }
+  }
+  cb();
+} /* on_exit() */
+
+bool threadable::exited(void) const {
+  boost::lock_guard<boost::mutex> lock(m_exit_mtx);
+  return m_exited;
+} /* exited() */
+
+bool threadable::started(void) const {
+  boost::lock_guard<boost::mutex> lock(m_exit_mtx);
+  return m_started;
+} /* started() */
+
+void threadable::exited_notify(void) {
+  std::vector<std::function<void(void)>> cbs;
+  {
+    boost::lock_guard<boost::mutex> lock(m_exit_mtx);
+    m_exited = true;
+    cbs.swap(m_exit_cbs);
+  }
+  for (auto& cb : cbs) {
+    cb();
+  } /* for(cb..) */
+} /* exited_notify() */
+
 NS_END(multithread, rcppsw);
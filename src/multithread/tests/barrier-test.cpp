@@ -0,0 +1,125 @@
+/**
+ * @file barrier-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "rcppsw/multithread/barrier.hpp"
+#include "rcppsw/multithread/phaser.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Barrier lock-step", "[barrier]") {
+  const std::size_t kTHREADS = 4;
+  const int kPHASES = 2000;
+  mt::barrier barrier(kTHREADS);
+  std::atomic<int> counter{0};
+  std::atomic<int> n_serial{0};
+  std::atomic<int> n_bad{0};
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < kTHREADS; ++t) {
+    threads.emplace_back([&]() {
+      for (int p = 0; p < kPHASES; ++p) {
+        ++counter;
+        n_serial += barrier.wait() ? 1 : 0;
+        /* everyone has incremented for this phase, no one for the next */
+        n_bad += (counter.load() != (p + 1) * static_cast<int>(kTHREADS));
+        barrier.wait();
+      } /* for(p..) */
+    });
+  } /* for(t..) */
+  for (auto& t : threads) {
+    t.join();
+  } /* for(t..) */
+  CATCH_REQUIRE(0 == n_bad.load());
+  CATCH_REQUIRE(kPHASES == n_serial.load());
+}
+
+CATCH_TEST_CASE("Barrier sleeping waiters", "[barrier]") {
+  mt::barrier barrier(2);
+  std::thread slow([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    barrier.wait();
+  });
+  CATCH_REQUIRE_FALSE(barrier.wait());
+  slow.join();
+}
+
+CATCH_TEST_CASE("Phaser arrive/await", "[phaser]") {
+  mt::phaser phaser(1);
+  CATCH_REQUIRE(0 == phaser.register_party());
+  CATCH_REQUIRE(2 == phaser.n_parties());
+
+  CATCH_REQUIRE(0 == phaser.arrive());
+  CATCH_REQUIRE(0 == phaser.phase());
+  CATCH_REQUIRE(1 == phaser.n_unarrived());
+  std::thread other([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    phaser.arrive_and_deregister();
+  });
+  phaser.await_advance(0);
+  CATCH_REQUIRE(1 == phaser.phase());
+  other.join();
+  CATCH_REQUIRE(1 == phaser.n_parties());
+
+  /* sole party: each arrival completes a phase */
+  CATCH_REQUIRE(1 == phaser.arrive_and_await());
+  CATCH_REQUIRE(2 == phaser.phase());
+}
+
+CATCH_TEST_CASE("Phaser dynamic parties", "[phaser]") {
+  const int kPHASES = 500;
+  mt::phaser phaser(1);
+  std::atomic<int> n_done{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    phaser.register_party();
+    /* each thread leaves after a different # of phases */
+    threads.emplace_back([&, t]() {
+      for (int p = 0; p < kPHASES * (t + 1) / 4 - 1; ++p) {
+        phaser.arrive_and_await();
+      } /* for(p..) */
+      phaser.arrive_and_deregister();
+      ++n_done;
+    });
+  } /* for(t..) */
+  while (n_done.load() < 4) {
+    phaser.arrive_and_await();
+  } /* while() */
+  for (auto& t : threads) {
+    t.join();
+  } /* for(t..) */
+  CATCH_REQUIRE(1 == phaser.n_parties());
+  CATCH_REQUIRE(phaser.phase() >= static_cast<uint32_t>(kPHASES - 1));
+}
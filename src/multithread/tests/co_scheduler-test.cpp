@@ -0,0 +1,184 @@
+/**
+ * @file co_scheduler-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "rcppsw/multithread/co_scheduler.hpp"
+
+/*
+ * The scheduler requires C++20 coroutines; when built as an earlier standard
+ * this file has no test cases.
+ */
+#if defined(__cpp_impl_coroutine)
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Test Helpers
+ ******************************************************************************/
+class sleeper : public mt::threadable {
+ public:
+  void* thread_main(void*) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    done = true;
+    return nullptr;
+  }
+  std::atomic<bool> done{false};
+};
+
+static mt::co_task consumer(mt::co_scheduler& sched,
+                            mt::mt_queue<int>& queue,
+                            std::vector<int>* out,
+                            int n) {
+  for (int i = 0; i < n; ++i) {
+    out->push_back(co_await sched.dequeue(queue));
+  } /* for(i..) */
+}
+
+static mt::co_task napper(mt::co_scheduler& sched,
+                          std::vector<int>* order,
+                          int id,
+                          int ms) {
+  co_await sched.sleep_for(std::chrono::milliseconds(ms));
+  order->push_back(id);
+}
+
+static mt::co_task pinger(mt::co_scheduler& sched,
+                          std::vector<int>* order,
+                          int id) {
+  for (int i = 0; i < 3; ++i) {
+    order->push_back(id);
+    co_await sched.yield();
+  } /* for(i..) */
+}
+
+static mt::co_task joiner(mt::co_scheduler& sched, sleeper* thread, bool* ok) {
+  co_await sched.join(*thread);
+  *ok = thread->done.load();
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Timers fire in deadline order", "[co_scheduler]") {
+  mt::co_scheduler sched;
+  std::vector<int> order;
+  sched.spawn(napper(sched, &order, 3, 30));
+  sched.spawn(napper(sched, &order, 1, 10));
+  sched.spawn(napper(sched, &order, 2, 20));
+  auto start = std::chrono::steady_clock::now();
+  sched.run();
+  CATCH_REQUIRE(std::chrono::steady_clock::now() - start >=
+                std::chrono::milliseconds(30));
+  CATCH_REQUIRE(order == (std::vector<int>{1, 2, 3}));
+  CATCH_REQUIRE(0 == sched.n_live());
+}
+
+CATCH_TEST_CASE("Yield interleaves coroutines", "[co_scheduler]") {
+  mt::co_scheduler sched;
+  std::vector<int> order;
+  sched.spawn(pinger(sched, &order, 1));
+  sched.spawn(pinger(sched, &order, 2));
+  sched.run();
+  CATCH_REQUIRE(order == (std::vector<int>{1, 2, 1, 2, 1, 2}));
+}
+
+CATCH_TEST_CASE("Dequeue from another thread", "[co_scheduler]") {
+  mt::co_scheduler sched;
+  mt::mt_queue<int> queue;
+  std::vector<int> out;
+  queue.enqueue(0);
+  sched.spawn(consumer(sched, queue, &out, 1000));
+  std::thread producer([&]() {
+    for (int i = 1; i < 1000; ++i) {
+      queue.enqueue(i);
+    } /* for(i..) */
+  });
+  sched.run();
+  producer.join();
+  CATCH_REQUIRE(1000 == out.size());
+  for (int i = 0; i < 1000; ++i) {
+    CATCH_REQUIRE(i == out[i]);
+  } /* for(i..) */
+  CATCH_REQUIRE(queue.empty());
+}
+
+CATCH_TEST_CASE("Dequeue from a bounded queue", "[co_scheduler]") {
+  mt::co_scheduler sched;
+  mt::mt_queue<int> queue(1);
+  std::vector<int> out;
+  sched.spawn(consumer(sched, queue, &out, 1000));
+  std::thread producer([&]() {
+    for (int i = 0; i < 1000; ++i) {
+      queue.enqueue(i);
+    } /* for(i..) */
+  });
+  sched.run();
+  producer.join();
+  CATCH_REQUIRE(1000 == out.size());
+  for (int i = 0; i < 1000; ++i) {
+    CATCH_REQUIRE(i == out[i]);
+  } /* for(i..) */
+  CATCH_REQUIRE(queue.empty());
+}
+
+CATCH_TEST_CASE("Join a thread", "[co_scheduler]") {
+  mt::co_scheduler sched;
+  sleeper thread;
+  bool ok = false;
+  CATCH_REQUIRE(OK == thread.start(nullptr));
+  sched.spawn(joiner(sched, &thread, &ok));
+  sched.run();
+  CATCH_REQUIRE(ok);
+  CATCH_REQUIRE(thread.exited());
+
+  /* already exited: no suspension */
+  sleeper thread2;
+  ok = false;
+  CATCH_REQUIRE(OK == thread2.start(nullptr));
+  while (!thread2.exited()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  } /* while() */
+  sched.spawn(joiner(sched, &thread2, &ok));
+  sched.run();
+  CATCH_REQUIRE(ok);
+}
+
+CATCH_TEST_CASE("Unspawned and unfinished tasks are freed", "[co_scheduler]") {
+  mt::co_scheduler sched;
+  std::vector<int> order;
+  { mt::co_task t = napper(sched, &order, 1, 0); }
+  sched.spawn(napper(sched, &order, 1, 10000));
+  CATCH_REQUIRE(1 == sched.n_live());
+  CATCH_REQUIRE(order.empty());
+}
+
+#endif /* __cpp_impl_coroutine */
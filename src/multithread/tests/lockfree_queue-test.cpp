@@ -0,0 +1,109 @@
+/**
+ * @file lockfree_queue-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "rcppsw/multithread/mpmc_ring.hpp"
+#include "rcppsw/multithread/spsc_ring.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("SPSC order and capacity", "[lockfree_queue]") {
+  mt::spsc_ring<std::unique_ptr<int>> ring(3);
+  CATCH_REQUIRE(4 == ring.capacity());
+  for (int i = 0; i < 4; ++i) {
+    CATCH_REQUIRE(ring.try_enqueue(std::unique_ptr<int>(new int(i))));
+  } /* for(i..) */
+  std::unique_ptr<int> extra(new int(4));
+  CATCH_REQUIRE_FALSE(ring.try_enqueue(std::move(extra)));
+  CATCH_REQUIRE(nullptr != extra);
+
+  std::unique_ptr<int> out;
+  for (int i = 0; i < 4; ++i) {
+    CATCH_REQUIRE(ring.try_dequeue(&out));
+    CATCH_REQUIRE(i == *out);
+  } /* for(i..) */
+  CATCH_REQUIRE_FALSE(ring.try_dequeue(&out));
+}
+
+CATCH_TEST_CASE("SPSC threaded", "[lockfree_queue]") {
+  mt::spsc_ring<int> ring(16);
+  const int kN = 100000;
+  std::thread producer([&]() {
+    for (int i = 0; i < kN; ++i) {
+      while (!ring.try_enqueue(i)) {
+        std::this_thread::yield();
+      } /* while() */
+    } /* for(i..) */
+  });
+  int val = 0;
+  for (int i = 0; i < kN; ++i) {
+    while (!ring.try_dequeue(&val)) {
+      std::this_thread::yield();
+    } /* while() */
+    CATCH_REQUIRE(i == val);
+  } /* for(i..) */
+  producer.join();
+}
+
+CATCH_TEST_CASE("MPMC threaded", "[lockfree_queue]") {
+  mt::mpmc_ring<long> ring(64);
+  const long kN = 40000;
+  std::atomic<long> n_consumed{0};
+  std::atomic<long> sum{0};
+  std::vector<std::thread> threads;
+  for (long p = 0; p < 4; ++p) {
+    threads.emplace_back([&, p]() {
+      for (long i = p; i < kN; i += 4) {
+        while (!ring.try_enqueue(i)) {
+          std::this_thread::yield();
+        } /* while() */
+      } /* for(i..) */
+    });
+    threads.emplace_back([&]() {
+      long val = 0;
+      while (n_consumed.load() < kN) {
+        if (ring.try_dequeue(&val)) {
+          sum += val;
+          ++n_consumed;
+        }
+      } /* while() */
+    });
+  } /* for(p..) */
+  for (auto& t : threads) {
+    t.join();
+  } /* for(t..) */
+  CATCH_REQUIRE(kN * (kN - 1) / 2 == sum.load());
+  CATCH_REQUIRE(ring.empty());
+}
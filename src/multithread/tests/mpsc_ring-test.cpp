@@ -0,0 +1,99 @@
+/**
+ * @file mpsc_ring-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/multithread/mpsc_ring.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Drop newest", "[mpsc_ring]") {
+  mt::mpsc_ring<std::string> ring(4, mt::overflow_policy::DROP_NEWEST);
+  for (int i = 0; i < 6; ++i) {
+    ring.enqueue(std::to_string(i));
+  } /* for(i..) */
+  CATCH_REQUIRE(4 == ring.size());
+  CATCH_REQUIRE(2 == ring.n_dropped());
+
+  std::string s;
+  CATCH_REQUIRE(ring.try_dequeue(&s));
+  CATCH_REQUIRE("0" == s);
+}
+
+CATCH_TEST_CASE("Overwrite oldest", "[mpsc_ring]") {
+  mt::mpsc_ring<std::string> ring(4, mt::overflow_policy::OVERWRITE_OLDEST);
+  for (int i = 0; i < 6; ++i) {
+    ring.enqueue(std::to_string(i));
+  } /* for(i..) */
+  CATCH_REQUIRE(4 == ring.size());
+  CATCH_REQUIRE(2 == ring.n_dropped());
+
+  std::string s;
+  CATCH_REQUIRE(ring.try_dequeue(&s));
+  CATCH_REQUIRE("2" == s);
+}
+
+CATCH_TEST_CASE("Multiple producers", "[mpsc_ring]") {
+  const int kPRODUCERS = 4;
+  const int kPER_PRODUCER = 20000;
+  mt::mpsc_ring<int> ring(64, mt::overflow_policy::BLOCK);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kPRODUCERS; ++p) {
+    producers.emplace_back([&ring, p]() {
+      for (int i = 0; i < kPER_PRODUCER; ++i) {
+        ring.enqueue(p * kPER_PRODUCER + i);
+      } /* for(i..) */
+    });
+  } /* for(p..) */
+
+  /* each producer's elements must come out in the order they went in */
+  std::vector<int> last(kPRODUCERS, -1);
+  int n_received = 0;
+  bool in_order = true;
+  while (n_received < kPRODUCERS * kPER_PRODUCER) {
+    int v;
+    if (ring.wait_dequeue(&v, 10)) {
+      int p = v / kPER_PRODUCER;
+      in_order = in_order && (v % kPER_PRODUCER > last[p]);
+      last[p] = v % kPER_PRODUCER;
+      ++n_received;
+    }
+  } /* while() */
+  for (auto& t : producers) {
+    t.join();
+  } /* for(t..) */
+
+  CATCH_REQUIRE(in_order);
+  CATCH_REQUIRE(0 == ring.n_dropped());
+  CATCH_REQUIRE(ring.empty());
+}
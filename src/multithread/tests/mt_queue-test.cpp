@@ -0,0 +1,112 @@
+/**
+ * @file mt_queue-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "rcppsw/multithread/mt_queue.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Move-only elements", "[mt_queue]") {
+  mt::mt_queue<std::unique_ptr<int>> queue;
+  queue.enqueue(std::unique_ptr<int>(new int(4)));
+  CATCH_REQUIRE(4 == *queue.dequeue());
+
+  std::unique_ptr<int> out;
+  CATCH_REQUIRE_FALSE(queue.try_dequeue(&out));
+  CATCH_REQUIRE_FALSE(queue.wait_dequeue(&out, 1));
+}
+
+CATCH_TEST_CASE("Bounded capacity", "[mt_queue]") {
+  mt::mt_queue<int> queue(2);
+  CATCH_REQUIRE(queue.try_enqueue(1));
+  CATCH_REQUIRE(queue.try_enqueue(2));
+  CATCH_REQUIRE_FALSE(queue.try_enqueue(3));
+  CATCH_REQUIRE_FALSE(queue.wait_enqueue(3, 1));
+  CATCH_REQUIRE(2 == queue.size());
+  CATCH_REQUIRE(1 == queue.front());
+
+  std::thread consumer([&]() { queue.dequeue(); });
+  queue.enqueue(3);
+  consumer.join();
+  CATCH_REQUIRE(2 == queue.size());
+}
+
+CATCH_TEST_CASE("Async consumer of a full bounded queue", "[mt_queue]") {
+  for (int run = 0; run < 50; ++run) {
+    mt::mt_queue<int> queue(1);
+    queue.enqueue(1);
+    std::thread producer([&]() { queue.enqueue(2); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    /*
+     * Make room and register for the next element right away, so the blocked
+     * producer usually wakes up to find an async consumer waiting.
+     */
+    std::atomic<int> got{0};
+    queue.dequeue_async([&](int v) {
+      CATCH_REQUIRE(1 == v);
+      queue.dequeue_async([&](int w) { got = w; });
+    });
+    producer.join();
+    CATCH_REQUIRE(2 == got);
+    CATCH_REQUIRE(queue.empty());
+  } /* for(run..) */
+}
+
+CATCH_TEST_CASE("Bulk transfer", "[mt_queue]") {
+  mt::mt_queue<int> queue(64);
+  const int kN = 10000;
+  std::thread producer([&]() {
+    std::vector<int> batch(100);
+    for (int i = 0; i < kN; i += 100) {
+      for (int j = 0; j < 100; ++j) {
+        batch[j] = i + j;
+      } /* for(j..) */
+      queue.enqueue_bulk(batch.begin(), batch.end());
+    } /* for(i..) */
+  });
+
+  std::vector<int> got;
+  while (got.size() < kN) {
+    queue.wait_dequeue_bulk(std::back_inserter(got), 256, 10);
+  } /* while() */
+  producer.join();
+  for (int i = 0; i < kN; ++i) {
+    CATCH_REQUIRE(i == got[i]);
+  } /* for(i..) */
+  CATCH_REQUIRE(queue.empty());
+}
@@ -0,0 +1,117 @@
+/**
+ * @file mt_vector-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcppsw/multithread/mt_vector.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Stable references", "[mt_vector]") {
+  mt::mt_vector<std::string> v;
+  std::string& first = v.push_back("first");
+  for (int i = 0; i < 1000; ++i) {
+    v.emplace_back(3, 'a' + i % 26);
+  } /* for(i..) */
+  CATCH_REQUIRE(&first == &v[0]);
+  CATCH_REQUIRE("first" == first);
+  CATCH_REQUIRE(1001UL == v.size());
+  CATCH_REQUIRE("ccc" == v[3]);
+  CATCH_REQUIRE(1001 == std::distance(v.begin(), v.end()));
+
+  v.clear();
+  CATCH_REQUIRE(v.empty());
+  v.push_back("again");
+  CATCH_REQUIRE("again" == v[0]);
+}
+
+CATCH_TEST_CASE("Concurrent append and read", "[mt_vector]") {
+  mt::mt_vector<int> v;
+  const int kPER_THREAD = 20000;
+  std::atomic<bool> done{false};
+  std::atomic<int> n_bad{0};
+
+  std::thread reader([&]() {
+    while (!done.load()) {
+      /* every visible element must be fully constructed */
+      for (auto it = v.begin(); it != v.end(); ++it) {
+        n_bad += (*it < 0) ? 1 : 0;
+      } /* for(it..) */
+    } /* while() */
+  });
+  std::vector<std::thread> writers;
+  for (int t = 0; t < 4; ++t) {
+    writers.emplace_back([&, t]() {
+      for (int i = 0; i < kPER_THREAD; ++i) {
+        v.push_back(t * kPER_THREAD + i);
+      } /* for(i..) */
+    });
+  } /* for(t..) */
+  for (auto& t : writers) {
+    t.join();
+  } /* for(t..) */
+  done = true;
+  reader.join();
+  CATCH_REQUIRE(0 == n_bad.load());
+
+  CATCH_REQUIRE(4UL * kPER_THREAD == v.size());
+  std::vector<int> vals(v.begin(), v.end());
+  std::sort(vals.begin(), vals.end());
+  for (int i = 0; i < 4 * kPER_THREAD; ++i) {
+    CATCH_REQUIRE(i == vals[i]);
+  } /* for(i..) */
+}
+
+CATCH_TEST_CASE("Throwing constructor", "[mt_vector]") {
+  struct picky {
+    explicit picky(int v) : val(v) {
+      if (v < 0) {
+        throw std::invalid_argument("negative");
+      }
+    }
+    picky(picky&& other) noexcept : val(other.val) {}
+    int val;
+  };
+  mt::mt_vector<picky> v;
+  v.emplace_back(1);
+  CATCH_REQUIRE_THROWS_AS(v.emplace_back(-1), std::invalid_argument);
+  v.emplace_back(2);
+  CATCH_REQUIRE(2UL == v.size());
+  CATCH_REQUIRE(1 == v[0].val);
+  CATCH_REQUIRE(2 == v[1].val);
+  v.clear();
+  CATCH_REQUIRE(v.empty());
+}
@@ -0,0 +1,121 @@
+/**
+ * @file parallel-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <atomic>
+#include <vector>
+#include "rcppsw/multithread/parallel_for.hpp"
+#include "rcppsw/multithread/parallel_reduce.hpp"
+#include "rcppsw/multithread/parallel_scan.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Range splitting", "[parallel]") {
+  mt::range r(3, 1003, 64);
+  std::size_t covered = 0;
+  for (std::size_t k = 0; k < r.n_chunks(); ++k) {
+    CATCH_REQUIRE(r.chunk(k).begin() == 3 + covered);
+    covered += r.chunk(k).size();
+  } /* for(k..) */
+  CATCH_REQUIRE(1000 == covered);
+
+  mt::range p = mt::range(0, 10).piece(1, 3);
+  CATCH_REQUIRE(4 == p.begin());
+  CATCH_REQUIRE(7 == p.end());
+  CATCH_REQUIRE(mt::range(0, 10).piece(2, 3).end() == 10);
+}
+
+CATCH_TEST_CASE("Each index visited once", "[parallel]") {
+  mt::thread_pool pool(4);
+  std::vector<std::atomic<int>> hits(10007);
+  for (auto policy : {mt::chunking::STATIC, mt::chunking::DYNAMIC}) {
+    for (auto& h : hits) {
+      h = 0;
+    } /* for(h..) */
+    mt::parallel_for(mt::range(0, hits.size(), 17),
+                     [&](const mt::range& c) {
+                       for (std::size_t i = c.begin(); i < c.end(); ++i) {
+                         ++hits[i];
+                       } /* for(i..) */
+                     },
+                     policy,
+                     pool);
+    for (auto& h : hits) {
+      CATCH_REQUIRE(1 == h.load());
+    } /* for(h..) */
+  } /* for(policy..) */
+}
+
+CATCH_TEST_CASE("Reduction is independent of thread count", "[parallel]") {
+  std::vector<double> vals(100000);
+  for (std::size_t i = 0; i < vals.size(); ++i) {
+    vals[i] = 1.0 / static_cast<double>(i + 1);
+  } /* for(i..) */
+  auto body = [&](const mt::range& c, double init) {
+    for (std::size_t i = c.begin(); i < c.end(); ++i) {
+      init += vals[i];
+    } /* for(i..) */
+    return init;
+  };
+  auto plus = [](double a, double b) { return a + b; };
+
+  mt::thread_pool pool1(1);
+  double expected = mt::parallel_reduce(mt::range(0, vals.size()), 0.0, body,
+                                        plus, pool1);
+  for (std::size_t n : {2, 4}) {
+    mt::thread_pool pool(n);
+    double sum = mt::parallel_reduce(mt::range(0, vals.size()), 0.0, body,
+                                     plus, pool);
+    CATCH_REQUIRE(expected == sum);
+  } /* for(n..) */
+}
+
+CATCH_TEST_CASE("Inclusive scan", "[parallel]") {
+  mt::thread_pool pool(4);
+  std::vector<long> in(5003);
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    in[i] = static_cast<long>(i % 7) - 3;
+  } /* for(i..) */
+  std::vector<long> out(in.size());
+  mt::parallel_scan(mt::range(0, in.size(), 100), in.begin(), out.begin(),
+                    [](long a, long b) { return a + b; }, pool);
+
+  long acc = 0;
+  for (std::size_t i = 0; i < in.size(); ++i) {
+    acc += in[i];
+    CATCH_REQUIRE(acc == out[i]);
+  } /* for(i..) */
+
+  /* in place */
+  mt::parallel_scan(mt::range(0, in.size()), in.begin(), in.begin(),
+                    [](long a, long b) { return a + b; }, pool);
+  CATCH_REQUIRE(in == out);
+}
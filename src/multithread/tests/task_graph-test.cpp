@@ -0,0 +1,107 @@
+/**
+ * @file task_graph-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "rcppsw/multithread/task_graph.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Results and continuations", "[task_graph]") {
+  mt::thread_pool pool(4);
+  mt::task_graph graph(pool);
+  auto a = graph.add([]() { return 20; });
+  auto b = graph.add([]() { return 22; });
+  auto sum = graph.add([&]() { return a.result.get() + b.result.get(); });
+  graph.precede(a.id, sum.id);
+  graph.precede(b.id, sum.id);
+  auto str = graph.then(sum, [](int v) { return std::to_string(v); });
+  std::atomic<bool> last{false};
+  graph.then(str, [&](const std::string&) { last = true; });
+
+  CATCH_REQUIRE(OK == graph.run());
+  CATCH_REQUIRE("42" == str.result.get());
+  graph.wait();
+  CATCH_REQUIRE(last.load());
+  CATCH_REQUIRE(ERROR == graph.run());
+}
+
+CATCH_TEST_CASE("Dependencies respected", "[task_graph]") {
+  mt::thread_pool pool(4);
+  mt::task_graph graph(pool);
+  const std::size_t kN = 200;
+  std::vector<std::atomic<int>> finished(kN);
+  std::atomic<int> n_bad{0};
+  std::vector<mt::task_graph::node_id> ids;
+
+  /* i depends on i/2 and i/3: a wide, irregular DAG */
+  for (std::size_t i = 0; i < kN; ++i) {
+    ids.push_back(graph.add([&, i]() {
+      if (i > 0) {
+        n_bad += (0 == finished[i / 2].load() || 0 == finished[i / 3].load());
+      }
+      finished[i] = 1;
+    }).id);
+    if (i > 0) {
+      graph.precede(ids[i / 2], ids[i]);
+      if (i / 3 != i / 2) {
+        graph.precede(ids[i / 3], ids[i]);
+      }
+    }
+  } /* for(i..) */
+  CATCH_REQUIRE(OK == graph.run());
+  graph.wait();
+  CATCH_REQUIRE(0 == n_bad.load());
+  for (auto& f : finished) {
+    CATCH_REQUIRE(1 == f.load());
+  } /* for(f..) */
+}
+
+CATCH_TEST_CASE("Exceptions and cycles", "[task_graph]") {
+  mt::thread_pool pool(2);
+  {
+    mt::task_graph graph(pool);
+    auto bad = graph.add([]() -> int { throw std::runtime_error("oops"); });
+    auto next = graph.then(bad, [](int v) { return v + 1; });
+    CATCH_REQUIRE(OK == graph.run());
+    CATCH_REQUIRE_THROWS_AS(next.result.get(), std::runtime_error);
+  }
+  {
+    mt::task_graph graph(pool);
+    auto a = graph.add([]() {});
+    auto b = graph.then(a, []() {});
+    graph.precede(b.id, a.id);
+    CATCH_REQUIRE(ERROR == graph.run());
+  }
+}
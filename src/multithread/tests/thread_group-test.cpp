@@ -0,0 +1,127 @@
+/**
+ * @file thread_group-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "rcppsw/multithread/thread_group.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static void file_write(const std::string& path, const std::string& contents) {
+  for (std::size_t pos = path.find('/', 1); std::string::npos != pos;
+       pos = path.find('/', pos + 1)) {
+    mkdir(path.substr(0, pos).c_str(), 0755);
+  } /* for(pos..) */
+  std::ofstream(path) << contents << "\n";
+}
+
+/*
+ * A fake dual socket machine: 2 nodes x 2 cores x 2 hardware threads, with
+ * siblings numbered the way Linux usually does it (cpu N and N + 4).
+ */
+static std::string fake_sysfs_make(void) {
+  char tmpl[] = "/tmp/topo-XXXXXX";
+  std::string root = mkdtemp(tmpl);
+  file_write(root + "/cpu/online", "0-7");
+  for (int i = 0; i < 8; ++i) {
+    std::string dir = root + "/cpu/cpu" + std::to_string(i) + "/topology/";
+    file_write(dir + "core_id", std::to_string(i % 2));
+    file_write(dir + "physical_package_id", std::to_string((i / 2) % 2));
+  } /* for(i..) */
+  file_write(root + "/node/online", "0-1");
+  file_write(root + "/node/node0/cpulist", "0-1,4-5");
+  file_write(root + "/node/node1/cpulist", "2-3,6-7");
+  return root;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("CPU list parsing", "[thread_group]") {
+  CATCH_REQUIRE((std::vector<int>{0, 1, 2, 3, 8, 10, 11}) ==
+                mt::cpu_topology::list_parse("0-3,8,10-11\n"));
+  CATCH_REQUIRE(mt::cpu_topology::list_parse("garbage").empty());
+}
+
+CATCH_TEST_CASE("Topology discovery and placement", "[thread_group]") {
+  mt::cpu_topology topo(fake_sysfs_make());
+  CATCH_REQUIRE(topo.discovered());
+  CATCH_REQUIRE(8 == topo.cpus().size());
+  CATCH_REQUIRE(2 == topo.nodes().size());
+  CATCH_REQUIRE(2 == topo.n_packages());
+  CATCH_REQUIRE(1 == topo.node_of(6));
+  CATCH_REQUIRE(1 == topo.cpus()[5].smt);
+
+  /* physical cores on node 0 first, then their siblings, then node 1 */
+  CATCH_REQUIRE((std::vector<int>{0, 1, 4, 5, 2}) ==
+                mt::thread_group::cpus_assign(topo, 5, mt::placement::COMPACT));
+  /* alternate nodes, still physical cores first */
+  CATCH_REQUIRE((std::vector<int>{0, 2, 1, 3, 4}) ==
+                mt::thread_group::cpus_assign(topo, 5, mt::placement::SPREAD));
+  CATCH_REQUIRE(10 == mt::thread_group::cpus_assign(topo, 10,
+                                                    mt::placement::SPREAD)
+                          .size());
+}
+
+CATCH_TEST_CASE("Missing sysfs falls back", "[thread_group]") {
+  mt::cpu_topology topo("/nonexistent");
+  CATCH_REQUIRE_FALSE(topo.discovered());
+  CATCH_REQUIRE(1 == topo.nodes().size());
+  CATCH_REQUIRE(!topo.cpus().empty());
+}
+
+CATCH_TEST_CASE("Threads run pinned", "[thread_group]") {
+  mt::thread_group group(0, mt::placement::SPREAD);
+  std::vector<int> ran_on(group.size(), -1);
+  std::atomic<int> n_bad_alloc{0};
+  CATCH_REQUIRE(OK == group.start([&](const mt::thread_group::member& self) {
+    ran_on[self.rank()] = sched_getcpu();
+    void* buf = self.alloc(1 << 20);
+    if (nullptr == buf) {
+      ++n_bad_alloc;
+      return;
+    }
+    std::memset(buf, 1, 1 << 20);
+    self.free(buf, 1 << 20);
+  }));
+  group.join();
+  CATCH_REQUIRE(0 == n_bad_alloc.load());
+  for (std::size_t i = 0; i < group.size(); ++i) {
+    CATCH_REQUIRE(group.at(i).cpu() == ran_on[i]);
+  } /* for(i..) */
+}
@@ -0,0 +1,135 @@
+/**
+ * @file thread_pool-test.cpp
+ *
+ * @copyright 2017 John Harwell, All rights reserved.
+ *
+ * This file is part of RCPPSW.
+ *
+ * RCPPSW is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * RCPPSW is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * RCPPSW.  If not, see <http://www.gnu.org/licenses/
+ */
+
+/*******************************************************************************
+ * Includes
+ ******************************************************************************/
+#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_PREFIX_ALL
+#include <catch.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "rcppsw/multithread/task_group.hpp"
+#include "rcppsw/multithread/thread_pool.hpp"
+#include "rcppsw/multithread/ws_deque.hpp"
+
+/*******************************************************************************
+ * Namespaces
+ ******************************************************************************/
+namespace mt = rcppsw::multithread;
+
+/*******************************************************************************
+ * Helper Functions
+ ******************************************************************************/
+static long fib(mt::thread_pool& pool, int n) {
+  if (n < 12) {
+    return (n < 2) ? n : fib(pool, n - 1) + fib(pool, n - 2);
+  }
+  long a = 0;
+  long b = 0;
+  mt::task_group group(pool);
+  group.run([&]() { a = fib(pool, n - 1); });
+  group.run([&]() { b = fib(pool, n - 2); });
+  group.wait();
+  return a + b;
+}
+
+/*******************************************************************************
+ * Test Cases
+ ******************************************************************************/
+CATCH_TEST_CASE("Deque owner/thief order", "[thread_pool]") {
+  mt::ws_deque<int*> deque(2);
+  int vals[8];
+  for (int i = 0; i < 8; ++i) {
+    deque.push(&vals[i]);
+  } /* for(i..) */
+  CATCH_REQUIRE(8 == deque.size());
+
+  int* p = nullptr;
+  CATCH_REQUIRE(deque.steal(&p));
+  CATCH_REQUIRE(&vals[0] == p);
+  CATCH_REQUIRE(deque.pop(&p));
+  CATCH_REQUIRE(&vals[7] == p);
+}
+
+CATCH_TEST_CASE("Deque concurrent steal", "[thread_pool]") {
+  const int kN = 100000;
+  mt::ws_deque<intptr_t> deque;
+  std::atomic<bool> done{false};
+  std::vector<std::atomic<int>> seen(kN + 1);
+  for (auto& s : seen) {
+    s = 0;
+  } /* for(s..) */
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < 3; ++i) {
+    thieves.emplace_back([&]() {
+      intptr_t v;
+      while (!done || !deque.empty()) {
+        if (deque.steal(&v)) {
+          ++seen[v];
+        }
+      } /* while() */
+    });
+  } /* for(i..) */
+  intptr_t v;
+  for (int i = 1; i <= kN; ++i) {
+    deque.push(i);
+    if (0 == i % 3 && deque.pop(&v)) {
+      ++seen[v];
+    }
+  } /* for(i..) */
+  while (deque.pop(&v)) {
+    ++seen[v];
+  } /* while() */
+  done = true;
+  for (auto& t : thieves) {
+    t.join();
+  } /* for(t..) */
+
+  /* every element taken exactly once */
+  for (int i = 1; i <= kN; ++i) {
+    CATCH_REQUIRE(1 == seen[i]);
+  } /* for(i..) */
+}
+
+CATCH_TEST_CASE("Submit and wait", "[thread_pool]") {
+  mt::thread_pool pool(4);
+  std::atomic<int> count{0};
+  for (int i = 0; i < 10000; ++i) {
+    pool.submit([&count]() { ++count; });
+  } /* for(i..) */
+  pool.wait_all();
+  CATCH_REQUIRE(10000 == count);
+  CATCH_REQUIRE(0 == pool.n_pending());
+}
+
+CATCH_TEST_CASE("Nested task groups", "[thread_pool]") {
+  mt::thread_pool pool(4);
+  CATCH_REQUIRE(6765 == fib(pool, 20));
+
+  /* a single worker must not deadlock waiting on its own subtasks */
+  mt::thread_pool single(1);
+  long ret = 0;
+  single.submit([&]() { ret = fib(single, 18); });
+  single.wait_all();
+  CATCH_REQUIRE(2584 == ret);
+}